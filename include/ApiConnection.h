@@ -0,0 +1,112 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+#include "HttpFetch.h"
+
+//Librairies
+#include <WiFiClientSecureBearSSL.h>
+
+/** The single connection to the STIB API, shared by the token and the passing time requests.
+ *  - the HTTP/1.1 connection is kept alive between requests, no handshake is done while it stays open
+ *  - when the server closes it, the TLS session is resumed from the session cache (abbreviated handshake)
+ *  - the BearSSL buffers can be reduced with TLS_RX_BUFFER_SIZE / TLS_TX_BUFFER_SIZE
+ *  A plain TCP client is used instead when API_SCHEME is http (local replay server).
+ *  Requests are serialized: a new one can only be started when the previous one is complete.
+ */
+class ApiConnection {
+  BearSSL::WiFiClientSecure secureClient;
+  BearSSL::Session session;
+  WiFiClient plainClient;
+  WiFiClient* client = &secureClient;
+  HttpFetch fetch;
+  /** RX buffer of the TLS connections, 16KB unless the server accepts a smaller one */
+  int rxBufferSize = 0;
+
+  public:
+    /** To be called once WiFi is connected. probedRxBufferSize is the RX buffer found by a former probe, e.g. before a reset,
+     *  0 when unknown: the server is then probed by the first request.
+     */
+    void begin(int probedRxBufferSize = 0){
+      fetch.setKeepAlive(true);
+      if(strcmp(API_SCHEME, "https") != 0){
+        client = &plainClient;
+        return;
+      }
+      //secureClient.setFingerprint(FINGERPRINT);
+      secureClient.setInsecure();
+      secureClient.setSession(&session);
+      if(rxBufferSize == 0 && (probedRxBufferSize == TLS_RX_BUFFER_SIZE || probedRxBufferSize == 16384)){
+        setRxBufferSize(probedRxBufferSize);
+      }
+    }
+
+    /** Start a request on the connection, see HttpFetch::start */
+    bool start(const char* method, const char* url, const char* headers, const char* body, HttpFetchListener* listener){
+      if(client == &secureClient && rxBufferSize == 0){
+        // Blocking like the handshake that follows, done once
+        configureBufferSizes();
+      }
+      return fetch.start(client, method, url, headers, body, listener);
+    }
+
+    bool isBusy(){
+      return fetch.isBusy();
+    }
+
+    /** Advance the running request. To be called on every loop() pass. */
+    void poll(){
+      fetch.poll();
+    }
+
+    /** Close the kept connection, e.g. before turning the radio off */
+    void close(){
+      fetch.close();
+    }
+
+    const HttpFetchStats& getStats(){
+      return fetch.getStats();
+    }
+
+    /** 0 until the buffers are configured by begin() or the first request */
+    int getRxBufferSize(){
+      return rxBufferSize;
+    }
+
+    void printStats(){
+      const HttpFetchStats& stats = fetch.getStats();
+      Serial.print(F("[HTTPS] requests:"));
+      Serial.print(stats.requests);
+      Serial.print(F(" handshakes:"));
+      Serial.print(stats.connections);
+      Serial.print(F(" reused:"));
+      Serial.print(stats.reusedConnections);
+      Serial.print(F(" last request ms:"));
+      Serial.print(stats.lastRequestMs);
+      Serial.print(F(" avg ms:"));
+      Serial.print(stats.requests > 0 ? stats.totalRequestMs / stats.requests : 0);
+      Serial.print(F(" last handshake ms:"));
+      Serial.print(stats.lastConnectMs);
+      Serial.print(F(" TLS heap:"));
+      Serial.print(stats.lastConnectHeapBytes);
+      Serial.print(F(" RX buffer:"));
+      Serial.println(rxBufferSize);
+    }
+
+  private:
+    /** Smaller buffers than the 16KB of a TLS record are only possible when the server
+     *  accepts the max fragment length negotiation. The TX buffer only holds our requests.
+     */
+    void configureBufferSizes(){
+      int rxSize = TLS_RX_BUFFER_SIZE;
+      if(rxSize < 16384 && !BearSSL::WiFiClientSecure::probeMaxFragmentLength(API_HOST_NAME, API_PORT, rxSize)){
+        Serial.println(F("[HTTPS] Max fragment length not supported, keep 16KB RX buffer"));
+        rxSize = 16384;
+      }
+      setRxBufferSize(rxSize);
+    }
+
+    void setRxBufferSize(int rxSize){
+      secureClient.setBufferSizes(rxSize, TLS_TX_BUFFER_SIZE);
+      rxBufferSize = rxSize;
+    }
+};
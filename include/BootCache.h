@@ -0,0 +1,128 @@
+#pragma once
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <sys/time.h>
+#include "Crc32.h"
+
+extern "C" {
+#include "user_interface.h"
+}
+
+/** Kept in the RTC memory, which survives the resets but not a power cycle */
+struct BootCacheData {
+  uint32_t crc;
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint8_t hasTime;
+  /** Wall clock when the RTC counter read rtcTime, rtcPeriod is the length of an RTC tick in us << 12 */
+  uint32_t epoch;
+  uint32_t rtcTime;
+  uint32_t rtcPeriod;
+  /** RX buffer of the TLS connections found by the probe of the server, 0 when not probed yet */
+  uint32_t tlsRxBufferSize;
+};
+
+/** Last good WiFi connection and time of the device, to restart quickly:
+ *  - WiFi is joined on the cached channel and BSSID with the cached IP lease, without scan nor DHCP
+ *  - the clock is restored from the cached time and the RTC counter, which keeps running during the reset
+ *  - the max fragment length of the API server isn't probed again
+ */
+class BootCache {
+  BootCacheData data;
+  bool valid = false;
+
+  public:
+    /** Read the cache, at the beginning of setup() */
+    void begin(){
+      valid = ESP.rtcUserMemoryRead(0, (uint32_t*)&data, sizeof(data)) && data.crc == computeCrc();
+      if(!valid){
+        memset(&data, 0, sizeof(data));
+      }
+    }
+
+    bool hasNetwork(){
+      return valid && data.channel != 0;
+    }
+
+    /** Join the cached access point with the cached IP configuration */
+    void fastConnect(const char* ssid, const char* password){
+      WiFi.config(IPAddress(data.ip), IPAddress(data.gateway), IPAddress(data.subnet), IPAddress(data.dns));
+      WiFi.begin(ssid, password, data.channel, data.bssid);
+    }
+
+    /** Store the current connection, the RTC memory is only written when it changed */
+    void saveNetwork(){
+      BootCacheData previous = data;
+      data.ip = WiFi.localIP();
+      data.gateway = WiFi.gatewayIP();
+      data.subnet = WiFi.subnetMask();
+      data.dns = WiFi.dnsIP();
+      memcpy(data.bssid, WiFi.BSSID(), sizeof(data.bssid));
+      data.channel = WiFi.channel();
+      if(!valid || memcmp(&previous, &data, sizeof(data)) != 0){
+        write();
+      }
+    }
+
+    /** Forget the connection when the fast connect failed, the IP is obtained by DHCP again */
+    void clearNetwork(){
+      WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+      data.channel = 0;
+      write();
+    }
+
+    /** Set the clock from the cached time. False when the RTC counter has been reset since, by a power cycle or the RST pin. */
+    bool restoreTime(){
+      if(!valid || !data.hasTime){
+        return false;
+      }
+      uint32_t reason = system_get_rst_info()->reason;
+      uint32_t rtcNow = system_get_rtc_time();
+      if(reason == REASON_DEFAULT_RST || reason == REASON_EXT_SYS_RST || rtcNow < data.rtcTime){
+        return false;
+      }
+      uint64_t elapsedUs = ((uint64_t)(rtcNow - data.rtcTime) * data.rtcPeriod) >> 12;
+      struct timeval now;
+      now.tv_sec = data.epoch + elapsedUs / 1000000;
+      now.tv_usec = elapsedUs % 1000000;
+      settimeofday(&now, NULL);
+      return true;
+    }
+
+    /** Anchor the current time on the RTC counter, after each NTP synchronisation */
+    void saveTime(){
+      data.epoch = time(nullptr);
+      data.rtcTime = system_get_rtc_time();
+      data.rtcPeriod = system_rtc_clock_cali_proc();
+      data.hasTime = 1;
+      write();
+    }
+
+    int getTlsRxBufferSize(){
+      return valid ? data.tlsRxBufferSize : 0;
+    }
+
+    /** Store the RX buffer found by the probe, the RTC memory is only written when it changed */
+    void saveTlsRxBufferSize(int size){
+      if(valid && data.tlsRxBufferSize == (uint32_t)size){
+        return;
+      }
+      data.tlsRxBufferSize = size;
+      write();
+    }
+
+  private:
+    void write(){
+      data.crc = computeCrc();
+      valid = ESP.rtcUserMemoryWrite(0, (uint32_t*)&data, sizeof(data));
+    }
+
+    /** CRC-32 of the data after the crc field */
+    uint32_t computeCrc(){
+      return ~updateCrc32(CRC32_INIT, (const uint8_t*)&data + sizeof(data.crc), sizeof(data) - sizeof(data.crc));
+    }
+};
@@ -0,0 +1,239 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+#define MAX_BUTTONS 4
+/** Capacity of the edge queue, a power of 2 */
+#define BUTTON_QUEUE_SIZE 16
+
+enum ButtonEventType {
+  /** Up/down: when pushed. Select: when released before the long press delay */
+  BUTTON_PRESSED,
+  /** Up/down held: first after BUTTON_LONG_PRESS_MS, then every BUTTON_REPEAT_MS */
+  BUTTON_REPEATED,
+  /** Select held for BUTTON_LONG_PRESS_MS */
+  BUTTON_LONG_PRESSED
+};
+
+struct ButtonEvent {
+  uint8_t button;
+  ButtonEventType type;
+  /** millis() of the edge or of the repeat which produced the event */
+  unsigned long at;
+};
+
+struct ButtonEdge {
+  uint8_t button;
+  bool pressed;
+  unsigned long at;
+};
+
+/** Lock-free queue between a single producer (the pin interrupts) and a single consumer (loop()).
+ *  Each index is only written by one side, the ESP8266 has a single core.
+ */
+class ButtonEdgeQueue {
+  ButtonEdge edges[BUTTON_QUEUE_SIZE];
+  volatile uint8_t head = 0;
+  volatile uint8_t tail = 0;
+  volatile unsigned long dropped = 0;
+
+  public:
+    bool IRAM_ATTR push(const ButtonEdge& edge){
+      uint8_t next = (head + 1) & (BUTTON_QUEUE_SIZE - 1);
+      if(next == tail){
+        dropped++;
+        return false;
+      }
+      edges[head] = edge;
+      // The edge must be written before it is published
+      asm volatile("" ::: "memory");
+      head = next;
+      return true;
+    }
+
+    bool pop(ButtonEdge* edge){
+      if(tail == head){
+        return false;
+      }
+      *edge = edges[tail];
+      asm volatile("" ::: "memory");
+      tail = (tail + 1) & (BUTTON_QUEUE_SIZE - 1);
+      return true;
+    }
+
+    unsigned long getDropped(){
+      return dropped;
+    }
+};
+
+/** Push buttons read by interrupts.
+ *  The interrupt of a pin debounces its edges (BUTTON_DEBOUNCE_MS) and queues them, loop() turns them into
+ *  press, long press and repeat events. Nothing blocks, whatever the time the buttons are held.
+ *  The buttons are active high.
+ */
+class ButtonInput {
+  struct Button {
+    ButtonInput* input;
+    uint8_t index;
+    uint8_t pin;
+    /** Up/down repeat while held, select distinguishes a click from a long press */
+    bool repeatable;
+    // Owned by the interrupt
+    volatile bool edgePressed;
+    volatile unsigned long lastEdgeAt;
+    // Owned by loop()
+    bool pressed;
+    bool longPressed;
+    /** Held while the events were cleared, ignored until released */
+    bool ignored;
+    unsigned long pressedAt;
+    unsigned long nextRepeatAt;
+  };
+
+  Button buttons[MAX_BUTTONS];
+  uint8_t numberOfButtons = 0;
+  ButtonEdgeQueue queue;
+  unsigned long events = 0;
+
+  public:
+    /** Register a button, return its index in the events */
+    uint8_t add(uint8_t pin, bool repeatable){
+      Button& button = buttons[numberOfButtons];
+      button.input = this;
+      button.index = numberOfButtons;
+      button.pin = pin;
+      button.repeatable = repeatable;
+      button.edgePressed = false;
+      button.lastEdgeAt = 0;
+      button.pressed = false;
+      button.longPressed = false;
+      button.ignored = false;
+      return numberOfButtons++;
+    }
+
+    void begin(){
+      for(uint8_t i = 0; i < numberOfButtons; i++){
+        pinMode(buttons[i].pin, INPUT);
+      }
+      attach();
+      clear();
+    }
+
+    /** Edge detection on the pins. Again after a light sleep, which leaves them with the wake up interrupt */
+    void attach(){
+      for(uint8_t i = 0; i < numberOfButtons; i++){
+        attachInterruptArg(digitalPinToInterrupt(buttons[i].pin), onEdge, &buttons[i], CHANGE);
+      }
+    }
+
+    /** Take the next event. Return false when there is none. To be called on every loop() pass. */
+    bool next(ButtonEvent* event){
+      ButtonEdge edge;
+      while(queue.pop(&edge)){
+        if(handleEdge(edge, event)){
+          return true;
+        }
+      }
+      resynchronize();
+      unsigned long now = millis();
+      for(uint8_t i = 0; i < numberOfButtons; i++){
+        Button& button = buttons[i];
+        if(!button.pressed || button.ignored){
+          continue;
+        }
+        if(!button.longPressed && now - button.pressedAt >= BUTTON_LONG_PRESS_MS){
+          button.longPressed = true;
+          button.nextRepeatAt = now + BUTTON_REPEAT_MS;
+          return emit(event, i, button.repeatable ? BUTTON_REPEATED : BUTTON_LONG_PRESSED, now);
+        }
+        if(button.longPressed && button.repeatable && (long)(now - button.nextRepeatAt) >= 0){
+          button.nextRepeatAt += BUTTON_REPEAT_MS;
+          return emit(event, i, BUTTON_REPEATED, now);
+        }
+      }
+      return false;
+    }
+
+    /** Forget the queued edges. The buttons held now produce no event until they are released. */
+    void clear(){
+      ButtonEdge edge;
+      while(queue.pop(&edge)){
+      }
+      for(uint8_t i = 0; i < numberOfButtons; i++){
+        Button& button = buttons[i];
+        noInterrupts();
+        button.edgePressed = digitalRead(button.pin) == HIGH;
+        interrupts();
+        button.pressed = button.edgePressed;
+        button.ignored = button.pressed;
+        button.longPressed = false;
+      }
+    }
+
+    bool isAnyPressed(){
+      for(uint8_t i = 0; i < numberOfButtons; i++){
+        if(buttons[i].pressed){
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /** Edges lost because the queue was full */
+    unsigned long getDroppedEdges(){
+      return queue.getDropped();
+    }
+
+    unsigned long getEvents(){
+      return events;
+    }
+
+  private:
+    static void IRAM_ATTR onEdge(void* arg){
+      Button* button = (Button*)arg;
+      bool pressed = digitalRead(button->pin) == HIGH;
+      unsigned long now = millis();
+      if(pressed == button->edgePressed || now - button->lastEdgeAt < BUTTON_DEBOUNCE_MS){
+        return;
+      }
+      button->edgePressed = pressed;
+      button->lastEdgeAt = now;
+      button->input->queue.push({button->index, pressed, now});
+    }
+
+    /** A change ignored as a bounce may have been the last one: take the level of the pin once it is stable */
+    void resynchronize(){
+      unsigned long now = millis();
+      for(uint8_t i = 0; i < numberOfButtons; i++){
+        Button& button = buttons[i];
+        if(now - button.lastEdgeAt >= BUTTON_DEBOUNCE_MS && (digitalRead(button.pin) == HIGH) != button.edgePressed){
+          noInterrupts();
+          onEdge(&button);
+          interrupts();
+        }
+      }
+    }
+
+    bool handleEdge(const ButtonEdge& edge, ButtonEvent* event){
+      Button& button = buttons[edge.button];
+      if(edge.pressed){
+        button.pressed = true;
+        button.longPressed = false;
+        button.ignored = false;
+        button.pressedAt = edge.at;
+        return button.repeatable && emit(event, edge.button, BUTTON_PRESSED, edge.at);
+      }
+      bool click = button.pressed && !button.repeatable && !button.longPressed && !button.ignored;
+      button.pressed = false;
+      button.ignored = false;
+      return click && emit(event, edge.button, BUTTON_PRESSED, edge.at);
+    }
+
+    bool emit(ButtonEvent* event, uint8_t button, ButtonEventType type, unsigned long at){
+      event->button = button;
+      event->type = type;
+      event->at = at;
+      events++;
+      return true;
+    }
+};
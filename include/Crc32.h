@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#define CRC32_INIT 0xFFFFFFFF
+
+/** Bitwise CRC-32 (IEEE), small and without table. Start with CRC32_INIT, chain the calls, invert the result. */
+uint32_t updateCrc32(uint32_t crc, const void* data, size_t length){
+  const uint8_t* bytes = (const uint8_t*)data;
+  for(size_t i = 0; i < length; i++){
+    crc ^= bytes[i];
+    for(uint8_t bit = 0; bit < 8; bit++){
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return crc;
+}
@@ -1,17 +1,17 @@
 #pragma once
+#include "Pgmspace.h"
 
+/** A stop of the favourites menu. Nothing is allocated: the stop id is a literal in RAM, given as is to the API,
+ *  the label is a PROGMEM string read with the _P functions.
+ */
 class Favourite{
   public:
-    String stopId;
-    String label;
+    const char* stopId;
+    PGM_P label;
 
-    Favourite(String stopId, String label) : 
+    constexpr Favourite(const char* stopId, PGM_P label) :
       stopId(stopId),
       label(label) {
-        
-      }  
 
-    String getDisplay(){
-      return label;
-    }
+      }
 };
@@ -0,0 +1,471 @@
+#pragma once
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include "Metrics.h"
+
+#define HTTP_FETCH_HOST_LENGTH 64
+#define HTTP_FETCH_REQUEST_LENGTH 512
+/** Longer status/header lines are truncated, only the first characters are needed */
+#define HTTP_FETCH_LINE_LENGTH 96
+/** Max number of bytes read from the socket in one call to poll() */
+#define HTTP_FETCH_SLICE_BYTES 256
+/** Max time (in ms) without any progress before the request is aborted */
+#define HTTP_FETCH_TIMEOUT_MS 10000
+/** With -D RECORD_HTTP=1 every exchange is written on Serial, to be served back by tools/replay_server.py:
+ *  @rec begin <method> <path>
+ *  @rec data <raw response bytes in hex>
+ *  @rec end <http code>
+ */
+#ifndef RECORD_HTTP
+#define RECORD_HTTP 0
+#endif
+
+/** Counters of the connections and requests made by a HttpFetch */
+struct HttpFetchStats {
+  unsigned long requests = 0;
+  /** New connections, each one costing a (possibly resumed) TLS handshake on a secure client */
+  unsigned long connections = 0;
+  /** Requests sent on a connection kept alive from the previous one */
+  unsigned long reusedConnections = 0;
+  unsigned long lastConnectMs = 0;
+  /** Heap taken by the last connection (TLS buffers and state) */
+  long lastConnectHeapBytes = 0;
+  unsigned long lastRequestMs = 0;
+  unsigned long totalRequestMs = 0;
+};
+
+/** Receive the result of a HttpFetch */
+class HttpFetchListener {
+  public:
+    virtual ~HttpFetchListener() {}
+    /** Receive a part of the body of a 200 response. Return false to abort the request. */
+    virtual bool onBody(const uint8_t* data, size_t length) = 0;
+    /** Called once when the request ends. httpCode is 0 when no complete response was received. */
+    virtual void onComplete(int httpCode) = 0;
+};
+
+/** Non blocking HTTP/1.1 client.
+ *  The request runs as a state machine: connect, send, read status, read headers, stream the body.
+ *  Each call to poll() advances it by a bounded slice of work so loop() keeps running during the transfer.
+ *  Only the connection is done in one step: BearSSL performs the whole TLS handshake inside connect().
+ *  With keep-alive, the connection stays open after a complete response and the next request to the same
+ *  host is sent on it. A kept connection closed by the server is detected and reopened once.
+ */
+class HttpFetch {
+  public:
+    enum State {
+      IDLE,
+      CONNECTING,
+      SENDING,
+      READING_STATUS,
+      READING_HEADERS,
+      READING_BODY
+    };
+
+  private:
+    enum ChunkState {
+      CHUNK_SIZE,
+      CHUNK_DATA,
+      CHUNK_DATA_END,
+      CHUNK_TRAILER
+    };
+
+    WiFiClient* client = NULL;
+    HttpFetchListener* listener = NULL;
+    State state = IDLE;
+    char host[HTTP_FETCH_HOST_LENGTH];
+    uint16_t port = 0;
+    char request[HTTP_FETCH_REQUEST_LENGTH];
+    size_t requestLength = 0;
+    size_t requestSent = 0;
+    char line[HTTP_FETCH_LINE_LENGTH];
+    size_t lineLength = 0;
+    int httpCode = 0;
+    bool chunked = false;
+    long contentLength = -1;
+    /** Bytes left in the body (Content-Length) or in the current chunk */
+    long remaining = 0;
+    ChunkState chunkState = CHUNK_SIZE;
+    unsigned long lastActivity = 0;
+    unsigned long startedAt = 0;
+    bool keepAlive = false;
+    /** Host of the open connection, empty when there is none */
+    char connectedHost[HTTP_FETCH_HOST_LENGTH] = "";
+    uint16_t connectedPort = 0;
+    /** The request is sent on a connection kept from the previous one */
+    bool reused = false;
+    /** The server allows the connection to be kept after the current response */
+    bool reusable = false;
+    HttpFetchStats stats;
+
+  public:
+    /** Keep the connection open between requests (HTTP/1.1 persistent connection) */
+    void setKeepAlive(bool keepAlive){
+      this->keepAlive = keepAlive;
+    }
+    /** Prepare a request, the work is done by poll().
+     *  - url: http[s]://host[:port]/path
+     *  - headers: extra header lines, each one ending with \r\n. Can be NULL.
+     *  - body: sent with a Content-Length header when not NULL
+     *  Return false when a request is already running or when it doesn't fit in the buffer.
+     */
+    bool start(WiFiClient* client, const char* method, const char* url, const char* headers, const char* body, HttpFetchListener* listener){
+      if(state != IDLE){
+        return false;
+      }
+      const char* path = parseUrl(url);
+      if(path == NULL){
+        return false;
+      }
+      const char* connection = keepAlive ? "keep-alive" : "close";
+      int length;
+      if(body != NULL){
+        length = snprintf(request, sizeof(request), "%s %s HTTP/1.1\r\nHost: %s\r\nConnection: %s\r\n%sContent-Length: %u\r\n\r\n%s",
+          method, path, host, connection, headers != NULL ? headers : "", (unsigned int)strlen(body), body);
+      }else{
+        length = snprintf(request, sizeof(request), "%s %s HTTP/1.1\r\nHost: %s\r\nConnection: %s\r\n%s\r\n",
+          method, path, host, connection, headers != NULL ? headers : "");
+      }
+      if(length < 0 || length >= (int)sizeof(request)){
+        Serial.println(F("[HTTP] Request too long"));
+        return false;
+      }
+      if(this->client != client){
+        close();
+      }
+      this->client = client;
+      this->listener = listener;
+      requestLength = length;
+      requestSent = 0;
+      httpCode = 0;
+      lineLength = 0;
+      lastActivity = millis();
+      startedAt = lastActivity;
+      stats.requests++;
+#if RECORD_HTTP
+      Serial.print(F("@rec begin "));
+      Serial.print(method);
+      Serial.print(' ');
+      Serial.println(path);
+#endif
+      state = CONNECTING;
+      return true;
+    }
+
+    bool isBusy(){
+      return state != IDLE;
+    }
+
+    State getState(){
+      return state;
+    }
+
+    const HttpFetchStats& getStats(){
+      return stats;
+    }
+
+    /** Stop the running request without notifying the listener */
+    void abort(){
+      if(state != IDLE){
+        close();
+        state = IDLE;
+      }
+    }
+
+    /** Close the kept connection, if any */
+    void close(){
+      if(client != NULL){
+        client->stop();
+      }
+      connectedHost[0] = '\0';
+    }
+
+    /** Advance the running request by a bounded slice of work */
+    void poll(){
+      switch(state){
+        case IDLE:
+          return;
+        case CONNECTING:
+          if(!connect()){
+            Serial.print(F("[HTTP] Unable to connect to "));
+            Serial.println(host);
+            complete(0);
+            return;
+          }
+          state = SENDING;
+          lastActivity = millis();
+          return;
+        case SENDING:
+          send();
+          break;
+        default:
+          receive();
+          break;
+      }
+      if(state != IDLE && millis() - lastActivity > HTTP_FETCH_TIMEOUT_MS){
+        Serial.println(F("[HTTP] Timeout"));
+        complete(0);
+      }
+    }
+
+  private:
+    /** Extract host and port. Return the path or NULL when the url is invalid */
+    const char* parseUrl(const char* url){
+      port = 80;
+      const char* scheme = strstr(url, "://");
+      if(scheme != NULL){
+        if(strncmp(url, "https", 5) == 0){
+          port = 443;
+        }
+        url = scheme + 3;
+      }
+      size_t hostLength = strcspn(url, ":/");
+      if(hostLength == 0 || hostLength >= sizeof(host)){
+        return NULL;
+      }
+      memcpy(host, url, hostLength);
+      host[hostLength] = '\0';
+      const char* path = url + hostLength;
+      if(*path == ':'){
+        port = (uint16_t)atoi(path + 1);
+        path = strchr(path, '/');
+      }
+      return path != NULL && *path == '/' ? path : "/";
+    }
+
+    /** Reuse the open connection when it goes to the same host, open a new one otherwise */
+    bool connect(){
+      if(connectedHost[0] != '\0' && connectedPort == port && strcmp(connectedHost, host) == 0 && client->connected()){
+        reused = true;
+        stats.reusedConnections++;
+        return true;
+      }
+      close();
+      reused = false;
+      METRICS_BEGIN(METRIC_WIFI_CHECK);
+      bool wifiConnected = WiFi.status() == WL_CONNECTED;
+      METRICS_END(METRIC_WIFI_CHECK);
+      if(!wifiConnected){
+        Serial.println(F("[HTTP] WiFi not connected"));
+        return false;
+      }
+#if ENABLE_METRICS
+      // connect() resolves the host too, it then finds the address in the lwIP DNS cache
+      IPAddress address;
+      METRICS_BEGIN(METRIC_DNS);
+      WiFi.hostByName(host, address);
+      METRICS_END(METRIC_DNS);
+#endif
+      long freeHeap = ESP.getFreeHeap();
+      unsigned long connectStart = millis();
+      METRICS_BEGIN(METRIC_TLS_HANDSHAKE);
+      if(!client->connect(host, port)){
+        METRICS_DISCARD(METRIC_TLS_HANDSHAKE);
+        return false;
+      }
+      METRICS_END(METRIC_TLS_HANDSHAKE);
+      stats.connections++;
+      stats.lastConnectMs = millis() - connectStart;
+      stats.lastConnectHeapBytes = freeHeap - (long)ESP.getFreeHeap();
+      strcpy(connectedHost, host);
+      connectedPort = port;
+      return true;
+    }
+
+    /** The server closed the kept connection before answering: send the request again on a new one */
+    bool retryOnNewConnection(){
+      if(!reused){
+        return false;
+      }
+      Serial.println(F("[HTTP] Kept connection closed by the server, reconnecting"));
+      close();
+      reused = false;
+      requestSent = 0;
+      lineLength = 0;
+      state = CONNECTING;
+      return true;
+    }
+
+    void complete(int code){
+      if(state == READING_BODY){
+        METRICS_END(METRIC_BODY);
+      }else{
+        METRICS_DISCARD(METRIC_FIRST_BYTE);
+        METRICS_DISCARD(METRIC_BODY);
+      }
+      if(!keepAlive || !reusable || code == 0){
+        close();
+      }
+      state = IDLE;
+#if RECORD_HTTP
+      Serial.print(F("@rec end "));
+      Serial.println(code);
+#endif
+      stats.lastRequestMs = millis() - startedAt;
+      stats.totalRequestMs += stats.lastRequestMs;
+      listener->onComplete(code);
+    }
+
+    void send(){
+      size_t written = client->write((const uint8_t*)request + requestSent, requestLength - requestSent);
+      if(written > 0){
+        requestSent += written;
+        lastActivity = millis();
+      }else if(!client->connected() && retryOnNewConnection()){
+        return;
+      }
+      if(requestSent == requestLength){
+        state = READING_STATUS;
+        METRICS_BEGIN(METRIC_FIRST_BYTE);
+      }
+    }
+
+    void receive(){
+      int available = client->available();
+      if(available <= 0){
+        if(!client->connected()){
+          if(state == READING_STATUS && lineLength == 0 && retryOnNewConnection()){
+            return;
+          }
+          // Without length nor chunks, the end of the body is the end of the connection
+          complete(state == READING_BODY && !chunked && contentLength < 0 ? httpCode : 0);
+        }
+        return;
+      }
+      uint8_t buffer[HTTP_FETCH_SLICE_BYTES];
+      int length = client->read(buffer, available < HTTP_FETCH_SLICE_BYTES ? available : HTTP_FETCH_SLICE_BYTES);
+      if(length <= 0){
+        return;
+      }
+      lastActivity = millis();
+#if RECORD_HTTP
+      record(buffer, length);
+#endif
+      if(state == READING_STATUS){
+        METRICS_END(METRIC_FIRST_BYTE);
+      }
+      int i = 0;
+      while(i < length && state != IDLE){
+        if(state == READING_BODY){
+          i += readBody(buffer + i, length - i);
+        }else{
+          if(readLine(buffer[i++])){
+            handleHeaderLine();
+          }
+        }
+      }
+    }
+
+#if RECORD_HTTP
+    static void record(const uint8_t* data, int length){
+      Serial.print(F("@rec data "));
+      for(int i = 0; i < length; i++){
+        Serial.printf("%02x", data[i]);
+      }
+      Serial.println();
+    }
+#endif
+
+    /** Accumulate one character, return true when a full line is available */
+    bool readLine(char c){
+      if(c == '\n'){
+        if(lineLength > 0 && line[lineLength - 1] == '\r'){
+          lineLength--;
+        }
+        line[lineLength] = '\0';
+        lineLength = 0;
+        return true;
+      }
+      if(lineLength < HTTP_FETCH_LINE_LENGTH - 1){
+        line[lineLength++] = c;
+      }
+      return false;
+    }
+
+    void handleHeaderLine(){
+      if(state == READING_STATUS){
+        // HTTP/1.1 200 OK
+        const char* code = strchr(line, ' ');
+        httpCode = code != NULL ? atoi(code + 1) : 0;
+        if(httpCode <= 0){
+          complete(0);
+          return;
+        }
+        chunked = false;
+        contentLength = -1;
+        reusable = strncmp(line, "HTTP/1.1", 8) == 0;
+        state = READING_HEADERS;
+      }else if(line[0] == '\0'){
+        startBody();
+      }else if(strncasecmp(line, "Content-Length:", 15) == 0){
+        contentLength = atol(line + 15);
+      }else if(strncasecmp(line, "Transfer-Encoding:", 18) == 0 && strstr(line + 18, "chunked") != NULL){
+        chunked = true;
+      }else if(strncasecmp(line, "Connection:", 11) == 0 && strstr(line + 11, "close") != NULL){
+        reusable = false;
+      }
+    }
+
+    void startBody(){
+      state = READING_BODY;
+      METRICS_BEGIN(METRIC_BODY);
+      if(chunked){
+        chunkState = CHUNK_SIZE;
+      }else if(contentLength == 0){
+        complete(httpCode);
+      }else{
+        remaining = contentLength;
+        // A body without length ends with the connection
+        reusable = reusable && contentLength > 0;
+      }
+    }
+
+    void deliver(const uint8_t* data, size_t length){
+      if(httpCode == 200 && !listener->onBody(data, length)){
+        complete(0);
+      }
+    }
+
+    /** Consume body bytes, decoding the chunked transfer encoding. Return the number of bytes consumed. */
+    int readBody(const uint8_t* data, int length){
+      if(!chunked){
+        int size = contentLength < 0 || remaining > length ? length : (int)remaining;
+        deliver(data, size);
+        if(state != IDLE && contentLength >= 0){
+          remaining -= size;
+          if(remaining == 0){
+            complete(httpCode);
+          }
+        }
+        return size;
+      }
+      switch(chunkState){
+        case CHUNK_DATA: {
+          int size = remaining > length ? length : (int)remaining;
+          deliver(data, size);
+          remaining -= size;
+          if(remaining == 0){
+            chunkState = CHUNK_DATA_END;
+          }
+          return size;
+        }
+        case CHUNK_DATA_END:
+          if(data[0] == '\n'){
+            chunkState = CHUNK_SIZE;
+          }
+          return 1;
+        case CHUNK_SIZE:
+          if(readLine(data[0])){
+            remaining = strtol(line, NULL, 16);
+            chunkState = remaining > 0 ? CHUNK_DATA : CHUNK_TRAILER;
+          }
+          return 1;
+        case CHUNK_TRAILER:
+          if(readLine(data[0]) && line[0] == '\0'){
+            complete(httpCode);
+          }
+          return 1;
+      }
+      return 1;
+    }
+};
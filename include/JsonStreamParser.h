@@ -0,0 +1,244 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+/** Max nesting of objects/arrays followed by the parser */
+#define JSON_STREAM_MAX_DEPTH 8
+/** Keys longer than this are truncated */
+#define JSON_STREAM_MAX_KEY_LENGTH 24
+/** Scalar values longer than this are truncated */
+#define JSON_STREAM_MAX_VALUE_LENGTH 48
+
+/** Receives the events of the JsonStreamParser.
+ *  - depth is the nesting level of the container (1 for the root object)
+ *  - key is the member name in the enclosing object. Array items inherit the key of their array.
+ *  - array tells if the container is an array or an object
+ */
+class JsonStreamHandler {
+  public:
+    virtual ~JsonStreamHandler() {}
+    virtual void onContainerStart(int /*depth*/, const char* /*key*/, bool /*array*/) {}
+    virtual void onContainerEnd(int /*depth*/, const char* /*key*/, bool /*array*/) {}
+    virtual void onValue(int /*depth*/, const char* /*key*/, const char* /*value*/) {}
+};
+
+/** Incremental JSON tokenizer.
+ *  Characters are fed one by one so the document can be consumed straight from the network stream
+ *  without buffering the body. Memory usage is fixed whatever the size of the payload.
+ */
+class JsonStreamParser {
+  enum State {
+    EXPECT_VALUE,
+    EXPECT_VALUE_OR_END,
+    EXPECT_KEY,
+    EXPECT_KEY_OR_END,
+    IN_KEY,
+    EXPECT_COLON,
+    IN_STRING,
+    IN_LITERAL,
+    AFTER_VALUE,
+    DONE,
+    FAILED
+  };
+
+  JsonStreamHandler* handler;
+  State state;
+  int depth;
+  bool escaping;
+  uint8_t unicodeDigits;
+  bool isArray[JSON_STREAM_MAX_DEPTH + 1];
+  char keys[JSON_STREAM_MAX_DEPTH + 1][JSON_STREAM_MAX_KEY_LENGTH];
+  char value[JSON_STREAM_MAX_VALUE_LENGTH];
+  uint8_t valueLength;
+
+  public:
+    JsonStreamParser(JsonStreamHandler* handler) :
+      handler(handler)
+    {
+      reset();
+    }
+
+    void reset(){
+      state = EXPECT_VALUE;
+      depth = 0;
+      escaping = false;
+      unicodeDigits = 0;
+      valueLength = 0;
+      isArray[0] = false;
+      keys[0][0] = '\0';
+    }
+
+    bool isDone(){
+      return state == DONE;
+    }
+
+    bool hasFailed(){
+      return state == FAILED;
+    }
+
+    /** Feed one character of the document. Return false once the document is known to be malformed. */
+    bool feed(char c){
+      switch(state){
+        case DONE:
+        case FAILED:
+          return state != FAILED;
+        case IN_KEY:
+        case IN_STRING:
+          readStringChar(c);
+          return true;
+        case IN_LITERAL:
+          if(c == ',' || c == '}' || c == ']' || isWhitespace(c)){
+            endValue();
+            return feed(c);
+          }
+          appendValue(c);
+          return true;
+        default:
+          break;
+      }
+      if(isWhitespace(c)){
+        return true;
+      }
+      switch(state){
+        case EXPECT_VALUE_OR_END:
+          if(c == ']'){
+            return endContainer(true);
+          }
+          // fall through
+        case EXPECT_VALUE:
+          return startValue(c);
+        case EXPECT_KEY_OR_END:
+          if(c == '}'){
+            return endContainer(false);
+          }
+          // fall through
+        case EXPECT_KEY:
+          if(c != '"'){
+            return fail();
+          }
+          valueLength = 0;
+          state = IN_KEY;
+          return true;
+        case EXPECT_COLON:
+          if(c != ':'){
+            return fail();
+          }
+          state = EXPECT_VALUE;
+          return true;
+        case AFTER_VALUE:
+          if(c == ','){
+            state = isArray[depth] ? EXPECT_VALUE : EXPECT_KEY;
+            return true;
+          }
+          if(c == '}' || c == ']'){
+            return endContainer(c == ']');
+          }
+          return fail();
+        default:
+          return fail();
+      }
+    }
+
+  private:
+    static bool isWhitespace(char c){
+      return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    bool fail(){
+      state = FAILED;
+      return false;
+    }
+
+    /** Key of the value currently parsed. Items of an array use the key of the array. */
+    const char* currentKey(){
+      int level = depth;
+      while(level > 0 && isArray[level]){
+        level--;
+      }
+      return keys[level];
+    }
+
+    void appendValue(char c){
+      if(valueLength < JSON_STREAM_MAX_VALUE_LENGTH - 1){
+        value[valueLength++] = c;
+      }
+    }
+
+    bool startValue(char c){
+      if(c == '{' || c == '['){
+        if(depth == JSON_STREAM_MAX_DEPTH){
+          return fail();
+        }
+        const char* key = currentKey();
+        depth++;
+        isArray[depth] = c == '[';
+        keys[depth][0] = '\0';
+        handler->onContainerStart(depth, key, isArray[depth]);
+        state = isArray[depth] ? EXPECT_VALUE_OR_END : EXPECT_KEY_OR_END;
+        return true;
+      }
+      if(depth == 0){
+        return fail();
+      }
+      valueLength = 0;
+      if(c == '"'){
+        state = IN_STRING;
+      }else{
+        appendValue(c);
+        state = IN_LITERAL;
+      }
+      return true;
+    }
+
+    bool endContainer(bool array){
+      if(depth == 0 || isArray[depth] != array){
+        return fail();
+      }
+      depth--;
+      handler->onContainerEnd(depth + 1, currentKey(), array);
+      state = depth == 0 ? DONE : AFTER_VALUE;
+      return true;
+    }
+
+    void endValue(){
+      value[valueLength] = '\0';
+      handler->onValue(depth, currentKey(), value);
+      state = AFTER_VALUE;
+    }
+
+    void readStringChar(char c){
+      if(unicodeDigits > 0){
+        // Non ASCII characters can't be displayed on the LCD, only keep a placeholder
+        if(--unicodeDigits == 0){
+          appendValue('?');
+        }
+        return;
+      }
+      if(escaping){
+        escaping = false;
+        switch(c){
+          case 'n': appendValue('\n'); break;
+          case 't': appendValue('\t'); break;
+          case 'r': appendValue('\r'); break;
+          case 'b': appendValue('\b'); break;
+          case 'f': appendValue('\f'); break;
+          case 'u': unicodeDigits = 4; break;
+          default: appendValue(c);
+        }
+        return;
+      }
+      if(c == '\\'){
+        escaping = true;
+      }else if(c != '"'){
+        appendValue(c);
+      }else if(state == IN_KEY){
+        value[valueLength] = '\0';
+        size_t length = valueLength < JSON_STREAM_MAX_KEY_LENGTH - 1 ? valueLength : JSON_STREAM_MAX_KEY_LENGTH - 1;
+        memcpy(keys[depth], value, length);
+        keys[depth][length] = '\0';
+        state = EXPECT_COLON;
+      }else{
+        endValue();
+      }
+    }
+};
@@ -0,0 +1,191 @@
+#pragma once
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include "config.h"
+#include "PassingTime.h"
+
+#define LAN_REQUEST_LENGTH 160
+/** Time (in ms) given to a client to send its request */
+#define LAN_REQUEST_TIMEOUT_MS 1000
+#define LAN_PASSING_TIME_PATH "/OperationMonitoring/3.0/PassingTimeByPoint/"
+#define LAN_MAX_POINTS_PER_REQUEST 10
+/** The response is sent by packets of this size instead of character by character */
+#define LAN_SEND_BUFFER_SIZE 256
+
+/** Collects the small prints into packets */
+class BufferedPrint : public Print {
+  Print& out;
+  uint8_t buffer[LAN_SEND_BUFFER_SIZE];
+  size_t length = 0;
+
+  public:
+    BufferedPrint(Print& out) :
+      out(out)
+    {
+    }
+
+    size_t write(uint8_t c) override {
+      if(length == sizeof(buffer)){
+        flush();
+      }
+      buffer[length++] = c;
+      return 1;
+    }
+
+    void flush() override {
+      out.write(buffer, length);
+      length = 0;
+    }
+};
+
+/** Print a string as a JSON string */
+void printJsonString(Print& out, const char* value){
+  out.print('"');
+  for(; *value != '\0'; value++){
+    if(*value == '"' || *value == '\\'){
+      out.print('\\');
+    }
+    out.print(*value);
+  }
+  out.print('"');
+}
+
+/** Print the responses of the given stops like the PassingTimeByPoint API:
+ *  {"points":[{"passingTimes":[{"destination":{"fr":".."},"expectedArrivalTime":"..","lineId":".."}],"pointId":".."}]}
+ *  Only the stops found in stopIds with passing times received from the API are printed, the others are absent.
+ *  Return the number of points printed.
+ */
+int printPassingTimeByPoint(Print& out, const char* const* requestedIds, int numberOfRequestedIds,
+    const char* const* stopIds, PassingTimeResponse* responses, int numberOfStops){
+  int printed = 0;
+  out.print(F("{\"points\":["));
+  for(int r = 0; r < numberOfRequestedIds; r++){
+    int s = 0;
+    while(s < numberOfStops && strcmp(stopIds[s], requestedIds[r]) != 0){
+      s++;
+    }
+    if(s == numberOfStops || !responses[s].isReceived() || responses[s].source != SOURCE_API){
+      continue;
+    }
+    PassingTimeResponse* response = &responses[s];
+    out.print(printed++ > 0 ? F(",{\"passingTimes\":[") : F("{\"passingTimes\":["));
+    for(int i = 0; i < response->numberOfResponses; i++){
+      PassingTime* passingTime = &response->passingTimes[i];
+      char expectedTime[EXPECTED_TIME_LENGTH];
+      formatEpochToIsoDate(passingTime->getExpectedEpoch(), passingTime->getUtcOffset(), expectedTime);
+      out.print(i > 0 ? F(",{\"destination\":{\"fr\":") : F("{\"destination\":{\"fr\":"));
+      printJsonString(out, response->getDestination(i));
+      out.print(F("},\"expectedArrivalTime\":\""));
+      out.print(expectedTime);
+      out.print(F("\",\"lineId\":"));
+      printJsonString(out, passingTime->getLine());
+      out.print('}');
+    }
+    out.print(F("],\"pointId\":"));
+    printJsonString(out, stopIds[s]);
+    out.print('}');
+  }
+  out.print(F("]}"));
+  return printed;
+}
+
+/** Split "5311%2C1715" (or "5311,1715") in place into point ids. Return the number of ids. */
+int splitPointIds(char* list, const char** ids, int maxIds){
+  int count = 0;
+  char* start = list;
+  for(char* c = list; ; c++){
+    bool end = *c == '\0' || *c == ' ' || *c == '?';
+    int separatorLength = *c == ',' ? 1 : (strncmp(c, "%2C", 3) == 0 || strncmp(c, "%2c", 3) == 0 ? 3 : 0);
+    if(!end && separatorLength == 0){
+      continue;
+    }
+    if(c > start && count < maxIds){
+      ids[count++] = start;
+    }
+    *c = '\0';
+    if(end){
+      return count;
+    }
+    c += separatorLength - 1;
+    start = c + 1;
+  }
+}
+
+/** Hub mode: the other displays of the LAN read the passing times cached by this one instead of the STIB-MIVB API.
+ *  GET /OperationMonitoring/3.0/PassingTimeByPoint/<id>%2C<id> answers like the API, so a display uses a hub
+ *  with the ENV_API_* flags of config.h, without code change. The hub refreshes its favourites every
+ *  LAN_HUB_REFRESH_SEC whatever the number of displays: the upstream requests don't grow with them.
+ *  One client is served at a time, its request is read over several passes.
+ */
+class LanServer {
+  WiFiServer server;
+  WiFiClient client;
+  const char* const* stopIds;
+  PassingTimeResponse* responses;
+  int numberOfStops;
+  char request[LAN_REQUEST_LENGTH];
+  uint8_t requestLength = 0;
+  unsigned long acceptedAt = 0;
+  unsigned long served = 0;
+
+  public:
+    LanServer(uint16_t port, const char* const* stopIds, PassingTimeResponse* responses, int numberOfStops) :
+      server(port),
+      stopIds(stopIds),
+      responses(responses),
+      numberOfStops(numberOfStops)
+    {
+    }
+
+    void begin(){
+      server.begin();
+      Serial.print(F("[LAN] Serving the passing times on "));
+      Serial.println(WiFi.localIP());
+    }
+
+    /** Accept a client or progress with the current one. To be called on every loop() pass. */
+    void poll(){
+      if(!client){
+        client = server.available();
+        if(!client){
+          return;
+        }
+        requestLength = 0;
+        acceptedAt = millis();
+      }
+      while(client.available() && requestLength < LAN_REQUEST_LENGTH - 1){
+        request[requestLength++] = client.read();
+      }
+      request[requestLength] = '\0';
+      // Only the request line is needed
+      if(strstr(request, "\r\n") != NULL || requestLength == LAN_REQUEST_LENGTH - 1){
+        answer();
+      }else if(millis() - acceptedAt >= LAN_REQUEST_TIMEOUT_MS || !client.connected()){
+        client.stop();
+      }
+    }
+
+    unsigned long getServed(){
+      return served;
+    }
+
+  private:
+    void answer(){
+      const char* ids[LAN_MAX_POINTS_PER_REQUEST];
+      int numberOfIds = 0;
+      if(strncmp(request, "GET ", 4) == 0 && strncmp(request + 4, LAN_PASSING_TIME_PATH, strlen(LAN_PASSING_TIME_PATH)) == 0){
+        numberOfIds = splitPointIds(request + 4 + strlen(LAN_PASSING_TIME_PATH), ids, LAN_MAX_POINTS_PER_REQUEST);
+      }
+      if(numberOfIds == 0){
+        client.print(F("HTTP/1.1 404 Not Found\r\nConnection: close\r\nContent-Length: 0\r\n\r\n"));
+      }else{
+        // The body ends with the connection
+        client.print(F("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\n\r\n"));
+        BufferedPrint out(client);
+        printPassingTimeByPoint(out, ids, numberOfIds, stopIds, responses, numberOfStops);
+        out.flush();
+        served++;
+      }
+      client.stop();
+    }
+};
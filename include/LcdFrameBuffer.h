@@ -0,0 +1,155 @@
+#pragma once
+#include <Arduino.h>
+#include <LiquidCrystal_I2C.h>
+
+#define LCD_COLUMNS 16
+#define LCD_ROWS 2
+/** Every byte sent to the HD44780 goes through the PCF8574 as 2 nibbles,
+ *  each one written 3 times (data, enable high, enable low), each write being address + data on I2C.
+ */
+#define I2C_BYTES_PER_LCD_BYTE 12
+
+/** Shadow of the 16x2 cells between the app and the LCD.
+ *  The app draws a complete frame, flush() only sends the cells which changed since the previous frame,
+ *  with the minimum of cursor moves. No clear() is ever sent, so the screen doesn't flicker.
+ */
+class LcdFrameBuffer {
+  LiquidCrystal_I2C* lcd;
+  /** What is displayed on the LCD */
+  char shadow[LCD_ROWS][LCD_COLUMNS];
+  /** What should be displayed after the next flush */
+  char frame[LCD_ROWS][LCD_COLUMNS];
+  bool shadowValid = false;
+  /** Position of the LCD cursor, -1 when unknown */
+  int cursorRow = -1;
+  int cursorColumn = -1;
+  unsigned long lastFrameLcdBytes = 0;
+  unsigned long totalLcdBytes = 0;
+
+  public:
+    LcdFrameBuffer(LiquidCrystal_I2C* lcd) :
+      lcd(lcd)
+    {
+      clear();
+    }
+
+    /** Blank the frame. Nothing is sent before flush() */
+    void clear(){
+      memset(frame, ' ', sizeof(frame));
+    }
+
+    void clearRow(int row){
+      memset(frame[row], ' ', LCD_COLUMNS);
+    }
+
+    /** The content of the LCD is unknown (e.g. after lcd.init()), the next flush rewrites every cell */
+    void invalidate(){
+      shadowValid = false;
+      cursorRow = -1;
+    }
+
+    void printChar(int column, int row, char c){
+      if(row >= 0 && row < LCD_ROWS && column >= 0 && column < LCD_COLUMNS){
+        frame[row][column] = c;
+      }
+    }
+
+    /** Draw the text from the given cell, truncated at the end of the row. Return the column after the text */
+    int print(int column, int row, const char* text){
+      while(*text != '\0' && column < LCD_COLUMNS){
+        printChar(column++, row, *text++);
+      }
+      return column;
+    }
+
+    int print(int column, int row, const String& text){
+      return print(column, row, text.c_str());
+    }
+
+    int print(int column, int row, const __FlashStringHelper* text){
+      PGM_P p = reinterpret_cast<PGM_P>(text);
+      char c;
+      while((c = pgm_read_byte(p++)) != '\0' && column < LCD_COLUMNS){
+        printChar(column++, row, c);
+      }
+      return column;
+    }
+
+    /** Draw the text from the given cell and blank the rest of the row */
+    void printPadded(int column, int row, const char* text){
+      column = print(column, row, text);
+      while(column < LCD_COLUMNS){
+        printChar(column++, row, ' ');
+      }
+    }
+
+    void printPadded(int column, int row, const String& text){
+      printPadded(column, row, text.c_str());
+    }
+
+    /** Replace a whole row, padded with spaces */
+    void printLine(int row, const char* text){
+      clearRow(row);
+      print(0, row, text);
+    }
+
+    void printLine(int row, const String& text){
+      printLine(row, text.c_str());
+    }
+
+    void printLine(int row, const __FlashStringHelper* text){
+      clearRow(row);
+      print(0, row, text);
+    }
+
+    /** Send the cells which changed to the LCD */
+    void flush(){
+      lastFrameLcdBytes = 0;
+      for(int row = 0; row < LCD_ROWS; row++){
+        for(int column = 0; column < LCD_COLUMNS; column++){
+          if(shadowValid && shadow[row][column] == frame[row][column]){
+            continue;
+          }
+          moveCursor(column, row);
+          lcd->write((uint8_t)frame[row][column]);
+          shadow[row][column] = frame[row][column];
+          cursorColumn++;
+          lastFrameLcdBytes++;
+        }
+      }
+      shadowValid = true;
+      totalLcdBytes += lastFrameLcdBytes;
+    }
+
+    /** I2C bytes sent by the last flush */
+    unsigned long getLastFrameI2cBytes(){
+      return lastFrameLcdBytes * I2C_BYTES_PER_LCD_BYTE;
+    }
+
+    unsigned long getTotalI2cBytes(){
+      return totalLcdBytes * I2C_BYTES_PER_LCD_BYTE;
+    }
+
+    /** I2C bytes of the former rendering: clear(), 2 cursor moves and the 32 cells */
+    static unsigned long getFullRedrawI2cBytes(){
+      return (1 + LCD_ROWS + LCD_ROWS * LCD_COLUMNS) * I2C_BYTES_PER_LCD_BYTE;
+    }
+
+  private:
+    void moveCursor(int column, int row){
+      if(cursorRow == row && cursorColumn == column){
+        return;
+      }
+      // Rewriting one unchanged cell costs the same as a cursor move
+      if(cursorRow == row && cursorColumn == column - 1 && shadowValid){
+        lcd->write((uint8_t)frame[row][cursorColumn]);
+        cursorColumn++;
+        lastFrameLcdBytes++;
+        return;
+      }
+      lcd->setCursor(column, row);
+      cursorRow = row;
+      cursorColumn = column;
+      lastFrameLcdBytes++;
+    }
+};
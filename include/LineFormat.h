@@ -0,0 +1,46 @@
+#pragma once
+#include "Pgmspace.h"
+
+/** Length of a row of the LCD, the buffers of a line have one more byte for the terminator */
+#define LCD_LINE_LENGTH 16
+/** Custom glyph 1 of the LCD, see setup() */
+#define DOWN_ARROW_CHAR '\1'
+
+/** Formatting of the rows straight into fixed LCD_LINE_LENGTH + 1 buffers, without String nor heap allocation.
+ *  Passing time row: line (3) destination (10) marker (1) remaining minutes (2)
+ */
+
+/** Copy the text into the cells [column, column + width), truncated or padded with spaces */
+void writeCells(char* line, int column, int width, const char* text){
+  int i = 0;
+  for(; i < width && text[i] != '\0'; i++){
+    line[column + i] = text[i];
+  }
+  for(; i < width; i++){
+    line[column + i] = ' ';
+  }
+}
+
+/** Row of a passing time. remainingMinutes: 0 is displayed as 2 down arrows, over 90 as "--" */
+void formatPassingTimeLine(char* line, const char* lineId, const char* destination, char marker, long remainingMinutes){
+  writeCells(line, 0, 3, lineId);
+  writeCells(line, 3, 10, destination);
+  line[13] = marker;
+  if(remainingMinutes <= 0){
+    line[14] = DOWN_ARROW_CHAR;
+    line[15] = DOWN_ARROW_CHAR;
+  }else if(remainingMinutes > 90){
+    line[14] = '-';
+    line[15] = '-';
+  }else{
+    line[14] = remainingMinutes < 10 ? ' ' : '0' + remainingMinutes / 10;
+    line[15] = '0' + remainingMinutes % 10;
+  }
+  line[LCD_LINE_LENGTH] = '\0';
+}
+
+/** Copy a PROGMEM text as a whole row, truncated at LCD_LINE_LENGTH */
+void copyLine_P(char* line, PGM_P text){
+  strncpy_P(line, text, LCD_LINE_LENGTH);
+  line[LCD_LINE_LENGTH] = '\0';
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <Arduino.h>
+
+/** Per-phase latency and heap instrumentation, compiled in with -D ENABLE_METRICS=1.
+ *  Each phase produces a sample (duration, heap free/max block/fragmentation before and after)
+ *  stored in a ring buffer of METRICS_CAPACITY samples. Sending 'm' on Serial dumps it as CSV.
+ *  Without ENABLE_METRICS every macro expands to nothing.
+ */
+#ifndef ENABLE_METRICS
+#define ENABLE_METRICS 0
+#endif
+
+#if ENABLE_METRICS
+
+#ifndef METRICS_CAPACITY
+#define METRICS_CAPACITY 64
+#endif
+
+enum MetricPhase {
+  METRIC_WIFI_CHECK,
+  METRIC_DNS,
+  METRIC_TLS_HANDSHAKE,
+  METRIC_FIRST_BYTE,
+  METRIC_BODY,
+  /** Includes the sort of the passing times, which happens while parsing */
+  METRIC_PARSE,
+  METRIC_SORT,
+  METRIC_FORMAT,
+  METRIC_LCD,
+  METRIC_PHASE_COUNT
+};
+
+const char* const METRIC_PHASE_NAMES[METRIC_PHASE_COUNT] = {
+  "wifi", "dns", "tls", "first_byte", "body", "parse", "sort", "format", "lcd"
+};
+
+struct HeapSnapshot {
+  uint32_t free;
+  uint16_t maxBlock;
+  uint8_t fragmentation;
+};
+
+struct MetricSample {
+  unsigned long at;
+  uint8_t phase;
+  uint32_t durationUs;
+  HeapSnapshot before;
+  HeapSnapshot after;
+};
+
+class Metrics {
+  /** A phase can be paused and resumed: its durations are summed until it is recorded */
+  struct RunningPhase {
+    bool pending;
+    uint32_t startUs;
+    uint32_t totalUs;
+    HeapSnapshot before;
+  };
+
+  MetricSample samples[METRICS_CAPACITY];
+  int head = 0;
+  int count = 0;
+  RunningPhase running[METRIC_PHASE_COUNT];
+
+  public:
+    Metrics(){
+      for(int i = 0; i < METRIC_PHASE_COUNT; i++){
+        running[i].pending = false;
+      }
+    }
+
+    void begin(MetricPhase phase){
+      RunningPhase& r = running[phase];
+      if(!r.pending){
+        r.pending = true;
+        r.totalUs = 0;
+        takeHeapSnapshot(&r.before);
+      }
+      r.startUs = micros();
+    }
+
+    void pause(MetricPhase phase){
+      RunningPhase& r = running[phase];
+      if(r.pending){
+        r.totalUs += micros() - r.startUs;
+      }
+    }
+
+    /** Store the sample of the phase in the ring buffer */
+    void record(MetricPhase phase){
+      RunningPhase& r = running[phase];
+      if(!r.pending){
+        return;
+      }
+      MetricSample& sample = samples[head];
+      sample.at = millis();
+      sample.phase = phase;
+      sample.durationUs = r.totalUs;
+      sample.before = r.before;
+      takeHeapSnapshot(&sample.after);
+      head = (head + 1) % METRICS_CAPACITY;
+      if(count < METRICS_CAPACITY){
+        count++;
+      }
+      r.pending = false;
+    }
+
+    void end(MetricPhase phase){
+      pause(phase);
+      record(phase);
+    }
+
+    /** Forget a phase which didn't do any work */
+    void discard(MetricPhase phase){
+      running[phase].pending = false;
+    }
+
+    /** Print the samples, oldest first */
+    void dump(Print& out){
+      out.println(F("ms,phase,duration_us,free_before,free_after,max_block_before,max_block_after,frag_before,frag_after"));
+      for(int i = 0; i < count; i++){
+        MetricSample& sample = samples[(head - count + i + METRICS_CAPACITY) % METRICS_CAPACITY];
+        out.printf("%lu,%s,%u,%u,%u,%u,%u,%u,%u\n", sample.at, METRIC_PHASE_NAMES[sample.phase], (unsigned int)sample.durationUs,
+          (unsigned int)sample.before.free, (unsigned int)sample.after.free,
+          (unsigned int)sample.before.maxBlock, (unsigned int)sample.after.maxBlock,
+          (unsigned int)sample.before.fragmentation, (unsigned int)sample.after.fragmentation);
+      }
+    }
+
+    /** Dump the samples when 'm' is received on Serial */
+    void pollSerial(){
+      while(Serial.available() > 0){
+        if(Serial.read() == 'm'){
+          dump(Serial);
+        }
+      }
+    }
+
+  private:
+    static void takeHeapSnapshot(HeapSnapshot* snapshot){
+      ESP.getHeapStats(&snapshot->free, &snapshot->maxBlock, &snapshot->fragmentation);
+    }
+};
+
+Metrics metrics;
+
+#define METRICS_BEGIN(phase) metrics.begin(phase)
+#define METRICS_PAUSE(phase) metrics.pause(phase)
+#define METRICS_RECORD(phase) metrics.record(phase)
+#define METRICS_END(phase) metrics.end(phase)
+#define METRICS_DISCARD(phase) metrics.discard(phase)
+#define METRICS_POLL_SERIAL() metrics.pollSerial()
+
+#else
+
+#define METRICS_BEGIN(phase) do{}while(0)
+#define METRICS_PAUSE(phase) do{}while(0)
+#define METRICS_RECORD(phase) do{}while(0)
+#define METRICS_END(phase) do{}while(0)
+#define METRICS_DISCARD(phase) do{}while(0)
+#define METRICS_POLL_SERIAL() do{}while(0)
+
+#endif
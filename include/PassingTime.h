@@ -1,48 +1,178 @@
 #pragma once
-#include <Arduino.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 
+#define LINE_ID_LENGTH 4
+#define DESTINATION_LENGTH 24
+/** ISO date received from the API: 2019-03-03T21:30:00+01:00 */
+#define EXPECTED_TIME_LENGTH 26
+/** Capacity of a PassingTimeResponse */
+#define MAX_PASSING_TIMES 10
+
+/** Parse an ISO date (2019-03-03T21:30:00+01:00) into seconds since 1970-01-01 UTC, without allocation.
+ *  utcOffsetInSec receives the offset of the date (3600 for +01:00). Return 0 when the date is malformed.
+ */
+uint32_t parseIsoDateToEpoch(const char* date, long* utcOffsetInSec){
+  // Checked in order, so that a short date stops at its end instead of being read past it
+  static const char pattern[] = "0000-00-00T00:00:00";
+  for(uint8_t i = 0; i < sizeof(pattern) - 1; i++){
+    char c = date[i];
+    if(pattern[i] == '0' ? (c < '0' || c > '9') : c != pattern[i]){
+      return 0;
+    }
+  }
+  long year = (date[0] - '0')*1000 + (date[1] - '0')*100 + (date[2] - '0')*10 + (date[3] - '0');
+  int month = (date[5] - '0')*10 + (date[6] - '0');
+  int day = (date[8] - '0')*10 + (date[9] - '0');
+  long secOfDay = ((date[11] - '0')*10 + (date[12] - '0'))*3600L
+    + ((date[14] - '0')*10 + (date[15] - '0'))*60
+    + (date[17] - '0')*10 + (date[18] - '0');
+  // Optional fraction of second, then Z, +HH:MM or -HH:MM
+  const char* zone = date + 19;
+  while(*zone == '.' || (*zone >= '0' && *zone <= '9')){
+    zone++;
+  }
+  long offset = 0;
+  if((zone[0] == '+' || zone[0] == '-') && strlen(zone) >= 6){
+    offset = ((zone[1] - '0')*10 + (zone[2] - '0'))*3600L + ((zone[4] - '0')*10 + (zone[5] - '0'))*60;
+    if(zone[0] == '-'){
+      offset = -offset;
+    }
+  }
+  // Days since 1970-01-01 in the Gregorian calendar, years starting in March so the leap day is the last one
+  if(month <= 2){
+    year--;
+  }
+  long era = year / 400;
+  long yearOfEra = year - era * 400;
+  long dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  long days = era * 146097 + dayOfEra - 719468;
+  if(utcOffsetInSec != NULL){
+    *utcOffsetInSec = offset;
+  }
+  return (uint32_t)(days * 86400L + secOfDay - offset);
+}
+
+/** Copy at most size - 1 characters of the text into the field, the rest of the field is padded with zeros */
+void copyPadded(char* field, size_t size, const char* text){
+  size_t i = 0;
+  for(; i < size - 1 && text[i] != '\0'; i++){
+    field[i] = text[i];
+  }
+  memset(field + i, 0, size - i);
+}
+
+/** Write the value on exactly the given number of digits, without terminating the string */
+void formatDigits(char* out, unsigned long value, int digits){
+  for(int i = digits - 1; i >= 0; i--){
+    out[i] = '0' + value % 10;
+    value /= 10;
+  }
+}
+
+/** Format an epoch as an ISO date in the given offset, the inverse of parseIsoDateToEpoch.
+ *  date receives EXPECTED_TIME_LENGTH characters: 2019-03-03T21:30:00+01:00
+ */
+void formatEpochToIsoDate(uint32_t epoch, long utcOffsetInSec, char* date){
+  long local = (long)epoch + utcOffsetInSec;
+  long days = local / 86400;
+  long secOfDay = local % 86400;
+  // Inverse of the days since 1970-01-01 above
+  days += 719468;
+  long era = days / 146097;
+  long dayOfEra = days - era * 146097;
+  long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  long shiftedMonth = (5 * dayOfYear + 2) / 153;
+  int day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+  int month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+  long year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+  long offset = utcOffsetInSec < 0 ? -utcOffsetInSec : utcOffsetInSec;
+  formatDigits(date, year, 4);
+  date[4] = '-';
+  formatDigits(date + 5, month, 2);
+  date[7] = '-';
+  formatDigits(date + 8, day, 2);
+  date[10] = 'T';
+  formatDigits(date + 11, secOfDay / 3600, 2);
+  date[13] = ':';
+  formatDigits(date + 14, secOfDay / 60 % 60, 2);
+  date[16] = ':';
+  formatDigits(date + 17, secOfDay % 60, 2);
+  date[19] = utcOffsetInSec < 0 ? '-' : '+';
+  formatDigits(date + 20, offset / 3600, 2);
+  date[22] = ':';
+  formatDigits(date + 23, offset / 60 % 60, 2);
+  date[25] = '\0';
+}
+
+/** Compact record of a passing time, copied by value when the response is sorted.
+ *  The destination is an index in the destinations of its PassingTimeResponse.
+ */
 class PassingTime{
-  String line;
-  String destination;
-  String expectedTime;
-  unsigned long expectedTimeInSec;
+  char line[LINE_ID_LENGTH];
+  uint8_t destinationIndex;
+  /** Offset of the local time of the expected arrival, in minutes */
+  int16_t utcOffsetInMin;
+  /** Sort key: expected arrival in seconds since 1970-01-01 UTC */
+  uint32_t expectedEpoch;
 
   public:
-    PassingTime(String line, String destination, String expectedTime) : 
-      line(line),
-      destination(destination),
-      expectedTime(expectedTime)
-    {      
-      int hour = expectedTime.substring(11, 13).toInt();
-      int min = expectedTime.substring(14, 16).toInt();
-      int sec = expectedTime.substring(17, 19).toInt();
-      expectedTimeInSec = hour*3600 + min*60 + sec;
-    }
-
-    String getLine(){
+    PassingTime(){
+      // The padding too: the records are compared and stored as bytes
+      memset((void*)this, 0, sizeof(*this));
+    }
+
+    /** Fill the record in place. Return false when the expected time is not a valid ISO date */
+    bool set(const char* line, uint8_t destinationIndex, const char* expectedTime){
+      long utcOffset = 0;
+      uint32_t epoch = parseIsoDateToEpoch(expectedTime, &utcOffset);
+      return set(line, destinationIndex, epoch, utcOffset);
+    }
+
+    /** Fill the record from an epoch and the offset of its local time. Return false when the epoch is 0. */
+    bool set(const char* line, uint8_t destinationIndex, uint32_t epoch, long utcOffset){
+      // Padded with zeros like the rest of the record
+      copyPadded(this->line, LINE_ID_LENGTH, line);
+      this->destinationIndex = destinationIndex;
+      expectedEpoch = epoch;
+      utcOffsetInMin = utcOffset / 60;
+      return expectedEpoch != 0;
+    }
+
+    const char* getLine(){
       return line;
     }
 
-    String getDestination(){
-      return destination;
+    uint8_t getDestinationIndex(){
+      return destinationIndex;
+    }
+
+    void setDestinationIndex(uint8_t destinationIndex){
+      this->destinationIndex = destinationIndex;
     }
 
-    String getRawExpectedTime(){
-      return expectedTime;
+    uint32_t getExpectedEpoch(){
+      return expectedEpoch;
+    }
+
+    /** Offset of the local time of the expected arrival, in sec */
+    long getUtcOffset(){
+      return utcOffsetInMin * 60L;
     }
 
     /** Calculate the remaining time in min
      *  If difference is less than 45sec, count it as 0, if greater than 45sec, count the full minute
      *  When current time is 21h28m14s and it is expected at 21h30m00s, it should show 2min
      *  When current time is 21h28m16s and it is expected at 21h30m00s, it should show 1min
-     *  
+     *
      *  When current time is greater than the expected time, return 0 as incoming.
      */
-    long getRemainingTime(unsigned long secSinceBeginOfDay){
-      long diff = expectedTimeInSec - secSinceBeginOfDay;
-      if( diff < -5*60){
-        diff = (24*3600 - secSinceBeginOfDay) + expectedTimeInSec;
-      } else if( diff < 60){
+    long getRemainingTime(uint32_t nowEpoch){
+      long diff = getRemainingSeconds(nowEpoch);
+      if( diff < 60){
         return 0;
       }
       if( (diff % 60)>45){
@@ -51,32 +181,144 @@ class PassingTime{
         return diff/60;
       }
     }
+
+    /** Remaining time in sec, negative when the expected time is passed. Both are UTC: midnight and DST changes don't matter. */
+    long getRemainingSeconds(uint32_t nowEpoch){
+      return (int32_t)(expectedEpoch - nowEpoch);
+    }
 };
 
 
+/** Where the passing times of a PassingTimeResponse come from */
+enum PassingTimeSource {
+  SOURCE_API,
+  /** Snapshot of a previous run, see PassingTimeSnapshot.h */
+  SOURCE_SNAPSHOT,
+  /** Timetable compiled from the GTFS, see Timetable.h */
+  SOURCE_TIMETABLE
+};
+
+/** Fixed capacity store of the passing times of one stop.
+ *  Records are preallocated and kept sorted by expected time, clearing is O(1).
+ *  Destinations are interned: each distinct destination of the stop is stored once.
+ *  No heap allocation is done when a response is received.
+ */
 class PassingTimeResponse{
+  /** Reads and writes the records as they are in memory */
+  friend class PassingTimeSnapshot;
+  /** There are never more distinct destinations than passing times */
+  char destinations[MAX_PASSING_TIMES][DESTINATION_LENGTH];
+  uint8_t numberOfDestinations = 0;
+
   public:
-    int httpCode = 0;
+    /** millis() when the response was received, 0 when nothing has been received yet */
+    unsigned long receivedAt = 0;
+    /** Passing times not from the API are displayed until fresh ones are received */
+    PassingTimeSource source = SOURCE_API;
     int numberOfResponses = 0;
-    PassingTime **passingTimes = NULL;
+    PassingTime passingTimes[MAX_PASSING_TIMES];
+
+    void clear(){
+      receivedAt = 0;
+      source = SOURCE_API;
+      numberOfResponses = 0;
+      numberOfDestinations = 0;
+    }
 
-    PassingTimeResponse(int httpCode):
-      httpCode(httpCode)
-    {      
+    bool isReceived(){
+      return receivedAt != 0;
     }
-  
-    PassingTimeResponse(PassingTime **items, int arraySize){
-      passingTimes = items;
-      numberOfResponses = arraySize;    
-      httpCode = 200;
+
+    /** True when the response is older than the given ttl, not from the API or has never been received */
+    bool isStale(unsigned long now, unsigned long ttlMs){
+      return !isReceived() || source != SOURCE_API || now - receivedAt >= ttlMs;
     }
 
-    void clear(){
-      if(passingTimes != NULL){
-        for(int i = 0; i< numberOfResponses; i++){
-          delete passingTimes[i];
-          passingTimes[i] = NULL;
+    /** Drop the passing times expected before the given epoch, the order is kept */
+    void removePassed(uint32_t epoch){
+      int kept = 0;
+      for(int i = 0; i < numberOfResponses; i++){
+        if(passingTimes[i].getExpectedEpoch() >= epoch){
+          passingTimes[kept++] = passingTimes[i];
+        }
+      }
+      numberOfResponses = kept;
+    }
+
+    /** Destination of the passing time at the given position */
+    const char* getDestination(int index){
+      return destinations[passingTimes[index].getDestinationIndex()];
+    }
+
+    /** Insert a passing time at its place in the chronological order.
+     *  When the store is full, the latest passing time is replaced by an earlier one.
+     *  Return false when the store is full of earlier passing times or the expected time is invalid.
+     */
+    bool add(const char* line, const char* destination, const char* expectedTime){
+      long utcOffset = 0;
+      uint32_t epoch = parseIsoDateToEpoch(expectedTime, &utcOffset);
+      return add(line, destination, epoch, utcOffset);
+    }
+
+    bool add(const char* line, const char* destination, uint32_t epoch, long utcOffset){
+      if(epoch == 0){
+        return false;
+      }
+      if(numberOfResponses == MAX_PASSING_TIMES){
+        if(passingTimes[numberOfResponses-1].getExpectedEpoch() <= epoch){
+          return false;
+        }
+        numberOfResponses--;
+      }
+      uint8_t destinationIndex = findDestination(destination);
+      if(destinationIndex == MAX_PASSING_TIMES){
+        destinationIndex = reclaimDestinations();
+      }
+      PassingTime passingTime;
+      passingTime.set(line, destinationIndex, epoch, utcOffset);
+      if(destinationIndex == numberOfDestinations){
+        copyPadded(destinations[numberOfDestinations], DESTINATION_LENGTH, destination);
+        numberOfDestinations++;
+      }
+      int i = numberOfResponses;
+      while(i > 0 && passingTimes[i-1].getExpectedEpoch() > passingTime.getExpectedEpoch()){
+        passingTimes[i] = passingTimes[i-1];
+        i--;
+      }
+      passingTimes[i] = passingTime;
+      numberOfResponses++;
+      return true;
+    }
+
+  private:
+    /** Index of the destination in the table, numberOfDestinations when it isn't there yet */
+    uint8_t findDestination(const char* destination){
+      uint8_t i = 0;
+      while(i < numberOfDestinations && strncmp(destinations[i], destination, DESTINATION_LENGTH - 1) != 0){
+        i++;
+      }
+      return i;
+    }
+
+    /** Drop the destinations no passing time refers to anymore, return the new numberOfDestinations */
+    uint8_t reclaimDestinations(){
+      uint8_t kept = 0;
+      for(uint8_t d = 0; d < numberOfDestinations; d++){
+        bool used = false;
+        for(int i = 0; i < numberOfResponses; i++){
+          if(passingTimes[i].getDestinationIndex() == d){
+            passingTimes[i].setDestinationIndex(kept);
+            used = true;
+          }
+        }
+        if(used){
+          if(kept != d){
+            memcpy(destinations[kept], destinations[d], DESTINATION_LENGTH);
+          }
+          kept++;
         }
       }
+      numberOfDestinations = kept;
+      return kept;
     }
 };
@@ -0,0 +1,106 @@
+#pragma once
+#include "JsonStreamParser.h"
+#include "PassingTime.h"
+
+#define POINT_ID_LENGTH 8
+
+/** Receive the passing times one at a time, as soon as they are parsed */
+class PassingTimeListener {
+  public:
+    virtual ~PassingTimeListener() {}
+    virtual void onPassingTime(const char* lineId, const char* destination, const char* expectedArrivalTime) = 0;
+    /** Called when all the passing times of a point have been emitted */
+    virtual void onPointEnd(const char* /*pointId*/) {}
+};
+
+/** Extract lineId, destination.fr and expectedArrivalTime from a PassingTimeByPoint response:
+ *  {"points":[{"passingTimes":[{"destination":{"fr":"..","nl":".."},"expectedArrivalTime":"..","lineId":".."}],"pointId":".."}]}
+ */
+class PassingTimeParser : public JsonStreamHandler {
+  PassingTimeListener* listener;
+  JsonStreamParser parser;
+  bool inDestination = false;
+  char lineId[LINE_ID_LENGTH];
+  char destination[DESTINATION_LENGTH];
+  char expectedArrivalTime[EXPECTED_TIME_LENGTH];
+  char pointId[POINT_ID_LENGTH];
+
+  public:
+    PassingTimeParser(PassingTimeListener* listener) :
+      listener(listener),
+      parser(this)
+    {
+      reset();
+    }
+
+    void reset(){
+      parser.reset();
+      inDestination = false;
+      clearPassingTime();
+      pointId[0] = '\0';
+    }
+
+    bool feed(char c){
+      return parser.feed(c);
+    }
+
+    bool isDone(){
+      return parser.isDone();
+    }
+
+    bool hasFailed(){
+      return parser.hasFailed();
+    }
+
+    void onContainerStart(int /*depth*/, const char* key, bool array) override {
+      if(array){
+        return;
+      }
+      if(strcmp(key, "destination") == 0){
+        inDestination = true;
+      }else if(strcmp(key, "passingTimes") == 0){
+        clearPassingTime();
+      }
+    }
+
+    void onContainerEnd(int /*depth*/, const char* key, bool array) override {
+      if(array){
+        return;
+      }
+      if(strcmp(key, "destination") == 0){
+        inDestination = false;
+      }else if(strcmp(key, "passingTimes") == 0){
+        if(lineId[0] != '\0' && expectedArrivalTime[0] != '\0'){
+          listener->onPassingTime(lineId, destination, expectedArrivalTime);
+        }
+        clearPassingTime();
+      }else if(strcmp(key, "points") == 0){
+        listener->onPointEnd(pointId);
+        pointId[0] = '\0';
+      }
+    }
+
+    void onValue(int /*depth*/, const char* key, const char* value) override {
+      if(strcmp(key, "lineId") == 0){
+        copy(lineId, value, LINE_ID_LENGTH);
+      }else if(inDestination && strcmp(key, "fr") == 0){
+        copy(destination, value, DESTINATION_LENGTH);
+      }else if(strcmp(key, "expectedArrivalTime") == 0){
+        copy(expectedArrivalTime, value, EXPECTED_TIME_LENGTH);
+      }else if(strcmp(key, "pointId") == 0){
+        copy(pointId, value, POINT_ID_LENGTH);
+      }
+    }
+
+  private:
+    static void copy(char* dest, const char* src, size_t size){
+      strncpy(dest, src, size - 1);
+      dest[size - 1] = '\0';
+    }
+
+    void clearPassingTime(){
+      lineId[0] = '\0';
+      destination[0] = '\0';
+      expectedArrivalTime[0] = '\0';
+    }
+};
@@ -1,84 +1,220 @@
 #pragma once
 #include <Arduino.h>
 #include "config.h"
+#include "ApiConnection.h"
 #include "PassingTime.h"
+#include "PassingTimeParser.h"
+#include "RequestBudget.h"
 #include "TokenService.h"
 
 //Librairies
-//ArduinoJson v5.13.4
-#include "ArduinoJson.h"
-#include <ArduinoSort.h>
 #include <ESP8266HTTPClient.h>
-#include <WiFiClientSecureBearSSL.h>
 
 const String endPointPassingTime = HOST + "/OperationMonitoring/3.0/PassingTimeByPoint";
 
-bool sortPassingTimes(PassingTime *a, PassingTime *b){
-  return a->getRawExpectedTime() > b->getRawExpectedTime();
-}
-
-PassingTimeResponse* getPassingTimeResponse(JsonArray& passingTimesArr){
-  int i = 0;
-  static PassingTime *passingTimes[10];
-  for (JsonObject& val : passingTimesArr){
-    passingTimes[i] = new PassingTime(val[F("lineId")].as<String>(), val[F("destination")][F("fr")].as<String>(), val[F("expectedArrivalTime")].as<String>());
-    i++;
-  }
-  sortArray(passingTimes, i, sortPassingTimes);
-  
-  return new PassingTimeResponse(passingTimes, i);
-}
-
-const size_t PASSING_TIME_RESPONSE_CAPACITY = JSON_ARRAY_SIZE(1) + JSON_ARRAY_SIZE(4) + JSON_OBJECT_SIZE(1) + 5*JSON_OBJECT_SIZE(2) + 4*JSON_OBJECT_SIZE(3);
-
-PassingTimeResponse* getPassingTime(HTTPClient * http, BearSSL::WiFiClientSecure * client, String stopId){
-  http->setReuse(true);
-  //client->setFingerprint(FINGERPRINT);
-  client->setInsecure();
-  String url = endPointPassingTime + "/" + stopId;
-  Serial.print(F("[HTTPS] begin: "));
-  Serial.println(url);
-  
-  if (http->begin(*client, url)) {  // HTTP
-      http->addHeader(F("Accept"), F("application/json"));
-      http->addHeader(F("Authorization"), String("Bearer ") + API_TOKEN);
-      Serial.print(F("[HTTPS] GET... "));
-      // start connection and send HTTP header
-      int httpCode = http->GET();
-      if (httpCode > 0) {
-        // HTTP header has been send and Server response header has been handled
-        Serial.print(F("code:"));
-        Serial.println(httpCode);
-        
-        // file found at server
-        if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_MOVED_PERMANENTLY) {
-          DynamicJsonBuffer jsonBuffer(PASSING_TIME_RESPONSE_CAPACITY);
-          JsonObject& root = jsonBuffer.parseObject(http->getString());
-          if(!root.success()){
-            Serial.println(F("Fail to parse object"));  
-            return 0;
-          }
-          JsonArray& passingTimesArr = root[F("points")][0][F("passingTimes")];
-          if(!passingTimesArr.success()){
-            Serial.println(F("Fail to parse passingTimes"));  
-            return 0;
-          }
-          http->end();
-          PassingTimeResponse* response = getPassingTimeResponse(passingTimesArr);
-          jsonBuffer.clear();
-          return response;
+/** Max number of point ids accepted by PassingTimeByPoint in one request */
+#define MAX_STOPS_PER_REQUEST 10
+#define PASSING_TIME_URL_LENGTH 256
+#define PASSING_TIME_HEADERS_LENGTH 128
+
+/** Dispatch the passing times emitted by the parser to the preallocated response of their stop.
+ *  The pointId comes after the passingTimes in the payload, so entries are kept in a scratch response until the point ends.
+ *  A response is only replaced once its point has been fully parsed, the previous one stays in cache until then.
+ */
+class PassingTimeCollector : public PassingTimeListener {
+  const char* const* stopIds = NULL;
+  int numberOfStops = 0;
+  PassingTimeResponse* responses = NULL;
+  PassingTimeResponse pending;
+  bool received[MAX_STOPS_PER_REQUEST];
+
+  public:
+    void begin(const char* const* stopIds, int numberOfStops, PassingTimeResponse* responses){
+      this->stopIds = stopIds;
+      this->numberOfStops = numberOfStops;
+      this->responses = responses;
+      pending.clear();
+      for(int i = 0; i < numberOfStops; i++){
+        received[i] = false;
+      }
+    }
+
+    void onPassingTime(const char* lineId, const char* destination, const char* expectedArrivalTime) override {
+      METRICS_BEGIN(METRIC_SORT);
+      pending.add(lineId, destination, expectedArrivalTime);
+      METRICS_PAUSE(METRIC_SORT);
+    }
+
+    void onPointEnd(const char* pointId) override {
+      for(int i = 0; i < numberOfStops; i++){
+        if(strcmp(stopIds[i], pointId) == 0){
+          responses[i] = pending;
+          responses[i].receivedAt = millis();
+          received[i] = true;
+          break;
+        }
+      }
+      pending.clear();
+    }
+
+    /** Stops absent from a complete payload have no passing time */
+    void clearMissingPoints(){
+      for(int i = 0; i < numberOfStops; i++){
+        if(!received[i]){
+          responses[i].clear();
+          responses[i].receivedAt = millis();
+        }
+      }
+    }
+};
+
+/** Called when a fetch ends with the http code, 0 when no complete response was received */
+typedef void (*PassingTimeCallback)(int httpCode);
+
+/** Fetch the passing times of several stops in the background.
+ *  Stops are requested by batch of MAX_STOPS_PER_REQUEST point ids, one request per batch.
+ *  The body is parsed while it is received, responses[i] is replaced by the passing times of stopIds[i].
+ *  The batches are sent on the kept alive API connection.
+ *  A batch rejected with a 401 is sent again once, after the token has been renewed.
+ *  Each request is accounted in the RequestBudget, which is told the outcome of the fetch.
+ */
+class PassingTimeFetcher : public HttpFetchListener, public TokenListener {
+  ApiConnection* connection;
+  TokenManager* tokenManager;
+  RequestBudget* budget;
+  bool tokenRenewed = false;
+  PassingTimeCollector collector;
+  PassingTimeParser parser;
+  const char* favouriteStopIds[NUMBER_OF_FAVOURITES];
+  const char* const* stopIds = NULL;
+  int numberOfStops = 0;
+  PassingTimeResponse* responses = NULL;
+  int batchStart = 0;
+  int batchSize = 0;
+  PassingTimeCallback callback = NULL;
+  char url[PASSING_TIME_URL_LENGTH];
+  char headers[PASSING_TIME_HEADERS_LENGTH];
+
+  public:
+    PassingTimeFetcher(ApiConnection* connection, TokenManager* tokenManager, RequestBudget* budget) :
+      connection(connection),
+      tokenManager(tokenManager),
+      budget(budget),
+      parser(&collector)
+    {
+    }
+
+    /** Start fetching the given stops. stopIds and responses must stay valid until the callback is called. */
+    bool start(const char* const* stopIds, int numberOfStops, PassingTimeResponse* responses, PassingTimeCallback callback){
+      if(isBusy()){
+        return false;
+      }
+      this->stopIds = stopIds;
+      this->numberOfStops = numberOfStops;
+      this->responses = responses;
+      this->callback = callback;
+      batchStart = 0;
+      tokenRenewed = false;
+      if(!startBatch()){
+        budget->onResult(0, millis());
+        return false;
+      }
+      return true;
+    }
+
+    /** Fetch the passing times of every favourite. responses[i] matches favourites[i]. */
+    bool startFavourites(PassingTimeResponse* responses, PassingTimeCallback callback){
+      for(int i = 0; i < NUMBER_OF_FAVOURITES; i++){
+        favouriteStopIds[i] = favourites[i].stopId;
+      }
+      return start(favouriteStopIds, NUMBER_OF_FAVOURITES, responses, callback);
+    }
+
+    /** A fetch can't be started while the connection is used */
+    bool isBusy(){
+      return connection->isBusy();
+    }
+
+    /** True when the response is one of those of the last fetch started, still true in its callback */
+    bool covers(const PassingTimeResponse* response){
+      return responses != NULL && response >= responses && response < responses + numberOfStops;
+    }
+
+    /** False while the connection is used, the hourly budget is spent or after a failure */
+    bool canStart(){
+      return !isBusy() && budget->canRequest(millis());
+    }
+
+    bool onBody(const uint8_t* data, size_t length) override {
+      METRICS_BEGIN(METRIC_PARSE);
+      for(size_t i = 0; i < length; i++){
+        if(!parser.feed((char)data[i])){
+          Serial.println(F("Fail to parse passingTimes"));
+          METRICS_DISCARD(METRIC_PARSE);
+          return false;
+        }
+      }
+      METRICS_PAUSE(METRIC_PARSE);
+      return true;
+    }
+
+    void onComplete(int httpCode) override {
+      METRICS_RECORD(METRIC_PARSE);
+      METRICS_RECORD(METRIC_SORT);
+      Serial.print(F("[HTTPS] PassingTimeByPoint code:"));
+      Serial.println(httpCode);
+      if(httpCode == HTTP_CODE_UNAUTHORIZED && !tokenRenewed){
+        tokenRenewed = true;
+        if(tokenManager->renew(this)){
+          return;
+        }
+      }
+      if(httpCode == HTTP_CODE_OK){
+        if(!parser.isDone()){
+          Serial.println(F("Truncated passingTimes"));
+          httpCode = 0;
         }else{
-          http->end();
-          return new PassingTimeResponse(httpCode);
+          collector.clearMissingPoints();
+          batchStart += batchSize;
+          if(batchStart < numberOfStops){
+            if(startBatch()){
+              return;
+            }
+            httpCode = 0;
+          }
         }
-      } else {
-        Serial.print(F("[HTTPS] GET... failed, error: "));
-        Serial.println(http->errorToString(httpCode));
-        http->end();
-        return 0;
       }
-  } else {
-    Serial.println(F("[HTTPS] Unable to connect"));
-  }
-  return 0;
-}
+      finish(httpCode);
+    }
+
+    void onTokenRenewed(bool success) override {
+      if(success && startBatch()){
+        return;
+      }
+      finish(HTTP_CODE_UNAUTHORIZED);
+    }
+
+  private:
+    bool startBatch(){
+      batchSize = min(numberOfStops - batchStart, MAX_STOPS_PER_REQUEST);
+      int length = snprintf(url, sizeof(url), "%s/", endPointPassingTime.c_str());
+      for(int i = 0; i < batchSize && length < (int)sizeof(url); i++){
+        length += snprintf(url + length, sizeof(url) - length, i > 0 ? "%%2C%s" : "%s", stopIds[batchStart + i]);
+      }
+      snprintf(headers, sizeof(headers), "Accept: application/json\r\nAuthorization: Bearer %s\r\n", API_TOKEN.c_str());
+      collector.begin(stopIds + batchStart, batchSize, responses + batchStart);
+      parser.reset();
+      Serial.print(F("[HTTPS] begin: "));
+      Serial.println(url);
+      if(length >= (int)sizeof(url) || !connection->start("GET", url, headers, NULL, this)){
+        return false;
+      }
+      budget->onRequestSent(millis());
+      return true;
+    }
+
+    void finish(int httpCode){
+      budget->onResult(httpCode, millis());
+      callback(httpCode);
+    }
+};
@@ -0,0 +1,167 @@
+#pragma once
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "config.h"
+#include "Crc32.h"
+#include "PassingTime.h"
+
+#define SNAPSHOT_PATH "/passing_times.bin"
+#define SNAPSHOT_TEMP_PATH "/passing_times.tmp"
+#define SNAPSHOT_MAGIC 0x54504253 // "SBPT"
+#define SNAPSHOT_VERSION 3
+
+struct SnapshotHeader {
+  uint32_t magic;
+  uint8_t version;
+  uint8_t numberOfResponses;
+  uint8_t recordSize;
+  uint8_t destinationLength;
+  /** CRC of the stop ids of the favourites, a snapshot of other stops is ignored */
+  uint32_t favouritesCrc;
+};
+
+/** Warm start: the passing times of the favourites are kept in LittleFS to be displayed at once after a reset.
+ *  Per response: the number of passing times and destinations and the source, then the destinations and the 12 byte records,
+ *  read and written in place in the preallocated store.
+ *  The file is only rewritten when the passing times changed, and at most every SNAPSHOT_INTERVAL_SEC.
+ */
+class PassingTimeSnapshot {
+  bool mounted = false;
+  /** CRC of the passing times in the file */
+  uint32_t savedCrc = 0;
+
+  public:
+    /** Mount the file system, formatted at the first boot */
+    bool begin(){
+      mounted = LittleFS.begin();
+      if(!mounted){
+        Serial.println(F("[SNAPSHOT] LittleFS can't be mounted"));
+      }
+      return mounted;
+    }
+
+    /** Fill the responses with the snapshot, flagged as such unless they came from the timetable. The passing times before nowEpoch are dropped, unless it is 0.
+     *  Return false when there is no valid snapshot.
+     */
+    bool load(PassingTimeResponse* responses, uint8_t numberOfResponses, uint32_t nowEpoch){
+      savedCrc = computeCrc(responses, numberOfResponses);
+      if(!mounted || !LittleFS.exists(SNAPSHOT_PATH)){
+        return false;
+      }
+      File file = LittleFS.open(SNAPSHOT_PATH, "r");
+      if(!file){
+        return false;
+      }
+      SnapshotHeader header;
+      bool loaded = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) && isCompatible(header, numberOfResponses);
+      for(uint8_t i = 0; loaded && i < numberOfResponses; i++){
+        loaded = readResponse(file, &responses[i]);
+      }
+      file.close();
+      if(!loaded){
+        Serial.println(F("[SNAPSHOT] Invalid snapshot ignored"));
+        for(uint8_t i = 0; i < numberOfResponses; i++){
+          responses[i].clear();
+        }
+        return false;
+      }
+      unsigned long now = millis();
+      for(uint8_t i = 0; i < numberOfResponses; i++){
+        if(nowEpoch != 0){
+          responses[i].removePassed(nowEpoch);
+        }
+        if(responses[i].source != SOURCE_TIMETABLE){
+          responses[i].source = SOURCE_SNAPSHOT;
+        }
+        responses[i].receivedAt = now > 0 ? now : 1;
+      }
+      savedCrc = computeCrc(responses, numberOfResponses);
+      return true;
+    }
+
+    /** Write the responses when they changed since the last snapshot. Return true when the file was written. */
+    bool save(PassingTimeResponse* responses, uint8_t numberOfResponses){
+      uint32_t crc = computeCrc(responses, numberOfResponses);
+      if(!mounted || crc == savedCrc){
+        return false;
+      }
+      // Written aside then renamed: a reset during the write keeps the previous snapshot
+      File file = LittleFS.open(SNAPSHOT_TEMP_PATH, "w");
+      if(!file){
+        return false;
+      }
+      SnapshotHeader header = {SNAPSHOT_MAGIC, SNAPSHOT_VERSION, numberOfResponses, sizeof(PassingTime), DESTINATION_LENGTH, computeFavouritesCrc()};
+      bool written = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+      for(uint8_t i = 0; written && i < numberOfResponses; i++){
+        written = writeResponse(file, &responses[i]);
+      }
+      file.close();
+      if(!written || !LittleFS.rename(SNAPSHOT_TEMP_PATH, SNAPSHOT_PATH)){
+        Serial.println(F("[SNAPSHOT] Write failed"));
+        return false;
+      }
+      savedCrc = crc;
+      Serial.println(F("[SNAPSHOT] Passing times saved"));
+      return true;
+    }
+
+  private:
+    bool isCompatible(const SnapshotHeader& header, uint8_t numberOfResponses){
+      return header.magic == SNAPSHOT_MAGIC && header.version == SNAPSHOT_VERSION && header.numberOfResponses == numberOfResponses
+        && header.recordSize == sizeof(PassingTime) && header.destinationLength == DESTINATION_LENGTH
+        && header.favouritesCrc == computeFavouritesCrc();
+    }
+
+    bool readResponse(File& file, PassingTimeResponse* response){
+      uint8_t counts[3];
+      if(file.read(counts, sizeof(counts)) != sizeof(counts) || counts[0] > MAX_PASSING_TIMES || counts[1] > MAX_PASSING_TIMES
+        || counts[2] > SOURCE_TIMETABLE){
+        return false;
+      }
+      size_t destinationsSize = counts[1] * DESTINATION_LENGTH;
+      size_t passingTimesSize = counts[0] * sizeof(PassingTime);
+      if(file.read((uint8_t*)response->destinations, destinationsSize) != destinationsSize
+        || file.read((uint8_t*)response->passingTimes, passingTimesSize) != passingTimesSize){
+        return false;
+      }
+      response->numberOfResponses = counts[0];
+      response->numberOfDestinations = counts[1];
+      response->source = (PassingTimeSource)counts[2];
+      for(uint8_t i = 0; i < counts[0]; i++){
+        if(response->passingTimes[i].getDestinationIndex() >= counts[1]){
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool writeResponse(File& file, PassingTimeResponse* response){
+      uint8_t counts[3] = {(uint8_t)response->numberOfResponses, response->numberOfDestinations, (uint8_t)response->source};
+      size_t destinationsSize = counts[1] * DESTINATION_LENGTH;
+      size_t passingTimesSize = counts[0] * sizeof(PassingTime);
+      return file.write(counts, sizeof(counts)) == sizeof(counts)
+        && file.write((const uint8_t*)response->destinations, destinationsSize) == destinationsSize
+        && file.write((const uint8_t*)response->passingTimes, passingTimesSize) == passingTimesSize;
+    }
+
+    /** CRC of what would be written, the reception times excluded */
+    uint32_t computeCrc(PassingTimeResponse* responses, uint8_t numberOfResponses){
+      uint32_t crc = CRC32_INIT;
+      for(uint8_t i = 0; i < numberOfResponses; i++){
+        PassingTimeResponse* response = &responses[i];
+        uint8_t counts[3] = {(uint8_t)response->numberOfResponses, response->numberOfDestinations, (uint8_t)response->source};
+        crc = updateCrc32(crc, counts, sizeof(counts));
+        crc = updateCrc32(crc, response->destinations, counts[1] * DESTINATION_LENGTH);
+        crc = updateCrc32(crc, response->passingTimes, counts[0] * sizeof(PassingTime));
+      }
+      return ~crc;
+    }
+
+    uint32_t computeFavouritesCrc(){
+      uint32_t crc = CRC32_INIT;
+      for(int i = 0; i < NUMBER_OF_FAVOURITES; i++){
+        crc = updateCrc32(crc, favourites[i].stopId, strlen(favourites[i].stopId) + 1);
+      }
+      return ~crc;
+    }
+};
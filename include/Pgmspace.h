@@ -0,0 +1,18 @@
+#pragma once
+/** Access to the constant tables stored in flash.
+ *  On the ESP8266 they come from the Arduino core. Off-device (ARDUINO not defined) flash is plain memory,
+ *  so the pure modules (parsers, stop index, PassingTime) can be compiled and measured on a host.
+ */
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#include <string.h>
+#define PROGMEM
+#define PGM_P const char*
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define memcpy_P memcpy
+#define strncpy_P strncpy
+#define strncmp_P strncmp
+#endif
@@ -0,0 +1,166 @@
+#pragma once
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <sys/time.h>
+#include "config.h"
+
+extern "C" {
+#include "user_interface.h"
+#include "gpio.h"
+/** OS timers of the SDK */
+extern os_timer_t* timer_list;
+}
+
+/** Power saving of the device.
+ *  - the radio uses modem sleep: it is turned off between the DTIM beacons, the connection is kept
+ *  - after POWER_IDLE_SEC without any button pushed, the CPU enters forced light sleep with the radio off
+ *    until a button pulls its GPIO high. Deep sleep would only wake through RST, which the buttons aren't wired to.
+ *  - the supply voltage (ESP.getVcc, needs ADC_MODE(ADC_VCC)) is sampled every POWER_VCC_SAMPLE_SEC
+ *  - the energy used is estimated from the time spent in each state and the typical current of the ESP8266
+ */
+class PowerManager {
+  const uint8_t* wakeUpPins;
+  uint8_t numberOfWakeUpPins;
+  unsigned long lastActivity = 0;
+  unsigned long lastVccSample = 0;
+  /** Averaged supply voltage in mV */
+  uint16_t vcc = 0;
+  /** Charge used since boot, in mA.ms */
+  uint64_t usedCharge = 0;
+  unsigned long accountedUntil = 0;
+  unsigned long sleptMs = 0;
+  unsigned long lastRequestEnergyMicroJoules = 0;
+
+  public:
+    PowerManager(const uint8_t* wakeUpPins, uint8_t numberOfWakeUpPins) :
+      wakeUpPins(wakeUpPins),
+      numberOfWakeUpPins(numberOfWakeUpPins)
+    {
+    }
+
+    void begin(){
+      WiFi.setSleepMode(WIFI_MODEM_SLEEP);
+      lastActivity = millis();
+      accountedUntil = lastActivity;
+      sampleVoltage();
+    }
+
+    /** A button has been pushed */
+    void notifyActivity(){
+      lastActivity = millis();
+    }
+
+    bool isIdle(){
+      return millis() - lastActivity >= POWER_IDLE_SEC * 1000UL;
+    }
+
+    /** Sample the voltage periodically. To be called on every loop() pass. */
+    void poll(){
+      unsigned long now = millis();
+      if(now - lastVccSample >= POWER_VCC_SAMPLE_SEC * 1000UL){
+        sampleVoltage();
+      }
+    }
+
+    uint16_t getVcc(){
+      return vcc;
+    }
+
+    bool isVoltageLow(){
+      return vcc > 0 && vcc < LOW_VOLTAGE_MV;
+    }
+
+    /** Account a request, the radio being fully on during its duration */
+    void onRequestDone(unsigned long requestMs){
+      accountAwakeTime();
+      uint64_t extraCharge = (uint64_t)requestMs * (POWER_RADIO_ACTIVE_MA - POWER_MODEM_SLEEP_MA);
+      usedCharge += extraCharge;
+      // mA.ms * mV = nJ
+      lastRequestEnergyMicroJoules = (unsigned long)((uint64_t)requestMs * POWER_RADIO_ACTIVE_MA * supplyVoltage() / 1000);
+    }
+
+    /** Turn the radio off and sleep until a button is pushed. RAM is kept, the system time is corrected.
+     *  The interrupts of the wake up pins are detached, see ButtonInput::attach().
+     *  WiFi reconnects in the background, with the channel and BSSID of the previous connection.
+     *  Return the time slept in ms.
+     */
+    unsigned long sleepUntilButtonPushed(){
+      accountAwakeTime();
+      int32_t channel = WiFi.channel();
+      uint8_t bssid[6];
+      memcpy(bssid, WiFi.BSSID(), sizeof(bssid));
+      Serial.println(F("[POWER] Idle, light sleep until a button is pushed"));
+      Serial.flush();
+
+      WiFi.mode(WIFI_OFF);
+      uint32_t rtcBefore = system_get_rtc_time();
+      uint32_t rtcPeriod = system_rtc_clock_cali_proc();
+      // Without pending OS timers the sleep lasts until the GPIO wakes the CPU up
+      timer_list = NULL;
+      wifi_fpm_set_sleep_type(LIGHT_SLEEP_T);
+      for(uint8_t i = 0; i < numberOfWakeUpPins; i++){
+        gpio_pin_wakeup_enable(GPIO_ID_PIN(wakeUpPins[i]), GPIO_PIN_INTR_HILEVEL);
+      }
+      wifi_fpm_open();
+      wifi_fpm_do_sleep(0xFFFFFFF);
+      delay(10);
+      // Woken up by a button
+      wifi_fpm_close();
+      // The wake up pins are left with a level interrupt: disabled, the caller attaches its handlers again
+      gpio_pin_wakeup_disable();
+      // The RTC period is in us << 12
+      uint64_t sleptUs = ((uint64_t)(system_get_rtc_time() - rtcBefore) * rtcPeriod) >> 12;
+      unsigned long slept = (unsigned long)(sleptUs / 1000);
+      struct timeval now;
+      gettimeofday(&now, NULL);
+      now.tv_sec += sleptUs / 1000000;
+      settimeofday(&now, NULL);
+
+      WiFi.mode(WIFI_STA);
+      WiFi.begin(WIFI_SSID, WIFI_PASSWORD, channel, bssid);
+      WiFi.setSleepMode(WIFI_MODEM_SLEEP);
+      sleptMs += slept;
+      usedCharge += (uint64_t)slept * POWER_LIGHT_SLEEP_MA;
+      lastActivity = millis();
+      accountedUntil = lastActivity;
+      Serial.print(F("[POWER] Woken up after (ms): "));
+      Serial.println(slept);
+      return slept;
+    }
+
+    void printEnergy(){
+      accountAwakeTime();
+      unsigned long elapsed = millis() + sleptMs;
+      Serial.print(F("[POWER] Vcc (mV):"));
+      Serial.print(vcc);
+      Serial.print(F(" last request (mJ):"));
+      Serial.print(lastRequestEnergyMicroJoules / 1000.0);
+      Serial.print(F(" used (mAh):"));
+      Serial.print((double)usedCharge / 3600000.0);
+      Serial.print(F(" average (mA):"));
+      Serial.println(elapsed > 0 ? (double)usedCharge / elapsed : 0.0);
+    }
+
+  private:
+    uint16_t supplyVoltage(){
+      return vcc > 0 ? vcc : 3300;
+    }
+
+    /** Awake time since the last accounting, radio in modem sleep */
+    void accountAwakeTime(){
+      unsigned long now = millis();
+      usedCharge += (uint64_t)(now - accountedUntil) * POWER_MODEM_SLEEP_MA;
+      accountedUntil = now;
+    }
+
+    void sampleVoltage(){
+      lastVccSample = millis();
+      uint16_t sample = ESP.getVcc();
+      // Smooth the ADC noise
+      vcc = vcc == 0 ? sample : (vcc * 3 + sample) / 4;
+      if(isVoltageLow()){
+        Serial.print(F("[POWER] Low voltage (mV): "));
+        Serial.println(vcc);
+      }
+    }
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+/** Rate limit of the requests sent to the STIB-MIVB API, shared by every stop and every fetch of the device.
+ *  - the key allows API_HOURLY_BUDGET requests per hour, split between the API_KEY_DEVICES displays using it.
+ *    Requests are spaced by the resulting interval, up to API_BURST of them can be sent at once after an idle period
+ *    (generic cell rate algorithm: a single theoretical arrival time, no history is kept)
+ *  - after a 429, a 5xx or a transient failure, nothing is sent before an exponential backoff from BACKOFF_BASE_SEC
+ *    to BACKOFF_MAX_SEC, with jitter so that the displays don't retry together. The first success resets it.
+ *  Times are millis() values given by the caller.
+ */
+class RequestBudget {
+  unsigned long intervalMs;
+  /** Theoretical time of the next request when they are evenly spaced */
+  unsigned long theoreticalAt = 0;
+  bool started = false;
+  unsigned long retryAt = 0;
+  uint8_t failures = 0;
+  uint32_t randomState = 1;
+  unsigned long hourStartedAt = 0;
+  unsigned long requestsThisHour = 0;
+  unsigned long requestsLastHour = 0;
+
+  public:
+    /** requestsPerHour: the share of the key of this display. The burst is taken out of it, so that no hour
+     *  holds more than requestsPerHour requests, the burst included.
+     */
+    RequestBudget(unsigned long requestsPerHour = API_HOURLY_BUDGET / API_KEY_DEVICES) :
+      intervalMs(3600000UL / (requestsPerHour > API_BURST ? requestsPerHour - API_BURST : 1))
+    {
+    }
+
+    /** Seed of the jitter, which should differ between the displays */
+    void seed(uint32_t seed){
+      randomState = seed != 0 ? seed : 1;
+    }
+
+    /** True when a request can be sent now */
+    bool canRequest(unsigned long now){
+      if(failures > 0 && (long)(now - retryAt) < 0){
+        return false;
+      }
+      return !started || (long)(theoreticalAt - now) <= (long)((API_BURST - 1) * intervalMs);
+    }
+
+    /** Time (in ms) before canRequest() is true */
+    unsigned long getWaitMs(unsigned long now){
+      long wait = 0;
+      if(failures > 0){
+        wait = (long)(retryAt - now);
+      }
+      if(started){
+        wait = max(wait, (long)(theoreticalAt - now) - (long)((API_BURST - 1) * intervalMs));
+      }
+      return wait > 0 ? wait : 0;
+    }
+
+    /** Account a request sent to the API */
+    void onRequestSent(unsigned long now){
+      if(!started || (long)(theoreticalAt - now) < 0){
+        theoreticalAt = now;
+      }
+      theoreticalAt += intervalMs;
+      started = true;
+      if(now - hourStartedAt >= 3600000UL){
+        requestsLastHour = requestsThisHour;
+        requestsThisHour = 0;
+        hourStartedAt = now;
+      }
+      requestsThisHour++;
+    }
+
+    /** Account the outcome of a fetch: the http code, 0 when no complete response was received */
+    void onResult(int httpCode, unsigned long now){
+      if(!isTransientFailure(httpCode)){
+        // A success, or an answer which won't change by waiting (401, 404...): the API is reachable
+        failures = 0;
+        return;
+      }
+      if(failures < 16){
+        failures++;
+      }
+      // Equal jitter: between half and the whole of the exponential delay
+      unsigned long delayMs = BACKOFF_BASE_SEC * 1000UL << min((int)failures - 1, 10);
+      delayMs = min(delayMs, BACKOFF_MAX_SEC * 1000UL);
+      delayMs = delayMs / 2 + nextRandom() % (delayMs / 2 + 1);
+      retryAt = now + delayMs;
+      Serial.print(F("[BUDGET] Failure "));
+      Serial.print(failures);
+      Serial.print(F(", next request in (ms): "));
+      Serial.println(delayMs);
+    }
+
+    /** Worth a backoff: no complete response (0, or a negative code of the client), 429 and 5xx */
+    static bool isTransientFailure(int httpCode){
+      return httpCode <= 0 || httpCode == 429 || httpCode >= 500;
+    }
+
+    bool isBackingOff(){
+      return failures > 0;
+    }
+
+    void printStats(){
+      Serial.print(F("[BUDGET] requests this hour:"));
+      Serial.print(requestsThisHour);
+      Serial.print(F(" last hour:"));
+      Serial.print(requestsLastHour);
+      Serial.print(F(" interval (ms):"));
+      Serial.print(intervalMs);
+      Serial.print(F(" failures:"));
+      Serial.println(failures);
+    }
+
+  private:
+    uint32_t nextRandom(){
+      // xorshift32
+      randomState ^= randomState << 13;
+      randomState ^= randomState >> 17;
+      randomState ^= randomState << 5;
+      return randomState;
+    }
+};
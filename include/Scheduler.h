@@ -0,0 +1,148 @@
+#pragma once
+#include <Arduino.h>
+#include "config.h"
+
+#define MAX_TASKS 12
+
+typedef void (*TaskCallback)();
+
+/** Unit of work of the Scheduler. A task must return quickly and keep its progress in its own state. */
+class Task {
+  friend class Scheduler;
+
+  const char* name;
+  TaskCallback callback;
+  unsigned long intervalMs = 0;
+  unsigned long nextRunAt = 0;
+  bool enabled = false;
+  bool periodic = false;
+  unsigned long runs = 0;
+  unsigned long maxRunUs = 0;
+  unsigned long overruns = 0;
+
+  public:
+    Task(const char* name, TaskCallback callback) :
+      name(name),
+      callback(callback)
+    {
+    }
+
+    /** Run the task every intervalMs, the first time at once. 0 runs it on every pass. */
+    void every(unsigned long intervalMs){
+      this->intervalMs = intervalMs;
+      periodic = true;
+      nextRunAt = millis();
+      enabled = true;
+    }
+
+    /** Run the task once, in delayMs */
+    void runIn(unsigned long delayMs){
+      periodic = false;
+      nextRunAt = millis() + delayMs;
+      enabled = true;
+    }
+
+    void disable(){
+      enabled = false;
+    }
+
+    bool isEnabled(){
+      return enabled;
+    }
+
+    const char* getName(){
+      return name;
+    }
+
+    unsigned long getMaxRunUs(){
+      return maxRunUs;
+    }
+
+    unsigned long getOverruns(){
+      return overruns;
+    }
+
+    unsigned long getRuns(){
+      return runs;
+    }
+};
+
+/** Cooperative scheduler: loop() only calls run(), which runs the tasks which are due, one after the other.
+ *  Nothing is preempted, a task holding the CPU delays all the others: their run time is measured against TASK_BUDGET_MS.
+ */
+class Scheduler {
+  Task* tasks[MAX_TASKS];
+  uint8_t numberOfTasks = 0;
+
+  public:
+    bool add(Task* task){
+      if(numberOfTasks == MAX_TASKS){
+        return false;
+      }
+      tasks[numberOfTasks++] = task;
+      return true;
+    }
+
+    void run(){
+      for(uint8_t i = 0; i < numberOfTasks; i++){
+        Task* task = tasks[i];
+        if(!task->enabled || (long)(millis() - task->nextRunAt) < 0){
+          continue;
+        }
+        if(task->periodic){
+          // Without catching up the missed runs
+          task->nextRunAt += task->intervalMs;
+          if((long)(millis() - task->nextRunAt) > 0){
+            task->nextRunAt = millis() + task->intervalMs;
+          }
+        }else{
+          task->enabled = false;
+        }
+        unsigned long start = micros();
+        task->callback();
+        unsigned long duration = micros() - start;
+        task->runs++;
+        if(duration > task->maxRunUs){
+          task->maxRunUs = duration;
+        }
+        if(duration > TASK_BUDGET_MS * 1000UL){
+          task->overruns++;
+          Serial.print(F("[TASK] "));
+          Serial.print(task->name);
+          Serial.print(F(" held the CPU (ms): "));
+          Serial.println(duration / 1000);
+        }
+        yield();
+      }
+    }
+
+    uint8_t getNumberOfTasks(){
+      return numberOfTasks;
+    }
+
+    Task* getTask(uint8_t index){
+      return tasks[index];
+    }
+
+    /** Measure from now on, e.g. once booted */
+    void resetStats(){
+      for(uint8_t i = 0; i < numberOfTasks; i++){
+        tasks[i]->runs = 0;
+        tasks[i]->maxRunUs = 0;
+        tasks[i]->overruns = 0;
+      }
+    }
+
+    void printStats(){
+      for(uint8_t i = 0; i < numberOfTasks; i++){
+        Serial.print(F("[TASK] "));
+        Serial.print(tasks[i]->name);
+        Serial.print(F(" runs:"));
+        Serial.print(tasks[i]->runs);
+        Serial.print(F(" max us:"));
+        Serial.print(tasks[i]->maxRunUs);
+        Serial.print(F(" overruns:"));
+        Serial.println(tasks[i]->overruns);
+      }
+    }
+};
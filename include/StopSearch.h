@@ -0,0 +1,76 @@
+#pragma once
+#include "Pgmspace.h"
+// Generated from stops.txt at build time by tools/generate_stop_index.py
+#include "StopIndex.h"
+
+/** Lookup in the stop index compiled in flash. Nothing is copied to RAM except the entry being compared.
+ *  - stop index: position in STOP_ENTRIES, sorted by stop id
+ *  - name position: position in STOPS_BY_NAME, sorted by name
+ */
+
+StopEntry readStopEntry(int stopIndex){
+  StopEntry entry;
+  memcpy_P(&entry, &STOP_ENTRIES[stopIndex], sizeof(StopEntry));
+  return entry;
+}
+
+PGM_P getStopNameByNameIndex(uint16_t nameIndex){
+  return STOP_NAMES + pgm_read_word(&STOP_NAME_OFFSETS[nameIndex]);
+}
+
+/** Binary search by stop_id. Return the stop index or -1 when unknown */
+int findStopById(const char* stopId){
+  int low = 0;
+  int high = STOP_COUNT - 1;
+  while(low <= high){
+    int middle = (low + high) / 2;
+    StopEntry entry = readStopEntry(middle);
+    int comparison = strncmp(entry.id, stopId, STOP_ID_LENGTH);
+    if(comparison == 0){
+      return middle;
+    }else if(comparison < 0){
+      low = middle + 1;
+    }else{
+      high = middle - 1;
+    }
+  }
+  return -1;
+}
+
+int getStopIndexAtNamePosition(int namePosition){
+  return pgm_read_word(&STOPS_BY_NAME[namePosition]);
+}
+
+/** Copy the stop id in the buffer (at least STOP_ID_LENGTH long) */
+void getStopId(int stopIndex, char* buffer){
+  StopEntry entry = readStopEntry(stopIndex);
+  memcpy(buffer, entry.id, STOP_ID_LENGTH);
+}
+
+void getStopName(int stopIndex, char* buffer, size_t size){
+  strncpy_P(buffer, getStopNameByNameIndex(readStopEntry(stopIndex).nameIndex), size - 1);
+  buffer[size - 1] = '\0';
+}
+
+/** Binary search of the first stop, by name, whose name starts with the prefix.
+ *  Return its name position or -1 when no name matches.
+ */
+int findFirstStopByNamePrefix(const char* prefix){
+  size_t prefixLength = strlen(prefix);
+  int low = 0;
+  int high = STOP_COUNT;
+  while(low < high){
+    int middle = (low + high) / 2;
+    PGM_P name = getStopNameByNameIndex(readStopEntry(getStopIndexAtNamePosition(middle)).nameIndex);
+    if(strncmp_P(prefix, name, prefixLength) > 0){
+      low = middle + 1;
+    }else{
+      high = middle;
+    }
+  }
+  if(low == STOP_COUNT){
+    return -1;
+  }
+  PGM_P name = getStopNameByNameIndex(readStopEntry(getStopIndexAtNamePosition(low)).nameIndex);
+  return strncmp_P(prefix, name, prefixLength) == 0 ? low : -1;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+
+/** Epochs before 2000-01-01: the clock has not been set yet */
+#define MIN_VALID_EPOCH 946684800UL
+
+/** Wall clock of the app. The epoch of the system clock is anchored on millis() at each synchronisation (NTP,
+ *  boot cache, wake up), then "now" is an addition: no localtime() nor DST rules on each render.
+ *  The UTC offset is the one of the anchor, it is only used to compute local times (timetable, hub), the remaining
+ *  times are differences of epochs. Times are millis() values given by the caller.
+ */
+class TimeService {
+  uint32_t anchorEpoch = 0;
+  unsigned long anchorMs = 0;
+  long utcOffset = 0;
+
+  public:
+    /** Anchor the epoch (UTC) read at nowMs, ignored when the clock is not set */
+    void anchor(uint32_t epoch, long utcOffset, unsigned long nowMs){
+      if(epoch < MIN_VALID_EPOCH){
+        return;
+      }
+      anchorEpoch = epoch;
+      anchorMs = nowMs;
+      this->utcOffset = utcOffset;
+    }
+
+    bool isSet(){
+      return anchorEpoch != 0;
+    }
+
+    /** Seconds since 1970-01-01 UTC, 0 until the first anchor. Valid for 49 days of millis() after the anchor. */
+    uint32_t now(unsigned long nowMs){
+      if(anchorEpoch == 0){
+        return 0;
+      }
+      // 32 bits like millis() of the ESP8266, also on a 64 bits host
+      return anchorEpoch + (uint32_t)(nowMs - anchorMs) / 1000;
+    }
+
+    /** Offset of the local time at the last anchor, 3600 for CET */
+    long getUtcOffset(){
+      return utcOffset;
+    }
+};
@@ -0,0 +1,133 @@
+#pragma once
+#include "Pgmspace.h"
+#include "PassingTime.h"
+// Generated from the GTFS feed at build time by tools/generate_timetable.py, the tests give their fixture
+#ifdef TIMETABLE_DATA
+#include TIMETABLE_DATA
+#else
+#include "TimetableData.h"
+#endif
+
+#define SECONDS_PER_DAY 86400UL
+/** Service days scanned by a lookup: yesterday (its trips after midnight), today and tomorrow */
+#define TIMETABLE_SERVICE_DAYS 3
+
+/** Offline fallback: the scheduled departures of the favourites, compiled in flash from the GTFS feed.
+ *  Nothing is copied to RAM except the records being compared. The minutes of a service day are local times,
+ *  the UTC offset of the lookup is applied to the whole day.
+ */
+
+TimetableDeparture readTimetableDeparture(uint16_t index){
+  TimetableDeparture departure;
+  memcpy_P(&departure, &TIMETABLE_DEPARTURES[index], sizeof(TimetableDeparture));
+  return departure;
+}
+
+/** Position of the stop in TIMETABLE_STOPS, -1 when it has no timetable */
+int findTimetableStop(const char* stopId){
+  for(int i = 0; i < TIMETABLE_STOP_COUNT; i++){
+    char id[TIMETABLE_STOP_ID_LENGTH];
+    memcpy_P(id, TIMETABLE_STOPS[i].id, TIMETABLE_STOP_ID_LENGTH);
+    if(strncmp(id, stopId, TIMETABLE_STOP_ID_LENGTH) == 0){
+      return i;
+    }
+  }
+  return -1;
+}
+
+/** True when the service runs on the day (days since 1970-01-01): calendar_dates.txt first, then calendar.txt */
+bool isServiceRunning(uint8_t service, uint16_t day){
+  // Binary search of the first exception of the day
+  int low = 0;
+  int high = TIMETABLE_EXCEPTION_COUNT;
+  while(low < high){
+    int middle = (low + high) / 2;
+    if(pgm_read_word(&TIMETABLE_EXCEPTIONS[middle].day) < day){
+      low = middle + 1;
+    }else{
+      high = middle;
+    }
+  }
+  for(int i = low; i < TIMETABLE_EXCEPTION_COUNT && pgm_read_word(&TIMETABLE_EXCEPTIONS[i].day) == day; i++){
+    if(pgm_read_byte(&TIMETABLE_EXCEPTIONS[i].service) == service){
+      return pgm_read_byte(&TIMETABLE_EXCEPTIONS[i].added) != 0;
+    }
+  }
+  TimetableService entry;
+  memcpy_P(&entry, &TIMETABLE_SERVICES[service], sizeof(TimetableService));
+  // 1970-01-01 was a thursday, the weekdays start on monday
+  uint8_t weekday = (day + 3) % 7;
+  return day >= entry.startDay && day <= entry.endDay && (entry.weekdays & (1 << weekday)) != 0;
+}
+
+/** Binary search of the first departure of the slice at or after the minute */
+uint16_t findFirstDeparture(uint16_t first, uint16_t end, long minute){
+  while(first < end){
+    uint16_t middle = first + (end - first) / 2;
+    if(pgm_read_word(&TIMETABLE_DEPARTURES[middle].minute) < minute){
+      first = middle + 1;
+    }else{
+      end = middle;
+    }
+  }
+  return first;
+}
+
+/** Fill the response with the next scheduled departures of the stop from nowEpoch, flagged SOURCE_TIMETABLE.
+ *  Return the number of passing times, 0 when the stop has no timetable or nothing runs in the next day: the
+ *  response is then left as it was, with the passing times it may still have.
+ */
+int findScheduledPassingTimes(const char* stopId, uint32_t nowEpoch, long utcOffset, PassingTimeResponse* response){
+  int stop = findTimetableStop(stopId);
+  if(stop < 0){
+    return 0;
+  }
+  // Filled aside, not on the stack of the loop
+  static PassingTimeResponse scheduled;
+  scheduled.clear();
+  scheduled.source = SOURCE_TIMETABLE;
+  uint16_t first = pgm_read_word(&TIMETABLE_STOPS[stop].firstDeparture);
+  uint16_t end = first + pgm_read_word(&TIMETABLE_STOPS[stop].numberOfDepartures);
+  long localNow = (long)nowEpoch + utcOffset;
+  uint16_t today = localNow / SECONDS_PER_DAY;
+  long minuteOfToday = (localNow % SECONDS_PER_DAY) / 60;
+  // One cursor per service day, merged by time. The minutes of a service day continue after 24:00.
+  uint16_t cursors[TIMETABLE_SERVICE_DAYS];
+  for(int d = 0; d < TIMETABLE_SERVICE_DAYS; d++){
+    cursors[d] = findFirstDeparture(first, end, minuteOfToday + (1 - d) * 1440L);
+  }
+  char line[LINE_ID_LENGTH];
+  char destination[DESTINATION_LENGTH];
+  while(scheduled.numberOfResponses < MAX_PASSING_TIMES){
+    int next = -1;
+    long nextMinute = 0;
+    for(int d = 0; d < TIMETABLE_SERVICE_DAYS; d++){
+      if(cursors[d] == end){
+        continue;
+      }
+      // Minute relative to the beginning of today
+      long minute = (long)pgm_read_word(&TIMETABLE_DEPARTURES[cursors[d]].minute) - (1 - d) * 1440L;
+      if(next < 0 || minute < nextMinute){
+        next = d;
+        nextMinute = minute;
+      }
+    }
+    if(next < 0 || nextMinute >= minuteOfToday + 1440){
+      break;
+    }
+    TimetableDeparture departure = readTimetableDeparture(cursors[next]++);
+    if(!isServiceRunning(departure.service, today - 1 + next)){
+      continue;
+    }
+    memcpy_P(line, TIMETABLE_PATTERNS[departure.pattern].line, LINE_ID_LENGTH);
+    line[LINE_ID_LENGTH - 1] = '\0';
+    strncpy_P(destination, TIMETABLE_DESTINATIONS + pgm_read_word(&TIMETABLE_PATTERNS[departure.pattern].destinationOffset), DESTINATION_LENGTH - 1);
+    destination[DESTINATION_LENGTH - 1] = '\0';
+    uint32_t epoch = (uint32_t)today * SECONDS_PER_DAY + nextMinute * 60 - utcOffset;
+    scheduled.add(line, destination, epoch, utcOffset);
+  }
+  if(scheduled.numberOfResponses > 0){
+    *response = scheduled;
+  }
+  return scheduled.numberOfResponses;
+}
@@ -8,7 +8,7 @@
 //ArduinoJson v5.13.4
 #include "ArduinoJson.h"
 #include <ESP8266HTTPClient.h>
-#include <WiFiClientSecureBearSSL.h>
+#include "ApiConnection.h"
 
 #define IS_TOKEN_INITIALIZED_ADDR 0
 #define TOKEN_START_ADDR 1
@@ -22,8 +22,9 @@ String readToken(){
     // If Api token has been stored
     if((char)EEPROM.read(IS_TOKEN_INITIALIZED_ADDR) == 'Y'){
       Serial.println("Token exists in EEPROM, reading it...");
-      char token[TOKEN_LENGTH];
+      char token[TOKEN_LENGTH + 1];
       EEPROM.get(TOKEN_START_ADDR, token);
+      token[TOKEN_LENGTH] = '\0';
       Serial.println("Token read from EEPROM: " + String(token));
       return String(token);
     } else {
@@ -37,8 +38,7 @@ void initializeToken(){
 }
 
 void initializeEeprom(){
-    EEPROM.begin(512); 
-    delay(10);    
+    EEPROM.begin(512);
 }
 
 void resetTokenFromEeprom(){
@@ -46,53 +46,171 @@ void resetTokenFromEeprom(){
   EEPROM.commit();  
 }
 
+/** True when the token stored in EEPROM is the given one */
+bool isTokenStored(const char* token){
+  if((char)EEPROM.read(IS_TOKEN_INITIALIZED_ADDR) != 'Y'){
+    return false;
+  }
+  for(int i = 0; i<TOKEN_LENGTH; i++){
+    if((char)EEPROM.read(TOKEN_START_ADDR+i) != token[i]){
+      return false;
+    }
+    if(token[i] == '\0'){
+      break;
+    }
+  }
+  return true;
+}
+
+/** Store the token, the flash sector is only erased/written when the token changed */
 void writeToken(String token){
-  EEPROM.begin(512); delay(10);
-  Serial.println("Writing token <" + token + "> to EEPROM");
   const char * tokenChar = token.c_str();
+  if(isTokenStored(tokenChar)){
+    Serial.println(F("Token unchanged, EEPROM not written"));
+    return;
+  }
+  Serial.println("Writing token <" + token + "> to EEPROM");
   for(int i = 0; i<TOKEN_LENGTH; i++){
-    EEPROM.write(TOKEN_START_ADDR+i, tokenChar[i]);  
-  }  
+    EEPROM.write(TOKEN_START_ADDR+i, tokenChar[i]);
+    if(tokenChar[i] == '\0'){
+      break;
+    }
+  }
   EEPROM.put(IS_TOKEN_INITIALIZED_ADDR, 'Y');
   EEPROM.commit();  
   Serial.println("Token written to EEPROM");
 }
 
 const size_t TOKEN_RESPONSE_CAPACITY = JSON_OBJECT_SIZE(4);
-String getNewToken(HTTPClient * http, BearSSL::WiFiClientSecure * client){
-  Serial.println(F("Retrieve new OAuth2 API token"));
-  client->setFingerprint(FINGERPRINT);
-  Serial.print(F("[HTTPS] begin: "));
-  Serial.println(endPointToken);
-  if (http->begin(*client, endPointToken)) {  // HTTP
-    http->addHeader(F("Accept"), F("application/json"));
-    http->addHeader(F("Authorization"), String("Basic ") + API_BASIC_AUTH);
-    Serial.print(F("[HTTPS] GET... "));
-    // start connection and send HTTP header
-    int httpCode = http->POST("grant_type=client_credentials");
-    if (httpCode > 0) {
-      // HTTP header has been send and Server response header has been handled
-      Serial.print(F("code:"));
+/** The token response is a small object, it is kept in this buffer to be parsed in place */
+#define TOKEN_RESPONSE_LENGTH 256
+#define TOKEN_HEADERS_LENGTH 192
+
+/** Notified when a token renewal requested by the listener ends */
+class TokenListener {
+  public:
+    virtual ~TokenListener() {}
+    virtual void onTokenRenewed(bool success) = 0;
+};
+
+/** Lifecycle of the OAuth2 token.
+ *  The expires_in of the token response is tracked and the token is renewed in the background
+ *  TOKEN_REFRESH_MARGIN_SEC before it expires, when the API connection is idle.
+ *  The expiry of the token read from EEPROM at boot is unknown, it is renewed on the first 401.
+ */
+class TokenManager : public HttpFetchListener {
+  ApiConnection* connection;
+  TokenListener* listener = NULL;
+  bool renewing = false;
+  /** millis() when the current token was received, its lifetime in ms, 0 when unknown */
+  unsigned long receivedAt = 0;
+  unsigned long lifetimeMs = 0;
+  unsigned long lastFailureAt = 0;
+  bool failed = false;
+  char body[TOKEN_RESPONSE_LENGTH];
+  size_t length = 0;
+  char headers[TOKEN_HEADERS_LENGTH];
+
+  public:
+    TokenManager(ApiConnection* connection) :
+      connection(connection)
+    {
+    }
+
+    /** Start renewing the token. The listener, if any, is notified at the end.
+     *  Return false when the connection is busy.
+     */
+    bool renew(TokenListener* listener){
+      if(connection->isBusy()){
+        return false;
+      }
+      Serial.println(F("Retrieve new OAuth2 API token"));
+      Serial.print(F("[HTTPS] begin: "));
+      Serial.println(endPointToken);
+      this->listener = listener;
+      length = 0;
+      snprintf(headers, sizeof(headers), "Accept: application/json\r\nContent-Type: application/x-www-form-urlencoded\r\nAuthorization: Basic %s\r\n",
+        API_BASIC_AUTH.c_str());
+      renewing = connection->start("POST", endPointToken.c_str(), headers, "grant_type=client_credentials", this);
+      return renewing;
+    }
+
+    bool isRenewing(){
+      return renewing;
+    }
+
+    /** True when the token expires within TOKEN_REFRESH_MARGIN_SEC */
+    bool isExpiringSoon(unsigned long now){
+      if(lifetimeMs == 0){
+        return false;
+      }
+      // Short lived tokens are renewed at half of their life
+      unsigned long marginMs = TOKEN_REFRESH_MARGIN_SEC * 1000UL;
+      if(marginMs > lifetimeMs / 2){
+        marginMs = lifetimeMs / 2;
+      }
+      return now - receivedAt + marginMs >= lifetimeMs;
+    }
+
+    /** Renew the token ahead of its expiry when the connection is idle. To be called on every loop() pass. */
+    void poll(){
+      unsigned long now = millis();
+      if(renewing || connection->isBusy() || !isExpiringSoon(now)){
+        return;
+      }
+      if(failed && now - lastFailureAt < TOKEN_RETRY_DELAY_SEC * 1000UL){
+        return;
+      }
+      renew(NULL);
+    }
+
+    bool onBody(const uint8_t* data, size_t size) override {
+      if(length + size >= TOKEN_RESPONSE_LENGTH){
+        Serial.println(F("Token response too long"));
+        return false;
+      }
+      memcpy(body + length, data, size);
+      length += size;
+      return true;
+    }
+
+    void onComplete(int httpCode) override {
+      Serial.print(F("[HTTPS] POST token code:"));
       Serial.println(httpCode);
+      body[length] = '\0';
+      renewing = false;
+      bool success = httpCode == HTTP_CODE_OK && readTokenResponse();
+      failed = !success;
+      if(failed){
+        lastFailureAt = millis();
+      }
+      if(listener != NULL){
+        TokenListener* notified = listener;
+        listener = NULL;
+        notified->onTokenRenewed(success);
+      }
+    }
+
+  private:
+    /** {"access_token":"..","token_type":"Bearer","expires_in":3600} */
+    bool readTokenResponse(){
       DynamicJsonBuffer jsonBuffer(TOKEN_RESPONSE_CAPACITY);
-      JsonObject& root = jsonBuffer.parseObject(http->getString());
+      JsonObject& root = jsonBuffer.parseObject(body);
       if(!root.success()){
-        Serial.println(F("Fail to parse token response"));  
-        return "ERROR";
+        Serial.println(F("Fail to parse token response"));
+        return false;
+      }
+      String token = root["access_token"].as<String>();
+      if(token.length() == 0){
+        Serial.println(F("No access_token in token response"));
+        return false;
       }
-      http->end();
-      API_TOKEN = root["access_token"].as<String>();
-      Serial.print(F("New token received:"));
-      Serial.println(API_TOKEN);
-      jsonBuffer.clear();
-      return API_TOKEN;
-    }else{
-      Serial.print(F("[HTTPS] GET... failed, error: "));
-      Serial.println(http->errorToString(httpCode));
-      http->end();
+      API_TOKEN = token;
+      receivedAt = millis();
+      lifetimeMs = root["expires_in"].as<unsigned long>() * 1000UL;
+      Serial.print(F("New token received, expires in (s):"));
+      Serial.println(lifetimeMs / 1000);
+      writeToken(API_TOKEN);
+      return true;
     }
-  } else {
-    Serial.println(F("[HTTPS] Unable to connect"));
-  }
-  return "ERROR";
-}
+};
@@ -15,11 +15,92 @@
 #ifndef ENV_DEFAULT_API_TOKEN
 #define ENV_DEFAULT_API_TOKEN "API Token not defined"
 #endif
+/** STIB-MIVB endpoint. Can be overridden to target a local server, e.g. tools/replay_server.py:
+ *  -D ENV_API_SCHEME="\"http\"" -D ENV_API_HOST_NAME="\"192.168.1.10\"" -D ENV_API_PORT=8080
+ */
+#ifndef ENV_API_SCHEME
+#define ENV_API_SCHEME "https"
+#endif
+#ifndef ENV_API_HOST_NAME
+#define ENV_API_HOST_NAME "opendata-api.stib-mivb.be"
+#endif
+#ifndef ENV_API_PORT
+#define ENV_API_PORT 443
+#endif
+/** BearSSL buffers (in bytes). An RX buffer below 16384 requires the server to support the max fragment length extension */
+#ifndef TLS_RX_BUFFER_SIZE
+#define TLS_RX_BUFFER_SIZE 16384
+#endif
+#ifndef TLS_TX_BUFFER_SIZE
+#define TLS_TX_BUFFER_SIZE 512
+#endif
 
-/**Refresh rate (in sec) in the passing time screen */
+/** Time (in ms) to join the cached access point before falling back to a scan, then to connect at all before a restart */
+#define WIFI_FAST_CONNECT_TIMEOUT_MS 3000
+#define WIFI_CONNECT_TIMEOUT_MS 8000
+/**Refresh rate (in sec) in the passing time screen when the next arrival is near */
 #define REFRESH_RATE_SEC 15
+/** Refresh rate (in sec) in the passing time screen when nothing is due soon */
+#define MAX_REFRESH_RATE_SEC 300
+/** Between the two, the refresh interval is the time until the next arrival divided by this factor */
+#define ADAPTIVE_REFRESH_DIVISOR 3
+/** Passing time requests allowed per hour by the API key, shared by the displays using the same key */
+#ifndef API_HOURLY_BUDGET
+#define API_HOURLY_BUDGET 360
+#endif
+#ifndef API_KEY_DEVICES
+#define API_KEY_DEVICES 1
+#endif
+/** Requests which can be sent at once after an idle period, within the hourly budget */
+#define API_BURST 4
+/** Exponential backoff (in sec) after a 429, a 5xx or a failed request */
+#define BACKOFF_BASE_SEC 5
+#define BACKOFF_MAX_SEC 600
+/** Max age (in sec) of cached passing times rendered immediately when a favourite is selected */
+#define CACHE_TTL_SEC 120
+/** Minimum time (in sec) between two writes of the passing times snapshot in flash */
+#define SNAPSHOT_INTERVAL_SEC 300
+/** Hub mode, see include/LanServer.h: the passing times of the favourites are served to the other displays of the LAN,
+ *  which point their ENV_API_* flags to this one. The hub refreshes them every LAN_HUB_REFRESH_SEC and never sleeps.
+ */
+#ifndef ENABLE_LAN_SERVER
+#define ENABLE_LAN_SERVER 0
+#endif
+#define LAN_SERVER_PORT 80
+#define LAN_HUB_REFRESH_SEC 30
+/** Time (in ms) the cursor must rest on a favourite before its passing times are prefetched */
+#define PREFETCH_DELAY_MS 1500
+/** The token is renewed in the background this time (in sec) before it expires */
+#define TOKEN_REFRESH_MARGIN_SEC 300
+/** Time (in sec) before a failed background renewal of the token is tried again */
+#define TOKEN_RETRY_DELAY_SEC 60
+/** Edges of a button closer than this (in ms) are bounces */
+#define BUTTON_DEBOUNCE_MS 30
+/** Time (in ms) a button is held before a long press, then the period of the repeats of up/down */
+#define BUTTON_LONG_PRESS_MS 600
+#define BUTTON_REPEAT_MS 200
+/** Time (in ms) the <<Bottom>>/<< Top >> message is displayed */
+#define END_OF_RECORD_MS 1000
+/** Time (in sec) without any button pushed before the device sleeps until the next push */
+#define POWER_IDLE_SEC 120
+/** Supply voltage sampling period (in sec) and warning threshold (in mV) */
+#define POWER_VCC_SAMPLE_SEC 60
+#define LOW_VOLTAGE_MV 3000
+/** Typical current (in mA) of the ESP8266 used to estimate the energy: awake with modem sleep, radio active, light sleep */
+#define POWER_MODEM_SLEEP_MA 20
+#define POWER_RADIO_ACTIVE_MA 80
+#define POWER_LIGHT_SLEEP_MA 1
+/** Period (in ms) of the LCD refresh */
+#define RENDER_INTERVAL_MS 20
+/** A task of the scheduler running longer than this (in ms) is reported as an overrun */
+#ifndef TASK_BUDGET_MS
+#define TASK_BUDGET_MS 50
+#endif
 /** STIB-MIVB endpoint configuration */
-const String HOST = "https://opendata-api.stib-mivb.be";
+const char* API_SCHEME = ENV_API_SCHEME;
+const char* API_HOST_NAME = ENV_API_HOST_NAME;
+const uint16_t API_PORT = ENV_API_PORT;
+const String HOST = String(API_SCHEME) + "://" + API_HOST_NAME + ":" + String(API_PORT);
 /**Stib-Mivb Api Token*/
 const String DEFAULT_API_TOKEN = ENV_DEFAULT_API_TOKEN;
 /*Convert << yourConsumerKey:yourConsumerSecret >> in Base64 */
@@ -31,10 +112,17 @@ const String API_BASIC_AUTH = ENV_API_BASIC_AUTH;
 const char *FINGERPRINT = "5f 88 a4 69 77 f0 69 00 5d 6f 71 19 3d e2 2e 20 44 48 f0 b3";
 
 /** Stops ids. Can be found in the GTFS (stops.txt)*/
-const Favourite favourites[5] = {
-  Favourite("5311", "Tram > Buyl"),
-  Favourite("1715", "34 > Auderghem"),
-  Favourite("8211", "Metro > Centre"),  
-  Favourite("5267", "Tram > Rogier"),
-  Favourite("8212", "Metro > Auderg")
+#define NUMBER_OF_FAVOURITES 5
+/** Labels of the menu, kept in flash. 14 characters at most, after the cursor. */
+const char LABEL_TRAM_BUYL[] PROGMEM = "Tram > Buyl";
+const char LABEL_34_AUDERGHEM[] PROGMEM = "34 > Auderghem";
+const char LABEL_METRO_CENTRE[] PROGMEM = "Metro > Centre";
+const char LABEL_TRAM_ROGIER[] PROGMEM = "Tram > Rogier";
+const char LABEL_METRO_AUDERGHEM[] PROGMEM = "Metro > Auderg";
+const Favourite favourites[NUMBER_OF_FAVOURITES] = {
+  Favourite("5311", LABEL_TRAM_BUYL),
+  Favourite("1715", LABEL_34_AUDERGHEM),
+  Favourite("8211", LABEL_METRO_CENTRE),
+  Favourite("5267", LABEL_TRAM_ROGIER),
+  Favourite("8212", LABEL_METRO_AUDERGHEM)
 };
\ No newline at end of file
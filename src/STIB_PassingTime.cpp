@@ -2,9 +2,10 @@
 /*
     Small device to retrieve the passing time of the STIB-MIVB public transport at given stops.
     These stops are hardcoded in the code as favourites. 
-    The app consists in 2 screen. 
+    The app consists in 3 screen. 
     - The selection of the line from the favourite list.
     - Displaying the time at station
+    - Searching a stop of the GTFS (stops.txt) by name
     The user has 3 push buttons. 
     2 for going up/down. 1 for selecting a favourite/going back to favourites page
 
@@ -16,7 +17,6 @@
 
     Librairies:
     - ArduinoJson v5.13.4: https://arduinojson.org/
-    - ArduinoSort: https://github.com/emilv/ArduinoSort
     - LiquidCrystal I2C: https://github.com/johnrickman/LiquidCrystal_I2C
     - Time from ESP8266
     - SimpleDSTadjust: https://platformio.org/lib/show/1276/simpleDSTadjust
@@ -33,12 +33,14 @@
     v Auto refresh every 15sec
     v 3D print case
     v Summer time issue
+    v voltage low warning
 */
 #define APP_NAME  "Stib IOT - " __FILE__
 #define APP_VERSION  "v0.5-" __DATE__ " " __TIME__
 #define DEBUG true
 #include <PassingTime.h>
 #include <PassingTimeService.h>
+#include <StopSearch.h>
 #include <Favourite.h>
 //Configure WIFI_SSID, WIFI_PWD, API_TOKEN, REFRESH_RATE_SEC and favourites
 #include <config.h>
@@ -47,6 +49,20 @@
 #include <ESP8266WiFi.h>
 #include <Wire.h>  // This library is already built in to the Arduino IDE
 #include <LiquidCrystal_I2C.h> //This library you can add via Include Library > Manage Library > 
+#include <LcdFrameBuffer.h>
+#include <LineFormat.h>
+#include <Metrics.h>
+#include <PowerManager.h>
+#include <ButtonInput.h>
+#include <Scheduler.h>
+#include <BootCache.h>
+#include <PassingTimeSnapshot.h>
+#include <TimeService.h>
+#include <Timetable.h>
+#if ENABLE_LAN_SERVER
+#include <LanServer.h>
+#endif
+#include <coredecls.h>
 #include <time.h>
 #include <simpleDSTadjust.h>
 
@@ -61,26 +77,80 @@ enum UP_DOWN{
   * D2: SDA
 */
 LiquidCrystal_I2C lcd(0x27, 16, 2);
+/** Everything is drawn in the frame buffer, only the changed cells are sent to the LCD by flush() */
+LcdFrameBuffer lcdFrame(&lcd);
 #define UP_BUTTON D4
 #define SELECT_BUTTON D5
 #define DOWN_BUTTON D6
 
 uint8_t down_arrow[8]  = {0x4,0x4,0x4,0x4,0xff,0xe,0x4};
-const String DOWN_ARROW = String("\1");
+uint8_t low_battery[8] = {0xe,0x1b,0x11,0x11,0x11,0x1f,0x1f,0x0};
+#define LOW_BATTERY_CHAR '\2'
+uint8_t clock_glyph[8] = {0x0,0xe,0x15,0x17,0x11,0xe,0x0,0x0};
+/** Marks the scheduled times of the timetable */
+#define SCHEDULED_CHAR '\3'
 
-BearSSL::WiFiClientSecure * client = new BearSSL::WiFiClientSecure();
-HTTPClient http;
+/** ESP.getVcc() measures the supply voltage, A0 is not used */
+ADC_MODE(ADC_VCC);
+const uint8_t BUTTON_PINS[] = {UP_BUTTON, SELECT_BUTTON, DOWN_BUTTON};
+PowerManager powerManager(BUTTON_PINS, sizeof(BUTTON_PINS));
+/** Index of the buttons in the events, in the order they are added to buttonInput */
+enum ButtonId {
+  BUTTON_UP,
+  BUTTON_SELECT,
+  BUTTON_DOWN
+};
+ButtonInput buttonInput;
+
+/** Kept alive connection to the API, used for the token and the passing times */
+ApiConnection apiConnection;
+TokenManager tokenManager(&apiConnection);
+/** Hourly budget and backoff of the passing time requests, whatever the screen or the hub asking them */
+RequestBudget requestBudget;
+PassingTimeFetcher passingTimeFetcher(&apiConnection, &tokenManager, &requestBudget);
 
 /** Method signatures */
 void displayPassingTimeOnLcd(PassingTimeResponse* passingTimeResponse, int page);
+int getNumberOfPages(PassingTimeResponse* passingTimeResponse);
 void retrievePassingTime();
+void onPassingTimeReceived(int httpCode);
+unsigned long getAdaptiveRefreshInterval(PassingTimeResponse* passingTimeResponse);
 void debugPassingTimeResponse();
-void debouncePushButtons();
-void requestNewAccessToken();
-void fatalErrorInApiCall(String message);
-String formatPassingTimeForLcd(PassingTime *passingTime, unsigned long secSinceBeginOfDay);
-unsigned long getNumberOfSecSinceBeginOfDay();
+void readButtons();
+void goToFavourites();
+void showApiError(int httpCode, const char* message);
+void fallBackToTimetable();
+void formatPassingTimeForLcd(PassingTimeResponse* passingTimeResponse, int index, uint32_t nowEpoch, char* line);
 void endOfRecord(UP_DOWN direction, int leftPosition);
+void sleepUntilButtonPushed();
+void prefetchHighlightedFavourite();
+void copyFavouriteMenuLabel(unsigned int position, char* line);
+void connectToWifi();
+void pollTime();
+void pollNetwork();
+void pollToken();
+void pollPower();
+void handleScreen();
+void render();
+void saveSnapshot();
+
+/** Everything runs in these tasks, none of them blocks: loop() only runs the scheduler */
+Scheduler scheduler;
+Task wifiTask("wifi", connectToWifi);
+Task timeTask("ntp", pollTime);
+Task networkTask("fetch", pollNetwork);
+Task tokenTask("token", pollToken);
+Task powerTask("power", pollPower);
+Task uiTask("ui", handleScreen);
+Task renderTask("render", render);
+Task snapshotTask("snapshot", saveSnapshot);
+#if ENABLE_LAN_SERVER
+void pollLanServer();
+void refreshHub();
+void startLanServer();
+Task lanTask("lan", pollLanServer);
+Task hubTask("hub", refreshHub);
+#endif
 
 int timezone = 1 * 3600; //GMT +1
 int dst = 0; //Daylight saving
@@ -88,55 +158,150 @@ struct dstRule StartRule =  {"CEST", Last, Sun, Mar, 2, 3600};
 struct dstRule EndRule = {"CET", Last, Sun, Oct, 2, 0};
 simpleDSTadjust dstAdjusted(StartRule, EndRule);
 char *dstAbbrev;
+/** "Now" of the screens, anchored on the system clock at each synchronisation */
+TimeService timeService;
 
+/** Start the SNTP client, the time is set in the background */
 void configureTime(){
   configTime(timezone, dst, "pool.ntp.org","time.nist.gov");
-  Serial.println(F("Waiting for Internet time"));
-  while(!time(nullptr)){
-     Serial.print(F("*"));
-     delay(1000);
-  }
-  Serial.println(F("Time response....OK"));
+}
+
+/** Anchor the time service on the system clock, after each change of it (NTP, boot cache, wake up) */
+void anchorTime(){
+  time_t utcNow = time(nullptr);
+  // dstAdjusted adds the DST to the UTC time, the time zone is applied by localtime()
+  timeService.anchor(utcNow, timezone + (long)(dstAdjusted.time(&dstAbbrev) - utcNow), millis());
+}
+
+bool isTimeSet(){
+  return timeService.isSet();
+}
+
+void printTime(){
   // Load DST rules
   time_t t = dstAdjusted.time(&dstAbbrev);
   struct tm *timeinfo = localtime (&t);
   char buf[30];
-  sprintf(buf, "%02d/%02d/%04d %02d:%02d:%02d %s\n", timeinfo->tm_mday, timeinfo->tm_mon+1, timeinfo->tm_year+1900, timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec, dstAbbrev);
+  strftime(buf, sizeof(buf), "%d/%m/%Y %H:%M:%S ", timeinfo);
   Serial.print(buf);
+  Serial.println(dstAbbrev);
 }
 
-bool connectToWifi(){
-  Serial.print(F("Connecting to "));
-  Serial.println(WIFI_SSID);
-  lcd.setCursor(0, 0);
-  lcd.print(F("Connecting WiFi "));
+/** Last WiFi connection and time, to restart without scan, DHCP nor waiting for NTP */
+BootCache bootCache;
+/** Passing times of the favourites of the previous run */
+PassingTimeSnapshot snapshot;
+
+/** Duration of the steps of the boot, reported once the first screen is displayed */
+class BootState {
+  public:
+    bool fastConnect = false;
+    bool timeRestored = false;
+    unsigned long wifiConnectStartedAt = 0;
+    unsigned long wifiConnectedAt = 0;
+    unsigned long firstScreenAt = 0;
+    unsigned long timeSyncedAt = 0;
+};
+BootState bootState;
+/** Set by the SNTP client on each synchronisation */
+volatile bool timeSynced = false;
+
+void onTimeSynced(){
+  timeSynced = true;
+}
+
+void startWifiConnect(){
+  bootState.wifiConnectStartedAt = millis();
   WiFi.mode(WIFI_STA);
-  lcd.setCursor(0,1);
-  int count = 0;
-  while (WiFi.status() != WL_CONNECTED) {
-    if(count == 0) WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-    delay(500);
-    lcd.print(".");
-    Serial.print(".");
-    count++;
-    if(count>15){
-      return false;
-    }
+  if(bootState.fastConnect){
+    Serial.println(F("Fast connect on the cached channel"));
+    bootCache.fastConnect(WIFI_SSID, WIFI_PASSWORD);
+  }else{
+    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  }
+}
+
+/** Wifi task, every 100ms at boot. The cached access point is tried first, then a full scan.
+ *  The app starts once connected, the time comes from the boot cache or later from NTP.
+ */
+void connectToWifi(){
+  unsigned long elapsed = millis() - bootState.wifiConnectStartedAt;
+  if(bootState.wifiConnectStartedAt == 0){
+    Serial.print(F("Connecting to "));
+    Serial.println(WIFI_SSID);
+    lcdFrame.printLine(0, F("Connecting WiFi "));
+    bootState.fastConnect = bootCache.hasNetwork();
+    startWifiConnect();
+    return;
+  }
+  if(WiFi.status() == WL_CONNECTED){
+    wifiTask.disable();
+    bootState.wifiConnectedAt = millis();
+    bootCache.saveNetwork();
+    lcdFrame.clear();
+    Serial.println("");
+    lcdFrame.print(0, 0, F("WiFi connected"));
+    Serial.println(F("WiFi connected"));
+    Serial.println(F("IP address: "));
+    Serial.println(WiFi.localIP());
+    // The max fragment length of the TLS buffers is probed by the first request, unless known before the reset
+    apiConnection.begin(bootCache.getTlsRxBufferSize());
+    networkTask.every(0);
+    tokenTask.every(1000);
+    powerTask.every(1000);
+    uiTask.every(0);
+    snapshotTask.every(SNAPSHOT_INTERVAL_SEC * 1000UL);
+#if ENABLE_LAN_SERVER
+    startLanServer();
+#endif
+    return;
+  }
+  if(bootState.fastConnect && elapsed >= WIFI_FAST_CONNECT_TIMEOUT_MS){
+    Serial.println(F("Fast connect failed, scan"));
+    bootState.fastConnect = false;
+    bootCache.clearNetwork();
+    WiFi.disconnect();
+    startWifiConnect();
+    return;
+  }
+  if(elapsed >= WIFI_CONNECT_TIMEOUT_MS){
+    Serial.println(F("Fail to connect. Wrong password? Reset micro controller."));
+    ESP.restart();
+    return;
+  }
+  // One dot every 500ms
+  for(unsigned long column = 0; column <= elapsed / 500 && column < LCD_COLUMNS; column++){
+    lcdFrame.printChar(column, 1, '.');
   }
-  lcd.clear();
-  Serial.println("");
-  lcd.print(F("WiFi connected"));
-  Serial.println(F("WiFi connected"));
-  Serial.println(F("IP address: "));
-  Serial.println(WiFi.localIP()); 
-  return true;
+}
+
+/** Ntp task, every second: anchor each synchronisation in the boot cache */
+void pollTime(){
+  if(!timeSynced){
+    return;
+  }
+  timeSynced = false;
+  if(bootState.timeSyncedAt == 0){
+    bootState.timeSyncedAt = millis();
+    Serial.print(F("Time response....OK after (ms): "));
+    Serial.println(bootState.timeSyncedAt);
+  }
+  anchorTime();
+  printTime();
+  bootCache.saveTime();
 }
 
 enum ScreenType {
   FAVOURITE,
-  PASSING_TIME
+  PASSING_TIME,
+  STOP_SEARCH
 };
 
+/** The favourites menu ends with an entry opening the stop search */
+#define FAVOURITE_MENU_SIZE (NUMBER_OF_FAVOURITES + 1)
+/** Slot of the stop chosen in the stop search, after the favourites */
+#define SEARCHED_STOP_SLOT NUMBER_OF_FAVOURITES
+
 
 class AppState {
   public:
@@ -144,19 +309,47 @@ class AppState {
     int selectButtonState = 0;
     int downButtonState = 0;
     ScreenType screen = FAVOURITE;
-    String stopIdToFetch;
+    unsigned int selectedFavourite = 0;
     unsigned int position = 0;
     unsigned int previousPosition = 0;
     bool reloadFavourites = true;
-    String line1;
-    String line2;
+    /** millis() of the last cursor move, used to prefetch the favourite the cursor rests on */
+    unsigned long positionChangedAt = 0;
+    bool prefetchDone = false;
+    /** Rows of the current screen, restored after the end of record message */
+    char line1[LCD_LINE_LENGTH + 1] = "";
+    char line2[LCD_LINE_LENGTH + 1] = "";
+    /** <<Bottom>>/<< Top >> is displayed until then, 0 when not displayed */
+    unsigned long endOfRecordUntil = 0;
+    UP_DOWN endOfRecordDirection = DOWN;
+    int endOfRecordColumn = 0;
+    /** millis() of the button event not rendered yet, 0 when none */
+    unsigned long inputAt = 0;
+    unsigned long lastInputLatency = 0;
+    unsigned long maxInputLatency = 0;
 };
 AppState appState;
 
+/** Characters offered to type the beginning of a stop name. < removes the last one, > lists the matching stops */
+const char SEARCH_CHARACTERS[] = "<>ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 -'.";
+#define SEARCH_PREFIX_LENGTH 16
+
+class StopSearchState {
+  public:
+    bool browsing = false;
+    bool redraw = true;
+    char prefix[SEARCH_PREFIX_LENGTH + 1] = "";
+    uint8_t prefixLength = 0;
+    uint8_t characterIndex = 2;
+    /** Position in the stops sorted by name while browsing */
+    int namePosition = 0;
+    char stopId[STOP_ID_LENGTH] = "";
+    const char* stopIds[1] = { stopId };
+};
+StopSearchState stopSearchState;
+
 void handleScreenFavourite(){
-  appState.upButtonState=digitalRead(UP_BUTTON);
-  appState.selectButtonState=digitalRead(SELECT_BUTTON);
-  appState.downButtonState=digitalRead(DOWN_BUTTON);
+  readButtons();
   if(appState.selectButtonState == HIGH || appState.upButtonState == HIGH || appState.downButtonState == HIGH){
     if(DEBUG){
       Serial.print(F("Button pushed: "));
@@ -164,11 +357,18 @@ void handleScreenFavourite(){
       Serial.print(F(" upButtonState:"));Serial.print(appState.upButtonState);
       Serial.print(F(" downButtonState"));Serial.println(appState.downButtonState);
     }
-    if(appState.selectButtonState == HIGH){
+    if(appState.selectButtonState == HIGH && appState.position == SEARCHED_STOP_SLOT){
+      appState.screen = STOP_SEARCH;
+      stopSearchState.browsing = false;
+      stopSearchState.redraw = true;
+      Serial.println(F("Switch to Screen STOP SEARCH"));
+    } else if(appState.selectButtonState == HIGH){
       appState.screen = PASSING_TIME;
-      appState.stopIdToFetch = favourites[appState.position].stopId;
+      appState.selectedFavourite = appState.position;
       Serial.println(F("Switch to Screen PASSING TIME"));
-      lcd.clear();
+      lcdFrame.clear();
+      // Replaced at once when the passing times are in cache
+      lcdFrame.print(0, 0, F("Loading..."));
     } else if(appState.upButtonState == HIGH){
       if(appState.position>0){      
         appState.previousPosition = appState.position;
@@ -177,14 +377,13 @@ void handleScreenFavourite(){
         endOfRecord(UP, 2);
       }
     } else if(appState.downButtonState == HIGH){
-      if(appState.position+1 < (sizeof(favourites)/sizeof(Favourite))){
+      if(appState.position+1 < FAVOURITE_MENU_SIZE){
         appState.previousPosition = appState.position;
         appState.position = appState.position+1;
       }else{
         endOfRecord(DOWN, 2);
       }
     }
-    debouncePushButtons();
   }
   //Display favourites
   if(appState.position != appState.previousPosition || appState.reloadFavourites ){
@@ -204,11 +403,11 @@ void handleScreenFavourite(){
       }else{
         clearLcd = true;  
         arrowPosition = 0;
-        appState.line1 = favourites[appState.position].label;
-        if(appState.position+1 < (sizeof(favourites)/sizeof(Favourite))){
-          appState.line2 = favourites[appState.position+1].label;
+        copyFavouriteMenuLabel(appState.position, appState.line1);
+        if(appState.position+1 < FAVOURITE_MENU_SIZE){
+          copyFavouriteMenuLabel(appState.position+1, appState.line2);
         }else{
-          appState.line2 = "----------------";
+          strcpy(appState.line2, "----------------");
         }
       }    
     }else{ //Going up
@@ -216,8 +415,8 @@ void handleScreenFavourite(){
       if(modulo == 1){
         clearLcd = true;
         arrowPosition = 1;
-        appState.line1 = favourites[appState.position-1].label;
-        appState.line2 = favourites[appState.position].label;
+        copyFavouriteMenuLabel(appState.position-1, appState.line1);
+        copyFavouriteMenuLabel(appState.position, appState.line2);
       }else{
         arrowPosition = 0;
       }  
@@ -225,204 +424,620 @@ void handleScreenFavourite(){
     appState.reloadFavourites = false;
     if(clearLcd){
       Serial.println(F("Refresh favourites screen"));
-      lcd.clear();  
+      lcdFrame.clear();
       clearLcd = false;
       //Display lines
-      lcd.setCursor(2,0);
-      lcd.print(appState.line1);
-      lcd.setCursor(2,1);
-      lcd.print(appState.line2);
+      lcdFrame.print(2, 0, appState.line1);
+      lcdFrame.print(2, 1, appState.line2);
     }
     //Display arrow
-    lcd.setCursor(0,arrowPosition);
-    lcd.print((char)126);
-    lcd.setCursor(0,arrowPosition ? 0 : 1);
-    lcd.print(" ");
+    lcdFrame.printChar(0, arrowPosition, (char)126);
+    lcdFrame.printChar(0, arrowPosition ? 0 : 1, ' ');
     appState.previousPosition = appState.position;
+    appState.positionChangedAt = millis();
+    appState.prefetchDone = false;
   }
+  prefetchHighlightedFavourite();
+}
+
+void copyFavouriteMenuLabel(unsigned int position, char* line){
+  copyLine_P(line, position == SEARCHED_STOP_SLOT ? PSTR("Search stop") : favourites[position].label);
 }
 
 class PassingTimeState{
    public:
     unsigned long lastUpdate = 0;
-    bool fatalErrorOccured = false;
+    /** Adapted after each response to the time until the next arrival */
+    unsigned long refreshIntervalMs = REFRESH_RATE_SEC * 1000UL;
+    /** millis() of the last local recomputation of the remaining times */
+    unsigned long lastCountdown = 0;
     int passingTimePage = 0;
-    PassingTimeResponse* passingTimeResponse = NULL;
-    void clearPassingTimeResponse(){
-      if(passingTimeResponse != NULL){
-        passingTimeResponse->clear();
-        delete passingTimeResponse;
-        passingTimeResponse = NULL;
-      }
+    /** Preallocated once, refilled in place on every refresh. One response per favourite, then the searched stop. */
+    PassingTimeResponse passingTimeResponses[NUMBER_OF_FAVOURITES + 1];
+
+    PassingTimeResponse* selectedResponse(){
+      return &passingTimeResponses[appState.selectedFavourite];
     }
 };
 PassingTimeState passingTimeState;
+
+#if ENABLE_LAN_SERVER
+const char* favouriteStopIds[NUMBER_OF_FAVOURITES];
+LanServer lanServer(LAN_SERVER_PORT, favouriteStopIds, passingTimeState.passingTimeResponses, NUMBER_OF_FAVOURITES);
+
+/** Lan task, on every pass: the requests of the other displays */
+void pollLanServer(){
+  lanServer.poll();
+}
+
+void onHubRefreshed(int httpCode){
+  powerManager.onRequestDone(apiConnection.getStats().lastRequestMs);
+  if(DEBUG){
+    Serial.print(F("[LAN] Favourites refreshed, code: "));
+    Serial.print(httpCode);
+    Serial.print(F(" requests served: "));
+    Serial.println(lanServer.getServed());
+  }
+}
+
+/** Hub task, every LAN_HUB_REFRESH_SEC: the favourites are kept fresh for the other displays, whatever the screen */
+void refreshHub(){
+  if(!passingTimeFetcher.canStart() || WiFi.status() != WL_CONNECTED){
+    return;
+  }
+  passingTimeFetcher.startFavourites(passingTimeState.passingTimeResponses, onHubRefreshed);
+}
+
+void startLanServer(){
+  lanServer.begin();
+  lanTask.every(0);
+  hubTask.every(LAN_HUB_REFRESH_SEC * 1000UL);
+}
+#endif
+
+void goToFavourites(){
+  appState.screen = FAVOURITE;
+  appState.reloadFavourites = true;
+  passingTimeState.lastUpdate = 0;
+  Serial.println(F("Switch to Screen FAVOURITE"));
+}
+
+/** Take the next button event into the button states of the app.
+ *  Up/down are pushed again while held, a long push on select goes back to the favourites from any screen.
+ */
+void readButtons(){
+  appState.upButtonState = LOW;
+  appState.selectButtonState = LOW;
+  appState.downButtonState = LOW;
+  ButtonEvent event;
+  if(!buttonInput.next(&event)){
+    return;
+  }
+  powerManager.notifyActivity();
+  appState.inputAt = event.at;
+  if(event.type == BUTTON_LONG_PRESSED){
+    if(appState.screen != FAVOURITE){
+      goToFavourites();
+    }
+    return;
+  }
+  if(event.button == BUTTON_UP){
+    appState.upButtonState = HIGH;
+  }else if(event.button == BUTTON_SELECT){
+    appState.selectButtonState = HIGH;
+  }else{
+    appState.downButtonState = HIGH;
+  }
+}
+
+/** Once the cursor rests on a favourite, refresh the cache in the background so that selecting it renders at once.
+ *  Done once per cursor position to spare the API quota.
+ */
+void prefetchHighlightedFavourite(){
+  unsigned long now = millis();
+  if(appState.prefetchDone || appState.position >= NUMBER_OF_FAVOURITES || now - appState.positionChangedAt < PREFETCH_DELAY_MS || !passingTimeFetcher.canStart() || WiFi.status() != WL_CONNECTED){
+    return;
+  }
+  appState.prefetchDone = true;
+  if(!passingTimeState.passingTimeResponses[appState.position].isStale(now, REFRESH_RATE_SEC * 1000)){
+    return;
+  }
+  Serial.println(F("Prefetch passing times"));
+  passingTimeFetcher.startFavourites(passingTimeState.passingTimeResponses, onPassingTimeReceived);
+}
+
 void handleScreenPassingTime(){  
-  if(passingTimeState.lastUpdate != 0 && (passingTimeState.fatalErrorOccured || (millis() - passingTimeState.lastUpdate) < REFRESH_RATE_SEC * 1000) ){
-    appState.upButtonState=digitalRead(UP_BUTTON);
-    appState.selectButtonState=digitalRead(SELECT_BUTTON);
-    appState.downButtonState=digitalRead(DOWN_BUTTON);
-    if(appState.selectButtonState == HIGH || appState.upButtonState == HIGH || appState.downButtonState == HIGH){
-      if(appState.selectButtonState == HIGH){
-        appState.screen = FAVOURITE;
-        appState.reloadFavourites = true;
-        passingTimeState.lastUpdate = 0;
-        passingTimeState.fatalErrorOccured = false;
-        Serial.println(F("Switch to Screen FAVOURITE"));
-      }else if(appState.downButtonState == HIGH){
-        if(passingTimeState.passingTimePage < (passingTimeState.passingTimeResponse->numberOfResponses/2 + passingTimeState.passingTimeResponse->numberOfResponses%2)){
-          passingTimeState.passingTimePage = passingTimeState.passingTimePage+1;
-          displayPassingTimeOnLcd(passingTimeState.passingTimeResponse, passingTimeState.passingTimePage); 
-        }else{
-          endOfRecord(DOWN, 0);
-        }
-      }else if(appState.upButtonState == HIGH){
-        if(passingTimeState.passingTimePage > 1){
-          passingTimeState.passingTimePage = passingTimeState.passingTimePage-1;
-          displayPassingTimeOnLcd(passingTimeState.passingTimeResponse, passingTimeState.passingTimePage); 
-        }else{
-          endOfRecord(UP, 0);
-        }
+  bool timeSet = isTimeSet();
+  bool restored = passingTimeState.selectedResponse()->source != SOURCE_API;
+  if(timeSet && passingTimeState.lastUpdate == 0 && (restored || !passingTimeState.selectedResponse()->isStale(millis(), CACHE_TTL_SEC * 1000))){
+    // Render from the cache at once, it is revalidated below when older than the refresh rate, or at once when restored or scheduled
+    passingTimeState.passingTimePage = 1;
+    displayPassingTimeOnLcd(passingTimeState.selectedResponse(), passingTimeState.passingTimePage);
+    passingTimeState.lastUpdate = passingTimeState.selectedResponse()->receivedAt;
+    passingTimeState.refreshIntervalMs = restored ? 0 : getAdaptiveRefreshInterval(passingTimeState.selectedResponse());
+  }
+  if(!timeSet){
+    // The remaining times can't be computed until NTP has set the time, "Loading..." stays meanwhile
+  }else{
+    if(passingTimeState.lastUpdate == 0 || (millis() - passingTimeState.lastUpdate) >= passingTimeState.refreshIntervalMs){
+      // Started once the budget allows it, the passing times displayed meanwhile keep counting down
+      retrievePassingTime();
+    }
+    if(passingTimeState.lastUpdate != 0 && millis() - passingTimeState.lastCountdown >= 1000){
+      // Remaining times are recomputed locally every second, only the changed cells reach the LCD
+      displayPassingTimeOnLcd(passingTimeState.selectedResponse(), passingTimeState.passingTimePage);
+    }
+  }
+  // Buttons are still handled while the passing times are fetched
+  readButtons();
+  if(appState.selectButtonState == HIGH || appState.upButtonState == HIGH || appState.downButtonState == HIGH){
+    if(appState.selectButtonState == HIGH){
+      goToFavourites();
+    }else if(passingTimeState.lastUpdate == 0){
+      // Nothing displayed yet
+    }else if(appState.downButtonState == HIGH){
+      if(passingTimeState.passingTimePage < getNumberOfPages(passingTimeState.selectedResponse())){
+        passingTimeState.passingTimePage = passingTimeState.passingTimePage+1;
+        displayPassingTimeOnLcd(passingTimeState.selectedResponse(), passingTimeState.passingTimePage); 
+      }else{
+        endOfRecord(DOWN, 0);
       }
-      debouncePushButtons();
+    }else if(appState.upButtonState == HIGH){
+      if(passingTimeState.passingTimePage > 1){
+        passingTimeState.passingTimePage = passingTimeState.passingTimePage-1;
+        displayPassingTimeOnLcd(passingTimeState.selectedResponse(), passingTimeState.passingTimePage); 
+      }else{
+        endOfRecord(UP, 0);
+      }
+    }
+  }
+}
+
+/** True when at least one stop name starts with the prefix followed by the character */
+bool isSearchCharacterAvailable(uint8_t characterIndex){
+  char c = SEARCH_CHARACTERS[characterIndex];
+  if(c == '<' || c == '>' || stopSearchState.prefixLength == SEARCH_PREFIX_LENGTH){
+    return c == '<' || c == '>';
+  }
+  stopSearchState.prefix[stopSearchState.prefixLength] = c;
+  stopSearchState.prefix[stopSearchState.prefixLength + 1] = '\0';
+  bool available = findFirstStopByNamePrefix(stopSearchState.prefix) >= 0;
+  stopSearchState.prefix[stopSearchState.prefixLength] = '\0';
+  return available;
+}
+
+void moveSearchCharacter(UP_DOWN direction){
+  uint8_t numberOfCharacters = strlen(SEARCH_CHARACTERS);
+  do{
+    stopSearchState.characterIndex = (stopSearchState.characterIndex + (direction == DOWN ? 1 : numberOfCharacters - 1)) % numberOfCharacters;
+  }while(!isSearchCharacterAvailable(stopSearchState.characterIndex));
+}
+
+void selectSearchCharacter(){
+  char c = SEARCH_CHARACTERS[stopSearchState.characterIndex];
+  if(c == '<'){
+    if(stopSearchState.prefixLength == 0){
+      goToFavourites();
+      return;
+    }
+    stopSearchState.prefix[--stopSearchState.prefixLength] = '\0';
+  }else if(c == '>'){
+    int namePosition = findFirstStopByNamePrefix(stopSearchState.prefix);
+    if(namePosition >= 0){
+      stopSearchState.browsing = true;
+      stopSearchState.namePosition = namePosition;
     }
   }else{
-    retrievePassingTime();
+    stopSearchState.prefix[stopSearchState.prefixLength++] = c;
+    stopSearchState.prefix[stopSearchState.prefixLength] = '\0';
+    // Suggest to list the stops once the name is typed
+    stopSearchState.characterIndex = 1;
+  }
+}
+
+void selectSearchedStop(){
+  getStopId(getStopIndexAtNamePosition(stopSearchState.namePosition), stopSearchState.stopId);
+  Serial.print(F("Stop selected: "));
+  Serial.println(stopSearchState.stopId);
+  passingTimeState.passingTimeResponses[SEARCHED_STOP_SLOT].clear();
+  appState.selectedFavourite = SEARCHED_STOP_SLOT;
+  appState.screen = PASSING_TIME;
+  Serial.println(F("Switch to Screen PASSING TIME"));
+  lcdFrame.clear();
+  lcdFrame.print(0, 0, F("Loading..."));
+}
+
+void displayStopSearch(){
+  char line1[LCD_LINE_LENGTH + 1];
+  char line2[LCD_LINE_LENGTH + 1];
+  if(stopSearchState.browsing){
+    int stopIndex = getStopIndexAtNamePosition(stopSearchState.namePosition);
+    getStopName(stopIndex, line1, sizeof(line1));
+    char stopId[STOP_ID_LENGTH];
+    getStopId(stopIndex, stopId);
+    snprintf(line2, sizeof(line2), "Stop %s", stopId);
+  }else{
+    char c = SEARCH_CHARACTERS[stopSearchState.characterIndex];
+    // The end of the prefix when it doesn't fit with the character
+    const char* prefix = stopSearchState.prefix;
+    if(stopSearchState.prefixLength > LCD_LINE_LENGTH - 1){
+      prefix += stopSearchState.prefixLength - (LCD_LINE_LENGTH - 1);
+    }
+    snprintf(line1, sizeof(line1), "%.*s%c", LCD_LINE_LENGTH - 1, prefix, c);
+    if(c == '<'){
+      snprintf(line2, sizeof(line2), stopSearchState.prefixLength == 0 ? "< Back" : "< Delete");
+    }else if(c == '>'){
+      snprintf(line2, sizeof(line2), "> List stops");
+    }else{
+      stopSearchState.prefix[stopSearchState.prefixLength] = c;
+      stopSearchState.prefix[stopSearchState.prefixLength + 1] = '\0';
+      int namePosition = findFirstStopByNamePrefix(stopSearchState.prefix);
+      stopSearchState.prefix[stopSearchState.prefixLength] = '\0';
+      if(namePosition >= 0){
+        getStopName(getStopIndexAtNamePosition(namePosition), line2, sizeof(line2));
+      }else{
+        line2[0] = '\0';
+      }
+    }
+  }
+  lcdFrame.printLine(0, line1);
+  lcdFrame.printLine(1, line2);
+}
+
+/** Search a stop of the GTFS by typing the beginning of its name, letter by letter, then browse the stops by name */
+void handleScreenStopSearch(){
+  readButtons();
+  if(appState.selectButtonState == HIGH || appState.upButtonState == HIGH || appState.downButtonState == HIGH){
+    if(!stopSearchState.browsing){
+      if(appState.selectButtonState == HIGH){
+        selectSearchCharacter();
+      }else{
+        moveSearchCharacter(appState.upButtonState == HIGH ? UP : DOWN);
+      }
+    }else if(appState.selectButtonState == HIGH){
+      selectSearchedStop();
+    }else if(appState.upButtonState == HIGH){
+      // Going above the first match goes back to the typing of the name
+      if(stopSearchState.namePosition > 0 && stopSearchState.namePosition > findFirstStopByNamePrefix(stopSearchState.prefix)){
+        stopSearchState.namePosition--;
+      }else{
+        stopSearchState.browsing = false;
+      }
+    }else if(stopSearchState.namePosition + 1 < STOP_COUNT){
+      stopSearchState.namePosition++;
+    }
+    stopSearchState.redraw = true;
+  }
+  if(appState.screen == STOP_SEARCH && stopSearchState.redraw){
+    displayStopSearch();
+    stopSearchState.redraw = false;
   }
 }
 
+/** Start refreshing the passing times in the background, onPassingTimeReceived is called once done */
 void retrievePassingTime(){
-  lcd.setCursor(0,0);
-  lcd.print(F("Loading..."));
+  if(WiFi.status() != WL_CONNECTED && passingTimeState.lastUpdate == 0){
+    fallBackToTimetable();
+  }
+  // Tried again on the next loop() pass, e.g. while WiFi reconnects after a sleep or during a backoff
+  if(!passingTimeFetcher.canStart() || WiFi.status() != WL_CONNECTED){
+    return;
+  }
   if(DEBUG){
     Serial.print(F("Free RAM = "));
     Serial.println(ESP.getFreeHeap(), DEC); 
   } 
-  passingTimeState.clearPassingTimeResponse();
-  passingTimeState.passingTimeResponse = getPassingTime(&http, client, appState.stopIdToFetch);
-  if( passingTimeState.passingTimeResponse != 0 && passingTimeState.passingTimeResponse->httpCode == 200 ){
+  bool started;
+  if(appState.selectedFavourite == SEARCHED_STOP_SLOT){
+    started = passingTimeFetcher.start(stopSearchState.stopIds, 1, passingTimeState.selectedResponse(), onPassingTimeReceived);
+  }else{
+    // All the favourites are refreshed in one round-trip
+    started = passingTimeFetcher.startFavourites(passingTimeState.passingTimeResponses, onPassingTimeReceived);
+  }
+  if(!started){
+    showApiError(0, "get passing time");
+  }
+}
+
+/** Poll often when the next arrival is near, back off to MAX_REFRESH_RATE_SEC when nothing is due */
+unsigned long getAdaptiveRefreshInterval(PassingTimeResponse* passingTimeResponse){
+  uint32_t nowEpoch = timeService.now(millis());
+  long nextArrival = MAX_REFRESH_RATE_SEC * ADAPTIVE_REFRESH_DIVISOR;
+  for(int i = 0; i < passingTimeResponse->numberOfResponses; i++){
+    long remaining = passingTimeResponse->passingTimes[i].getRemainingSeconds(nowEpoch);
+    if(remaining >= 0 && remaining < nextArrival){
+      nextArrival = remaining;
+    }
+  }
+  long interval = nextArrival / ADAPTIVE_REFRESH_DIVISOR;
+  if(interval < REFRESH_RATE_SEC){
+    interval = REFRESH_RATE_SEC;
+  }else if(interval > MAX_REFRESH_RATE_SEC){
+    interval = MAX_REFRESH_RATE_SEC;
+  }
+  return interval * 1000UL;
+}
+
+void onPassingTimeReceived(int httpCode){
+  powerManager.onRequestDone(apiConnection.getStats().lastRequestMs);
+  if(DEBUG){
+    apiConnection.printStats();
+    requestBudget.printStats();
+    scheduler.printStats();
+    powerManager.printEnergy();
+  }
+  if(appState.screen != PASSING_TIME || !isTimeSet()){
+    // Prefetch from the favourites screen, the cache has been updated
+    return;
+  }
+  if(!passingTimeFetcher.covers(passingTimeState.selectedResponse())){
+    // Started before the stop was selected, e.g. a prefetch: its own fetch starts now, the display waits for it
+    retrievePassingTime();
+    return;
+  }
+  if( httpCode == HTTP_CODE_OK ){
     if(DEBUG){
       debugPassingTimeResponse();
     }
     passingTimeState.passingTimePage = 1;
-    displayPassingTimeOnLcd(passingTimeState.passingTimeResponse, passingTimeState.passingTimePage); 
+    displayPassingTimeOnLcd(passingTimeState.selectedResponse(), passingTimeState.passingTimePage); 
     passingTimeState.lastUpdate = millis();
-  }else if( passingTimeState.passingTimeResponse != 0 && passingTimeState.passingTimeResponse->httpCode == 401 ){
-    requestNewAccessToken();
-  }else{
-    fatalErrorInApiCall("get passing time");
-    // Update fingerprint in config
-  }
-}
-
-void fatalErrorInApiCall(String message){
-  Serial.print(F("Fatal error occured in API call:"));
-  Serial.println(message);
-  lcd.clear();
-  lcd.print(F("Er:Cert expired?"));
-  lcd.setCursor(0,1);
-  lcd.print(message);
-  delay(2000);
-  passingTimeState.fatalErrorOccured = true;
-}
-
-void requestNewAccessToken(){
-  Serial.println(F("Token expired, request new token"));
-  lcd.clear();
-  lcd.print(F("Token expired"));
-  lcd.setCursor(0,1);
-  lcd.print(F("Req. new token.."));
-  String newToken = getNewToken(&http, client);
-  if(newToken != "ERROR"){
-    writeToken(newToken);  
+    passingTimeState.refreshIntervalMs = getAdaptiveRefreshInterval(passingTimeState.selectedResponse());
+    if(DEBUG){
+      Serial.print(F("Next refresh in (ms): "));
+      Serial.println(passingTimeState.refreshIntervalMs);
+    }
+  }else if( httpCode == HTTP_CODE_UNAUTHORIZED ){
+    // Still rejected with a renewed token
+    showApiError(httpCode, "request token");
   }else{
-    fatalErrorInApiCall("request token");
+    showApiError(httpCode, "get passing time");
   }
 }
 
-void debugPassingTimeResponse(){
-  Serial.println(F("Response:"));
-  unsigned long numberOfSecSinceBeginOfDay = getNumberOfSecSinceBeginOfDay();
-  for(int k =0; k<passingTimeState.passingTimeResponse->numberOfResponses ; k++){
-    Serial.println(formatPassingTimeForLcd(passingTimeState.passingTimeResponse->passingTimes[k],numberOfSecSinceBeginOfDay) + " - " +passingTimeState.passingTimeResponse->passingTimes[k]->getRawExpectedTime());
+/** The request is retried after the backoff of the budget. The passing times already displayed stay, they keep counting down. */
+void showApiError(int httpCode, const char* message){
+  Serial.print(F("Error in API call:"));
+  Serial.print(message);
+  Serial.print(F(" code:"));
+  Serial.print(httpCode);
+  Serial.print(F(" retry in (ms): "));
+  Serial.println(requestBudget.getWaitMs(millis()));
+  // Also refreshed when already scheduled, to drop the passed times
+  if(passingTimeState.selectedResponse()->numberOfResponses == 0 || passingTimeState.selectedResponse()->source == SOURCE_TIMETABLE){
+    fallBackToTimetable();
   }
-  Serial.println(F("---------------"));
+  if(passingTimeState.lastUpdate == 0){
+    char line[LCD_LINE_LENGTH + 1];
+    snprintf(line, sizeof(line), "Er:%d retrying", httpCode);
+    lcdFrame.printLine(0, line);
+    lcdFrame.printLine(1, message);
+  }
+}
+
+/** Without passing times from the API, display the scheduled ones of the timetable compiled in flash.
+ *  They are replaced as soon as a request succeeds.
+ */
+void fallBackToTimetable(){
+  if(!isTimeSet()){
+    return;
+  }
+  const char* stopId = appState.selectedFavourite == SEARCHED_STOP_SLOT ? stopSearchState.stopIds[0] : favourites[appState.selectedFavourite].stopId;
+  if(findScheduledPassingTimes(stopId, timeService.now(millis()), timeService.getUtcOffset(), passingTimeState.selectedResponse()) == 0){
+    return;
+  }
+  Serial.println(F("Scheduled passing times from the timetable"));
+  passingTimeState.selectedResponse()->receivedAt = millis();
+  passingTimeState.passingTimePage = 1;
+  displayPassingTimeOnLcd(passingTimeState.selectedResponse(), passingTimeState.passingTimePage);
+  passingTimeState.lastUpdate = millis();
+  // The API is tried again as soon as the budget allows it
+  passingTimeState.refreshIntervalMs = 0;
 }
 
-void debouncePushButtons(){
-  while(appState.selectButtonState == HIGH || appState.upButtonState == HIGH || appState.downButtonState == HIGH){
-    appState.upButtonState=digitalRead(UP_BUTTON);
-    appState.selectButtonState=digitalRead(SELECT_BUTTON);
-    appState.downButtonState=digitalRead(DOWN_BUTTON);
+void debugPassingTimeResponse(){
+  Serial.println(F("Response:"));
+  uint32_t nowEpoch = timeService.now(millis());
+  char line[LCD_LINE_LENGTH + 1];
+  for(int k =0; k<passingTimeState.selectedResponse()->numberOfResponses ; k++){
+    formatPassingTimeForLcd(passingTimeState.selectedResponse(), k, nowEpoch, line);
+    Serial.print(line);
+    Serial.print(F(" - "));
+    Serial.println(passingTimeState.selectedResponse()->passingTimes[k].getExpectedEpoch());
   }
+  Serial.println(F("---------------"));
 }
 
 /** Display a small message for the user to tell him that he reached the top/bottom of the list*/
 void endOfRecord(UP_DOWN direction, int leftPosition){
-  if(direction == DOWN){
-    lcd.setCursor(leftPosition,1);
-    lcd.print(F("<<Bottom>>"));
-    delay(1000);
-    lcd.setCursor(leftPosition,1);
-    lcd.print(appState.line2);
+  appState.endOfRecordUntil = millis() + END_OF_RECORD_MS;
+  appState.endOfRecordDirection = direction;
+  appState.endOfRecordColumn = leftPosition;
+}
+
+/** Keep the end of record message over the screen, then restore the line it hides */
+void displayEndOfRecord(){
+  if(appState.endOfRecordUntil == 0){
+    return;
+  }
+  int row = appState.endOfRecordDirection == DOWN ? 1 : 0;
+  if((long)(millis() - appState.endOfRecordUntil) < 0){
+    lcdFrame.print(appState.endOfRecordColumn, row, row == 1 ? F("<<Bottom>>") : F("<< Top >>"));
   }else{
-    lcd.setCursor(leftPosition,0);
-    lcd.print(F("<< Top >>"));
-    delay(1000);
-    lcd.setCursor(leftPosition,0);
-    lcd.print(appState.line1);    
+    lcdFrame.printPadded(appState.endOfRecordColumn, row, row == 1 ? appState.line2 : appState.line1);
+    appState.endOfRecordUntil = 0;
   }
 }
 
-unsigned long getNumberOfSecSinceBeginOfDay(){
-  time_t now = dstAdjusted.time(&dstAbbrev);
-  struct tm* p_tm = localtime(&now);
-  while(p_tm->tm_year < 100){
-    Serial.print(F("Current year: "));
-    Serial.print(p_tm->tm_year);
-    Serial.println(F("[ERROR] Current date is not fully initialized! Delay 200ms"));
-    delay(200);
-    now = time(nullptr);
-    p_tm = localtime(&now);
+/** Light sleep while nobody uses the device. Everything is kept in RAM, only the passing times are outdated */
+void sleepUntilButtonPushed(){
+  lcd.noBacklight();
+  apiConnection.close();
+  powerManager.sleepUntilButtonPushed();
+  buttonInput.attach();
+  lcd.backlight();
+  // The SNTP timers have been dropped by the sleep, the clock has been corrected meanwhile but not millis()
+  anchorTime();
+  configureTime();
+  // The passing times are kept and displayed as stale until the refresh, less those passed during the sleep
+  uint32_t nowEpoch = timeService.now(millis());
+  for(int i = 0; i < NUMBER_OF_FAVOURITES + 1; i++){
+    PassingTimeResponse* response = &passingTimeState.passingTimeResponses[i];
+    if(response->isReceived() && response->source == SOURCE_API){
+      response->source = SOURCE_SNAPSHOT;
+    }
+    if(isTimeSet()){
+      response->removePassed(nowEpoch);
+    }
   }
-  if(DEBUG){
-    Serial.print(F("Current time:"));
-    Serial.print(p_tm->tm_hour);
-    Serial.print(F(":"));
-    Serial.print(p_tm->tm_min);
-    Serial.print(F(":"));
-    Serial.println(p_tm->tm_sec);
-  }
-  return p_tm->tm_hour *3600 + p_tm->tm_min *60 + p_tm->tm_sec;
-}
-
-String formatPassingTimeForLcd(PassingTime *passingTime, unsigned long secSinceBeginOfDay){
-  long remainingTime = passingTime->getRemainingTime(secSinceBeginOfDay);
-  String remainingTimeStr = String(remainingTime);
-  if(remainingTime == 0){
-    remainingTimeStr = DOWN_ARROW + DOWN_ARROW;
-  }else if(remainingTime < 10){
-    remainingTimeStr = " " + remainingTimeStr;
-  }else if(remainingTime > 90){
-    remainingTimeStr = "--";
+  passingTimeState.lastUpdate = 0;
+  appState.positionChangedAt = millis();
+  appState.prefetchDone = false;
+  if(appState.screen == PASSING_TIME && !passingTimeState.selectedResponse()->isReceived()){
+    lcdFrame.clear();
+    lcdFrame.print(0, 0, F("Loading..."));
   }
-  
-  return (passingTime->getLine() + "  ").substring(0,3) + (passingTime->getDestination() + "       ").substring(0, 10) + " " + remainingTimeStr;
+  // The push which woke the device up is not an action
+  buttonInput.clear();
+}
+
+void formatPassingTimeForLcd(PassingTimeResponse* passingTimeResponse, int index, uint32_t nowEpoch, char* line){
+  PassingTime* passingTime = &passingTimeResponse->passingTimes[index];
+  // * marks the passing times restored from the snapshot, a clock the scheduled ones, until fresh ones are received
+  char marker = passingTimeResponse->source == SOURCE_SNAPSHOT ? '*' : (passingTimeResponse->source == SOURCE_TIMETABLE ? SCHEDULED_CHAR : ' ');
+  formatPassingTimeLine(line, passingTime->getLine(), passingTimeResponse->getDestination(index), marker, passingTime->getRemainingTime(nowEpoch));
 }
 
 
+/** Two passing times per page. One page when there is none, to tell it */
+int getNumberOfPages(PassingTimeResponse* passingTimeResponse){
+  return passingTimeResponse->numberOfResponses == 0 ? 1 : (passingTimeResponse->numberOfResponses + 1) / 2;
+}
+
 void displayPassingTimeOnLcd(PassingTimeResponse* passingTimeResponse, int page){
-  lcd.clear();
-  unsigned long numberOfSecSinceBeginOfDay = getNumberOfSecSinceBeginOfDay();
-  appState.line1 = formatPassingTimeForLcd(passingTimeResponse->passingTimes[(page-1)*2],numberOfSecSinceBeginOfDay);
+  passingTimeState.lastCountdown = millis();
+  uint32_t nowEpoch = timeService.now(millis());
+  if(page > getNumberOfPages(passingTimeResponse)){
+    // The response got shorter since the page was chosen
+    page = getNumberOfPages(passingTimeResponse);
+    passingTimeState.passingTimePage = page;
+  }
+  METRICS_BEGIN(METRIC_FORMAT);
+  if(passingTimeResponse->numberOfResponses == 0){
+    // Not the passing times left in the store by a former response
+    strcpy(appState.line1, "No passing time");
+  }else{
+    formatPassingTimeForLcd(passingTimeResponse, (page-1)*2, nowEpoch, appState.line1);
+  }
   if((page-1)*2 + 1 < passingTimeResponse->numberOfResponses){
-    appState.line2 = formatPassingTimeForLcd(passingTimeResponse->passingTimes[(page-1)*2 + 1],numberOfSecSinceBeginOfDay);
+    formatPassingTimeForLcd(passingTimeResponse, (page-1)*2 + 1, nowEpoch, appState.line2);
+  }else{
+    strcpy(appState.line2, "----------------");
+  }
+  METRICS_END(METRIC_FORMAT);
+  lcdFrame.printLine(0, appState.line1);
+  lcdFrame.printLine(1, appState.line2);
+}
+
+/** Network task, on every pass: progress of the request in flight */
+void pollNetwork(){
+  apiConnection.poll();
+  if(apiConnection.getRxBufferSize() != 0){
+    bootCache.saveTlsRxBufferSize(apiConnection.getRxBufferSize());
+  }
+}
+
+/** Token task: renewal ahead of the expiry */
+void pollToken(){
+  tokenManager.poll();
+}
+
+/** Power task: voltage sampling and sleep when idle */
+void pollPower(){
+  if(buttonInput.isAnyPressed()){
+    powerManager.notifyActivity();
+  }
+  powerManager.poll();
+  // A hub stays reachable
+  if(!ENABLE_LAN_SERVER && powerManager.isIdle() && !apiConnection.isBusy()){
+    sleepUntilButtonPushed();
+  }
+}
+
+/** UI task, on every pass: buttons and drawing of the current screen in the frame buffer */
+void handleScreen(){
+  switch(appState.screen) {
+    case FAVOURITE:
+      handleScreenFavourite();
+      break;
+    case PASSING_TIME:
+      handleScreenPassingTime();
+      break;
+    case STOP_SEARCH:
+      handleScreenStopSearch();
+      break;
+    default:
+      appState.screen = FAVOURITE;
+  }
+  displayEndOfRecord();
+  if(powerManager.isVoltageLow()){
+    lcdFrame.printChar(LCD_COLUMNS - 1, 0, LOW_BATTERY_CHAR);
+  }
+}
+
+/** Snapshot task, every SNAPSHOT_INTERVAL_SEC: the passing times of the favourites are written when they changed */
+void saveSnapshot(){
+  snapshot.save(passingTimeState.passingTimeResponses, NUMBER_OF_FAVOURITES);
+}
+
+void printBootTimes(){
+  Serial.print(F("[BOOT] WiFi ("));
+  Serial.print(bootState.fastConnect ? F("cached") : F("scan"));
+  Serial.print(F(") in ms: "));
+  Serial.print(bootState.wifiConnectedAt);
+  Serial.print(F(" time: "));
+  Serial.print(bootState.timeRestored ? F("restored") : (isTimeSet() ? F("ntp") : F("not set")));
+  Serial.print(F(" first screen in ms: "));
+  Serial.println(bootState.firstScreenAt);
+}
+
+/** Render task, every RENDER_INTERVAL_MS: the changed cells of the frame buffer are sent to the LCD */
+void render(){
+  METRICS_BEGIN(METRIC_LCD);
+  lcdFrame.flush();
+  if(bootState.firstScreenAt == 0 && uiTask.isEnabled() && lcdFrame.getLastFrameI2cBytes() > 0){
+    // millis() starts with the boot
+    bootState.firstScreenAt = millis();
+    printBootTimes();
+  }
+  if(lcdFrame.getLastFrameI2cBytes() > 0){
+    METRICS_END(METRIC_LCD);
   }else{
-    appState.line2 = F("----------------");
+    METRICS_DISCARD(METRIC_LCD);
+  }
+  METRICS_POLL_SERIAL();
+  if(appState.inputAt != 0){
+    // Time from the button edge to the LCD showing its effect
+    if(lcdFrame.getLastFrameI2cBytes() > 0){
+      appState.lastInputLatency = millis() - appState.inputAt;
+      appState.maxInputLatency = max(appState.maxInputLatency, appState.lastInputLatency);
+      if(DEBUG){
+        Serial.print(F("Input latency (ms): "));
+        Serial.print(appState.lastInputLatency);
+        Serial.print(F(" max: "));
+        Serial.print(appState.maxInputLatency);
+        Serial.print(F(" dropped edges: "));
+        Serial.println(buttonInput.getDroppedEdges());
+      }
+    }
+    appState.inputAt = 0;
+  }
+  if(DEBUG && lcdFrame.getLastFrameI2cBytes() > 0){
+    Serial.print(F("LCD frame: "));
+    Serial.print(lcdFrame.getLastFrameI2cBytes());
+    Serial.print(F(" I2C bytes instead of "));
+    Serial.println(LcdFrameBuffer::getFullRedrawI2cBytes());
   }
-  lcd.print(appState.line1);
-  lcd.setCursor(0,1);
-  lcd.print(appState.line2);
 }
 
 void setup() {
@@ -432,32 +1047,59 @@ void setup() {
   Serial.println(APP_VERSION);
   if(DEBUG)Serial.println(F("Debug mode"));
   
-  pinMode(UP_BUTTON, INPUT);
-  pinMode(SELECT_BUTTON, INPUT); 
-  pinMode(DOWN_BUTTON, INPUT); 
+  buttonInput.add(UP_BUTTON, true);
+  buttonInput.add(SELECT_BUTTON, false);
+  buttonInput.add(DOWN_BUTTON, true);
+  buttonInput.begin();
   
   lcd.init();   // initializing the LCD
   lcd.backlight(); // Enable or Turn On the backlight 
   lcd.createChar(1, down_arrow);
+  lcd.createChar(2, low_battery);
+  lcd.createChar(3, clock_glyph);
+  lcdFrame.invalidate();
   
-  if(!connectToWifi()){
-    Serial.println(F("Fail to connect. Wrong password? Reset micro controller."));
-    ESP.restart();
-  }
-  configureTime();
   initializeEeprom();
   initializeToken();
+  // The displays sharing the key don't retry together
+  requestBudget.seed(ESP.getChipId() ^ ESP.getCycleCount());
+  bootCache.begin();
+  bootState.timeRestored = bootCache.restoreTime();
+  if(bootState.timeRestored){
+    anchorTime();
+    Serial.print(F("Time restored from the boot cache: "));
+    printTime();
+  }
+  settimeofday_cb(onTimeSynced);
+  // Displayed until the first fetch, the searched stop is not kept
+  snapshot.begin();
+  if(snapshot.load(passingTimeState.passingTimeResponses, NUMBER_OF_FAVOURITES, timeService.now(millis()))){
+    Serial.println(F("Passing times restored from the snapshot"));
+  }
+  configureTime();
+  powerManager.begin();
+
+  // Run in this order on each pass. The tasks of the app are started once WiFi is connected.
+  scheduler.add(&wifiTask);
+  scheduler.add(&timeTask);
+  scheduler.add(&networkTask);
+  scheduler.add(&tokenTask);
+  scheduler.add(&powerTask);
+  scheduler.add(&uiTask);
+  scheduler.add(&renderTask);
+  scheduler.add(&snapshotTask);
+#if ENABLE_LAN_SERVER
+  for(int i = 0; i < NUMBER_OF_FAVOURITES; i++){
+    favouriteStopIds[i] = favourites[i].stopId;
+  }
+  scheduler.add(&lanTask);
+  scheduler.add(&hubTask);
+#endif
+  wifiTask.every(100);
+  timeTask.every(1000);
+  renderTask.every(RENDER_INTERVAL_MS);
 }
 
 void loop() {
-  switch(appState.screen) {
-    case FAVOURITE:
-      handleScreenFavourite();
-      break;
-    case PASSING_TIME:
-      handleScreenPassingTime();
-      break;
-    default:
-      appState.screen = FAVOURITE;
-  }
+  scheduler.run();
 }
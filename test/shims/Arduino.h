@@ -0,0 +1,815 @@
+#pragma once
+/** Arduino core of the ESP8266 on the host, for the native environment.
+ *  Only what the firmware uses, with the behaviour it relies on: String allocates from the simulated heap
+ *  (with the small string optimisation of the core), time and pins come from the simulated board.
+ */
+#include "NativeBoard.h"
+#include "NativeHeap.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <type_traits>
+#include <math.h>
+
+// Flash is plain memory, same definitions as include/Pgmspace.h
+#define PROGMEM
+#define PGM_P const char*
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_dword(address) (*(const uint32_t*)(address))
+#define memcpy_P memcpy
+#define strncpy_P strncpy
+#define strncmp_P strncmp
+#define strcpy_P strcpy
+#define strcmp_P strcmp
+#define strlen_P strlen
+#define PSTR(s) (s)
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(PSTR(string_literal)))
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define ADC_MODE(mode)
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define RISING 1
+#define FALLING 2
+#define CHANGE 3
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// NodeMCU pins
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+#define A0 17
+
+/** By value: the arguments are often temporaries, e.g. min(count - start, MAX) */
+template<typename A, typename B> typename std::common_type<A, B>::type min(A a, B b){
+  return a < b ? a : b;
+}
+
+template<typename A, typename B> typename std::common_type<A, B>::type max(A a, B b){
+  return a > b ? a : b;
+}
+
+// Time and pins
+
+inline unsigned long micros(){
+  return (unsigned long)nativeBoard.getMicros();
+}
+
+inline unsigned long millis(){
+  return (unsigned long)(nativeBoard.getMicros() / 1000);
+}
+
+inline void yield(){
+  nativeBoard.onYield();
+}
+
+inline void delay(unsigned long ms){
+  nativeBoard.advance(ms);
+  nativeBoard.onYield();
+}
+
+inline void delayMicroseconds(unsigned int us){
+  nativeBoard.advanceMicros(us);
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode){
+  nativeBoard.setPinMode(pin, mode);
+}
+
+inline int digitalRead(uint8_t pin){
+  return nativeBoard.readPin(pin);
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t level){
+  nativeBoard.setPin(pin, level);
+}
+
+inline int digitalPinToInterrupt(uint8_t pin){
+  return pin;
+}
+
+inline void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode){
+  nativeBoard.attach(pin, handler, arg, mode);
+}
+
+inline void attachInterrupt(uint8_t pin, void (*handler)(void), int mode){
+  nativeBoard.attach(pin, [](void* arg){ ((void (*)(void))arg)(); }, (void*)handler, mode);
+}
+
+inline void detachInterrupt(uint8_t pin){
+  nativeBoard.detach(pin);
+}
+
+inline void noInterrupts(){
+  nativeBoard.disableInterrupts();
+}
+
+inline void interrupts(){
+  nativeBoard.enableInterrupts();
+}
+
+inline int analogRead(uint8_t /*pin*/){
+  return 0;
+}
+
+inline uint32_t nativeRandomState = 1;
+
+inline void randomSeed(unsigned long seed){
+  nativeRandomState = seed != 0 ? (uint32_t)seed : 1;
+}
+
+inline long random(long howBig){
+  // xorshift32
+  nativeRandomState ^= nativeRandomState << 13;
+  nativeRandomState ^= nativeRandomState >> 17;
+  nativeRandomState ^= nativeRandomState << 5;
+  return howBig > 0 ? (long)(nativeRandomState % howBig) : 0;
+}
+
+inline long random(long howSmall, long howBig){
+  return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall);
+}
+
+/** Start SNTP: the first synchronisation is reported on the next yield(), then every hour.
+ *  The offsets set the time zone of localtime(), through TZ like the core does.
+ */
+inline void configTime(int timezone, int daylightOffset, const char* /*server1*/, const char* /*server2*/ = NULL, const char* /*server3*/ = NULL){
+  int offset = timezone + daylightOffset;
+  char tz[24];
+  // POSIX TZ: the offset to add to the local time to get UTC
+  snprintf(tz, sizeof(tz), "NAT%c%02d:%02d", offset >= 0 ? '-' : '+', abs(offset) / 3600, abs(offset) % 3600 / 60);
+  setenv("TZ", tz, 1);
+  tzset();
+  nativeBoard.startSntp();
+}
+
+/** time(nullptr) of the firmware reads the wall clock of the board, this overload is a better match than the one of the C library */
+inline time_t time(decltype(nullptr)){
+  return (time_t)(nativeBoard.getWallMicros() / 1000000);
+}
+
+// String
+
+/** Arduino String. Up to 11 characters are kept in the object (small string optimisation of the ESP8266 core),
+ *  longer ones in a buffer of the simulated heap, grown to the exact size needed like the core does.
+ */
+class String {
+  static const unsigned int SSO_SIZE = 12;
+  char* heapBuffer = NULL;
+  char inlineBuffer[SSO_SIZE];
+  unsigned int capacity = SSO_SIZE - 1;
+  unsigned int len = 0;
+
+  public:
+    String(const char* text = ""){
+      inlineBuffer[0] = '\0';
+      if(text != NULL){
+        copy(text, strlen(text));
+      }
+    }
+
+    String(const String& other){
+      inlineBuffer[0] = '\0';
+      copy(other.c_str(), other.len);
+    }
+
+    String(String&& other){
+      inlineBuffer[0] = '\0';
+      move(other);
+    }
+
+    String(const __FlashStringHelper* text) :
+      String(reinterpret_cast<const char*>(text))
+    {
+    }
+
+    explicit String(char c){
+      char text[2] = {c, '\0'};
+      inlineBuffer[0] = '\0';
+      copy(text, 1);
+    }
+
+    explicit String(int value, unsigned char base = 10) : String((long)value, base) {}
+    explicit String(unsigned int value, unsigned char base = 10) : String((unsigned long)value, base) {}
+    explicit String(unsigned char value, unsigned char base = 10) : String((unsigned long)value, base) {}
+
+    explicit String(long value, unsigned char base = 10){
+      char text[2 + 8 * sizeof(long)];
+      if(base == 10){
+        snprintf(text, sizeof(text), "%ld", value);
+      }else{
+        formatUnsigned((unsigned long)value, base, text);
+      }
+      inlineBuffer[0] = '\0';
+      copy(text, strlen(text));
+    }
+
+    explicit String(unsigned long value, unsigned char base = 10){
+      char text[1 + 8 * sizeof(unsigned long)];
+      formatUnsigned(value, base, text);
+      inlineBuffer[0] = '\0';
+      copy(text, strlen(text));
+    }
+
+    explicit String(double value, unsigned char decimalPlaces = 2){
+      char text[64];
+      snprintf(text, sizeof(text), "%.*f", decimalPlaces, value);
+      inlineBuffer[0] = '\0';
+      copy(text, strlen(text));
+    }
+
+    ~String(){
+      nativeHeap().release(heapBuffer);
+    }
+
+    String& operator=(const String& other){
+      if(this != &other){
+        copy(other.c_str(), other.len);
+      }
+      return *this;
+    }
+
+    String& operator=(String&& other){
+      if(this != &other){
+        move(other);
+      }
+      return *this;
+    }
+
+    String& operator=(const char* text){
+      copy(text != NULL ? text : "", text != NULL ? strlen(text) : 0);
+      return *this;
+    }
+
+    /** Make room for size characters. False when the heap can't serve it */
+    bool reserve(unsigned int size){
+      if(size <= capacity){
+        return true;
+      }
+      char* buffer = (char*)nativeHeap().reallocate(heapBuffer, size + 1);
+      if(buffer == NULL){
+        return false;
+      }
+      if(heapBuffer == NULL){
+        memcpy(buffer, inlineBuffer, len + 1);
+      }
+      heapBuffer = buffer;
+      capacity = size;
+      return true;
+    }
+
+    bool concat(const char* text, unsigned int length){
+      if(length == 0){
+        return true;
+      }
+      if(!reserve(len + length)){
+        return false;
+      }
+      // The text may be a part of this string
+      memmove(buffer() + len, text, length);
+      len += length;
+      buffer()[len] = '\0';
+      return true;
+    }
+
+    bool concat(const String& other){
+      return concat(other.c_str(), other.len);
+    }
+
+    bool concat(const char* text){
+      return text == NULL || concat(text, strlen(text));
+    }
+
+    bool concat(char c){
+      return concat(&c, 1);
+    }
+
+    bool concat(int value){
+      return concat(String(value));
+    }
+
+    bool concat(long value){
+      return concat(String(value));
+    }
+
+    bool concat(unsigned int value){
+      return concat(String(value));
+    }
+
+    bool concat(unsigned long value){
+      return concat(String(value));
+    }
+
+    String& operator+=(const String& other){ concat(other); return *this; }
+    String& operator+=(const char* text){ concat(text); return *this; }
+    String& operator+=(char c){ concat(c); return *this; }
+    String& operator+=(int value){ concat(value); return *this; }
+    String& operator+=(long value){ concat(value); return *this; }
+    String& operator+=(unsigned int value){ concat(value); return *this; }
+    String& operator+=(unsigned long value){ concat(value); return *this; }
+    String& operator+=(const __FlashStringHelper* text){ concat(reinterpret_cast<const char*>(text)); return *this; }
+
+    friend String operator+(const String& left, const String& right){
+      String result(left);
+      result += right;
+      return result;
+    }
+
+    friend String operator+(const String& left, const char* right){
+      String result(left);
+      result += right;
+      return result;
+    }
+
+    friend String operator+(const char* left, const String& right){
+      String result(left);
+      result += right;
+      return result;
+    }
+
+    friend String operator+(const String& left, char right){
+      String result(left);
+      result += right;
+      return result;
+    }
+
+    friend String operator+(const String& left, const __FlashStringHelper* right){
+      String result(left);
+      result += right;
+      return result;
+    }
+
+    const char* c_str() const {
+      return heapBuffer != NULL ? heapBuffer : inlineBuffer;
+    }
+
+    unsigned int length() const {
+      return len;
+    }
+
+    char charAt(unsigned int index) const {
+      return index < len ? c_str()[index] : '\0';
+    }
+
+    char operator[](unsigned int index) const {
+      return charAt(index);
+    }
+
+    bool equals(const String& other) const {
+      return len == other.len && strcmp(c_str(), other.c_str()) == 0;
+    }
+
+    bool equals(const char* text) const {
+      return strcmp(c_str(), text != NULL ? text : "") == 0;
+    }
+
+    bool operator==(const String& other) const { return equals(other); }
+    bool operator==(const char* text) const { return equals(text); }
+    bool operator!=(const String& other) const { return !equals(other); }
+    bool operator!=(const char* text) const { return !equals(text); }
+    bool operator<(const String& other) const { return strcmp(c_str(), other.c_str()) < 0; }
+    bool operator>(const String& other) const { return strcmp(c_str(), other.c_str()) > 0; }
+
+    bool startsWith(const String& prefix) const {
+      return prefix.len <= len && strncmp(c_str(), prefix.c_str(), prefix.len) == 0;
+    }
+
+    bool endsWith(const String& suffix) const {
+      return suffix.len <= len && strcmp(c_str() + len - suffix.len, suffix.c_str()) == 0;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const {
+      if(from >= len){
+        return -1;
+      }
+      const char* found = strchr(c_str() + from, c);
+      return found != NULL ? (int)(found - c_str()) : -1;
+    }
+
+    int indexOf(const String& text, unsigned int from = 0) const {
+      if(from > len){
+        return -1;
+      }
+      const char* found = strstr(c_str() + from, text.c_str());
+      return found != NULL ? (int)(found - c_str()) : -1;
+    }
+
+    String substring(unsigned int from, unsigned int to) const {
+      if(from > to){
+        unsigned int swap = from;
+        from = to;
+        to = swap;
+      }
+      if(from >= len){
+        return String();
+      }
+      if(to > len){
+        to = len;
+      }
+      String result;
+      result.concat(c_str() + from, to - from);
+      return result;
+    }
+
+    String substring(unsigned int from) const {
+      return substring(from, len);
+    }
+
+    long toInt() const {
+      return atol(c_str());
+    }
+
+    float toFloat() const {
+      return (float)atof(c_str());
+    }
+
+    void toCharArray(char* buffer, unsigned int size, unsigned int from = 0) const {
+      if(size == 0){
+        return;
+      }
+      unsigned int count = from < len ? len - from : 0;
+      if(count > size - 1){
+        count = size - 1;
+      }
+      memcpy(buffer, c_str() + from, count);
+      buffer[count] = '\0';
+    }
+
+    void trim(){
+      const char* text = c_str();
+      unsigned int start = 0;
+      while(start < len && isspace((unsigned char)text[start])){
+        start++;
+      }
+      unsigned int end = len;
+      while(end > start && isspace((unsigned char)text[end - 1])){
+        end--;
+      }
+      memmove(buffer(), text + start, end - start);
+      len = end - start;
+      buffer()[len] = '\0';
+    }
+
+    void toUpperCase(){
+      for(unsigned int i = 0; i < len; i++){
+        buffer()[i] = toupper((unsigned char)buffer()[i]);
+      }
+    }
+
+  private:
+    char* buffer(){
+      return heapBuffer != NULL ? heapBuffer : inlineBuffer;
+    }
+
+    void copy(const char* text, unsigned int length){
+      if(!reserve(length)){
+        len = 0;
+        buffer()[0] = '\0';
+        return;
+      }
+      memmove(buffer(), text, length);
+      len = length;
+      buffer()[len] = '\0';
+    }
+
+    void move(String& other){
+      nativeHeap().release(heapBuffer);
+      heapBuffer = other.heapBuffer;
+      capacity = other.capacity;
+      len = other.len;
+      memcpy(inlineBuffer, other.inlineBuffer, SSO_SIZE);
+      other.heapBuffer = NULL;
+      other.capacity = SSO_SIZE - 1;
+      other.len = 0;
+      other.inlineBuffer[0] = '\0';
+    }
+
+    static void formatUnsigned(unsigned long value, unsigned char base, char* text){
+      char digits[1 + 8 * sizeof(unsigned long)];
+      int i = 0;
+      do{
+        int digit = value % base;
+        digits[i++] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        value /= base;
+      }while(value > 0);
+      int j = 0;
+      while(i > 0){
+        text[j++] = digits[--i];
+      }
+      text[j] = '\0';
+    }
+};
+
+// Print, Stream, Serial
+
+class Print;
+
+class Printable {
+  public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& out) const = 0;
+};
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t* data, size_t length){
+      size_t written = 0;
+      while(written < length && write(data[written]) == 1){
+        written++;
+      }
+      return written;
+    }
+
+    size_t write(const char* text){
+      return text == NULL ? 0 : write((const uint8_t*)text, strlen(text));
+    }
+
+    size_t write(const char* data, size_t length){
+      return write((const uint8_t*)data, length);
+    }
+
+    virtual void flush() {}
+
+    size_t print(const __FlashStringHelper* text){ return write(reinterpret_cast<const char*>(text)); }
+    size_t print(const String& text){ return write((const uint8_t*)text.c_str(), text.length()); }
+    size_t print(const char* text){ return write(text); }
+    size_t print(char c){ return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = DEC){ return printNumber((unsigned long)value, base); }
+    size_t print(int value, int base = DEC){ return printSigned(value, base); }
+    size_t print(unsigned int value, int base = DEC){ return printNumber((unsigned long)value, base); }
+    size_t print(long value, int base = DEC){ return printSigned(value, base); }
+    size_t print(unsigned long value, int base = DEC){ return printNumber(value, base); }
+    size_t print(long long value, int base = DEC){ return printSigned((long)value, base); }
+    size_t print(unsigned long long value, int base = DEC){ return printNumber((unsigned long)value, base); }
+    size_t print(double value, int digits = 2){
+      char text[64];
+      snprintf(text, sizeof(text), "%.*f", digits, value);
+      return write(text);
+    }
+    size_t print(const Printable& value){ return value.printTo(*this); }
+
+    template<typename T> size_t println(const T& value){
+      size_t n = print(value);
+      return n + println();
+    }
+
+    template<typename T> size_t println(const T& value, int format){
+      size_t n = print(value, format);
+      return n + println();
+    }
+
+    size_t println(const Printable& value){
+      size_t n = print(value);
+      return n + println();
+    }
+
+    size_t println(){
+      return write("\r\n");
+    }
+
+    /** Formatted in a small buffer on the stack, or on the heap when longer, like the core */
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))){
+      char small[64];
+      va_list arguments;
+      va_start(arguments, format);
+      int length = vsnprintf(small, sizeof(small), format, arguments);
+      va_end(arguments);
+      if(length < 0){
+        return 0;
+      }
+      if((size_t)length < sizeof(small)){
+        return write((const uint8_t*)small, length);
+      }
+      char* large = (char*)nativeHeap().allocate(length + 1);
+      if(large == NULL){
+        return 0;
+      }
+      va_start(arguments, format);
+      vsnprintf(large, length + 1, format, arguments);
+      va_end(arguments);
+      size_t written = write((const uint8_t*)large, length);
+      nativeHeap().release(large);
+      return written;
+    }
+
+  private:
+    size_t printSigned(long value, int base){
+      if(base == DEC && value < 0){
+        return print('-') + printNumber((unsigned long)(-value), base);
+      }
+      return printNumber((unsigned long)value, base);
+    }
+
+    size_t printNumber(unsigned long value, int base){
+      char digits[1 + 8 * sizeof(unsigned long)];
+      int i = 0;
+      if(base < 2){
+        base = DEC;
+      }
+      do{
+        int digit = value % base;
+        digits[i++] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        value /= base;
+      }while(value > 0);
+      size_t n = 0;
+      while(i > 0){
+        n += write((uint8_t)digits[--i]);
+      }
+      return n;
+    }
+};
+
+class Stream : public Print {
+  protected:
+    unsigned long timeout = 1000;
+
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    virtual size_t readBytes(char* buffer, size_t length){
+      size_t count = 0;
+      while(count < length && available() > 0){
+        buffer[count++] = (char)read();
+      }
+      return count;
+    }
+
+    size_t readBytes(uint8_t* buffer, size_t length){
+      return readBytes((char*)buffer, length);
+    }
+
+    void setTimeout(unsigned long timeout){
+      this->timeout = timeout;
+    }
+};
+
+#define NATIVE_SERIAL_CAPTURE 4096
+#define NATIVE_SERIAL_INPUT 256
+
+/** Serial of the board. The output is kept in a rolling capture for the tests, and written to stdout
+ *  when the NATIVE_SERIAL_ECHO environment variable is set.
+ */
+class HardwareSerial : public Stream {
+  char capture[NATIVE_SERIAL_CAPTURE + 1];
+  size_t captureLength = 0;
+  unsigned long bytesWritten = 0;
+  char input[NATIVE_SERIAL_INPUT];
+  size_t inputStart = 0;
+  size_t inputLength = 0;
+  bool echo = getenv("NATIVE_SERIAL_ECHO") != NULL;
+
+  public:
+    void begin(unsigned long /*baud*/){
+    }
+
+    size_t write(uint8_t c) override {
+      if(echo){
+        fputc(c, stdout);
+      }
+      if(captureLength == NATIVE_SERIAL_CAPTURE){
+        // Keep the second half
+        memmove(capture, capture + NATIVE_SERIAL_CAPTURE / 2, NATIVE_SERIAL_CAPTURE / 2);
+        captureLength = NATIVE_SERIAL_CAPTURE / 2;
+      }
+      capture[captureLength++] = (char)c;
+      bytesWritten++;
+      return 1;
+    }
+
+    using Print::write;
+
+    int available() override {
+      return (int)inputLength;
+    }
+
+    int read() override {
+      if(inputLength == 0){
+        return -1;
+      }
+      inputLength--;
+      return (uint8_t)input[inputStart++];
+    }
+
+    int peek() override {
+      return inputLength > 0 ? (uint8_t)input[inputStart] : -1;
+    }
+
+    operator bool(){
+      return true;
+    }
+
+    /** Characters received from the serial monitor */
+    void receive(const char* text){
+      memmove(input, input + inputStart, inputLength);
+      inputStart = 0;
+      size_t length = strlen(text);
+      if(inputLength + length > sizeof(input)){
+        length = sizeof(input) - inputLength;
+      }
+      memcpy(input + inputLength, text, length);
+      inputLength += length;
+    }
+
+    /** True when the text was printed since the last clearOutput(), within the last NATIVE_SERIAL_CAPTURE / 2 bytes at least */
+    bool outputContains(const char* text){
+      capture[captureLength] = '\0';
+      return strstr(capture, text) != NULL;
+    }
+
+    void clearOutput(){
+      captureLength = 0;
+    }
+
+    unsigned long getBytesWritten(){
+      return bytesWritten;
+    }
+};
+
+inline HardwareSerial Serial;
+
+#include "IPAddress.h"
+
+// ESP
+
+/** ESP object of the core: the heap figures come from the simulated heap, the rest from the board */
+class EspClass {
+  public:
+    uint32_t getFreeHeap(){
+      return nativeHeap().getFree();
+    }
+
+    uint32_t getMaxFreeBlockSize(){
+      return nativeHeap().getMaxFreeBlock();
+    }
+
+    uint8_t getHeapFragmentation(){
+      return nativeHeap().getFragmentation();
+    }
+
+    void getHeapStats(uint32_t* free, uint16_t* maxBlock, uint8_t* fragmentation){
+      *free = getFreeHeap();
+      uint32_t block = getMaxFreeBlockSize();
+      *maxBlock = block > 0xFFFF ? 0xFFFF : (uint16_t)block;
+      *fragmentation = getHeapFragmentation();
+    }
+
+    void restart(){
+      nativeBoard.restart();
+    }
+
+    void reset(){
+      nativeBoard.restart();
+    }
+
+    uint16_t getVcc(){
+      return nativeBoard.getVcc();
+    }
+
+    uint32_t getCycleCount(){
+      return (uint32_t)(nativeBoard.getMicros() * 80);
+    }
+
+    uint32_t getChipId(){
+      return 0x00C0FFEE;
+    }
+
+    bool rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size){
+      return nativeBoard.readRtcMemory(offset, data, size);
+    }
+
+    bool rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size){
+      return nativeBoard.writeRtcMemory(offset, data, size);
+    }
+
+    String getResetReason(){
+      return String(nativeBoard.getResetReason() == 0 ? "Power On" : "Software/System restart");
+    }
+};
+
+inline EspClass ESP;
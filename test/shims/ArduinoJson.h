@@ -0,0 +1,279 @@
+#pragma once
+#include <Arduino.h>
+
+/** Sizes of ArduinoJson 5 on the ESP8266 (4 byte pointers) */
+#define JSON_OBJECT_SIZE(n) (8 + 16 * (n))
+#define JSON_ARRAY_SIZE(n) (8 + 12 * (n))
+
+/** Value of a member, the text stays in the parsed input like ArduinoJson 5 (zero copy) */
+class JsonVariant {
+  const char* text;
+  bool quoted;
+
+  public:
+    JsonVariant(const char* text = NULL, bool quoted = false) :
+      text(text),
+      quoted(quoted)
+    {
+    }
+
+    bool success() const {
+      return text != NULL;
+    }
+
+    bool is_string() const {
+      return text != NULL && quoted;
+    }
+
+    template<typename T> T as() const;
+};
+
+template<> inline const char* JsonVariant::as<const char*>() const {
+  return quoted ? text : NULL;
+}
+
+template<> inline String JsonVariant::as<String>() const {
+  return String(text != NULL && strcmp(text, "null") != 0 ? text : "");
+}
+
+template<> inline long JsonVariant::as<long>() const {
+  return text != NULL ? strtol(text, NULL, 10) : 0;
+}
+
+template<> inline unsigned long JsonVariant::as<unsigned long>() const {
+  return text != NULL ? strtoul(text, NULL, 10) : 0;
+}
+
+template<> inline int JsonVariant::as<int>() const {
+  return (int)as<long>();
+}
+
+template<> inline unsigned int JsonVariant::as<unsigned int>() const {
+  return (unsigned int)as<unsigned long>();
+}
+
+template<> inline double JsonVariant::as<double>() const {
+  return text != NULL ? strtod(text, NULL) : 0;
+}
+
+template<> inline bool JsonVariant::as<bool>() const {
+  return text != NULL && strcmp(text, "true") == 0;
+}
+
+struct JsonPair {
+  const char* key;
+  const char* value;
+  bool quoted;
+  JsonPair* next;
+};
+
+/** Flat object: the values are strings, numbers or literals. Nested values are not supported by the shim. */
+class JsonObject {
+  JsonPair* first = NULL;
+  bool valid;
+
+  friend class DynamicJsonBuffer;
+
+  public:
+    JsonObject(bool valid) :
+      valid(valid)
+    {
+    }
+
+    bool success() const {
+      return valid;
+    }
+
+    JsonVariant operator[](const char* key) const {
+      for(JsonPair* pair = first; pair != NULL; pair = pair->next){
+        if(strcmp(pair->key, key) == 0){
+          return JsonVariant(pair->value, pair->quoted);
+        }
+      }
+      return JsonVariant();
+    }
+
+    JsonVariant operator[](const __FlashStringHelper* key) const {
+      return (*this)[reinterpret_cast<const char*>(key)];
+    }
+
+    JsonVariant get(const char* key) const {
+      return (*this)[key];
+    }
+
+    bool containsKey(const char* key) const {
+      return (*this)[key].success();
+    }
+
+    static JsonObject& invalid(){
+      static JsonObject object(false);
+      return object;
+    }
+};
+
+/** Parser and pool of ArduinoJson 5: the nodes are taken from blocks of the simulated heap, the first one of the
+ *  given capacity, the next ones as needed. They are freed with the buffer.
+ */
+class DynamicJsonBuffer {
+  struct Block {
+    Block* next;
+    size_t capacity;
+    size_t used;
+  };
+
+  size_t blockCapacity;
+  Block* head = NULL;
+
+  public:
+    DynamicJsonBuffer(size_t capacity = 256) :
+      blockCapacity(capacity)
+    {
+    }
+
+    DynamicJsonBuffer(const DynamicJsonBuffer&) = delete;
+    DynamicJsonBuffer& operator=(const DynamicJsonBuffer&) = delete;
+
+    ~DynamicJsonBuffer(){
+      clear();
+    }
+
+    void clear(){
+      while(head != NULL){
+        Block* next = head->next;
+        nativeHeap().release(head);
+        head = next;
+      }
+    }
+
+    /** Parse in place: the input is modified and must outlive the object */
+    JsonObject& parseObject(char* json){
+      if(json == NULL){
+        return JsonObject::invalid();
+      }
+      JsonObject* object = new(allocate(sizeof(JsonObject))) JsonObject(true);
+      JsonPair** last = &object->first;
+      char* p = skipSpaces(json);
+      if(*p++ != '{'){
+        return JsonObject::invalid();
+      }
+      p = skipSpaces(p);
+      if(*p == '}'){
+        return *object;
+      }
+      while(true){
+        if(*p != '"'){
+          return JsonObject::invalid();
+        }
+        const char* key = parseString(p);
+        p = key != NULL ? skipSpaces(p) : p;
+        if(key == NULL || *p++ != ':'){
+          return JsonObject::invalid();
+        }
+        p = skipSpaces(p);
+        bool quoted = *p == '"';
+        const char* value;
+        char separator;
+        if(quoted){
+          value = parseString(p);
+          if(value == NULL){
+            return JsonObject::invalid();
+          }
+          p = skipSpaces(p);
+          separator = *p++;
+        }else{
+          if(*p == '{' || *p == '[' || *p == '\0'){
+            return JsonObject::invalid();
+          }
+          value = p;
+          p += strcspn(p, ",} \t\r\n");
+          separator = *p;
+          *p++ = '\0';
+          if(isspace((unsigned char)separator)){
+            p = skipSpaces(p);
+            separator = *p++;
+          }
+        }
+        JsonPair* pair = (JsonPair*)allocate(sizeof(JsonPair));
+        *pair = JsonPair{key, value, quoted, NULL};
+        *last = pair;
+        last = &pair->next;
+        if(separator == '}'){
+          return *object;
+        }
+        if(separator != ','){
+          return JsonObject::invalid();
+        }
+        p = skipSpaces(p);
+      }
+    }
+
+    /** The input is copied in the buffer first */
+    JsonObject& parseObject(const String& json){
+      char* copy = (char*)allocate(json.length() + 1);
+      memcpy(copy, json.c_str(), json.length() + 1);
+      return parseObject(copy);
+    }
+
+    size_t size() const {
+      size_t total = 0;
+      for(Block* block = head; block != NULL; block = block->next){
+        total += block->used;
+      }
+      return total;
+    }
+
+  private:
+    void* allocate(size_t size){
+      size = (size + 7) & ~(size_t)7;
+      if(head == NULL || head->capacity - head->used < size){
+        size_t capacity = size > blockCapacity ? size : blockCapacity;
+        Block* block = (Block*)nativeHeap().allocate(sizeof(Block) + capacity);
+        if(block == NULL){
+          throw std::bad_alloc();
+        }
+        block->next = head;
+        block->capacity = capacity;
+        block->used = 0;
+        head = block;
+      }
+      void* pointer = (uint8_t*)(head + 1) + head->used;
+      head->used += size;
+      return pointer;
+    }
+
+    static char* skipSpaces(char* p){
+      while(isspace((unsigned char)*p)){
+        p++;
+      }
+      return p;
+    }
+
+    /** p is on the opening quote. Unescape in place, p ends after the closing quote. NULL when not terminated. */
+    static const char* parseString(char*& p){
+      char* start = ++p;
+      char* out = start;
+      while(*p != '"'){
+        if(*p == '\0'){
+          return NULL;
+        }
+        char c = *p++;
+        if(c == '\\'){
+          c = *p++;
+          switch(c){
+            case 'n': c = '\n'; break;
+            case 't': c = '\t'; break;
+            case 'r': c = '\r'; break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'u': c = '?'; p += strnlen(p, 4); break;
+            case '\0': return NULL;
+            default: break;
+          }
+        }
+        *out++ = c;
+      }
+      p++;
+      *out = '\0';
+      return start;
+    }
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <Arduino.h>
+
+#define NATIVE_EEPROM_SIZE 4096
+
+/** Flash sector emulating the EEPROM: begin() maps the first bytes, commit() writes them back to flash.
+ *  The content is kept between begin() calls, like the flash across the resets.
+ */
+class EEPROMClass {
+  uint8_t flash[NATIVE_EEPROM_SIZE];
+  uint8_t data[NATIVE_EEPROM_SIZE];
+  size_t size = 0;
+  bool dirty = false;
+  unsigned long commits = 0;
+
+  public:
+    EEPROMClass(){
+      memset(flash, 0xFF, sizeof(flash));
+      memset(data, 0xFF, sizeof(data));
+    }
+
+    void begin(size_t size){
+      this->size = size < NATIVE_EEPROM_SIZE ? size : NATIVE_EEPROM_SIZE;
+      memcpy(data, flash, this->size);
+      dirty = false;
+    }
+
+    uint8_t read(int address){
+      return address >= 0 && (size_t)address < size ? data[address] : 0;
+    }
+
+    void write(int address, uint8_t value){
+      if(address >= 0 && (size_t)address < size && data[address] != value){
+        data[address] = value;
+        dirty = true;
+      }
+    }
+
+    template<typename T> T& get(int address, T& value){
+      if(address >= 0 && address + sizeof(T) <= size){
+        memcpy((void*)&value, data + address, sizeof(T));
+      }
+      return value;
+    }
+
+    template<typename T> const T& put(int address, const T& value){
+      if(address >= 0 && address + sizeof(T) <= size && memcmp(data + address, &value, sizeof(T)) != 0){
+        memcpy(data + address, &value, sizeof(T));
+        dirty = true;
+      }
+      return value;
+    }
+
+    /** Write the sector when something changed, like the core */
+    bool commit(){
+      if(size == 0){
+        return false;
+      }
+      if(dirty){
+        memcpy(flash, data, size);
+        dirty = false;
+        commits++;
+      }
+      return true;
+    }
+
+    size_t length(){
+      return size;
+    }
+
+    /** Sector writes since boot */
+    unsigned long getCommits(){
+      return commits;
+    }
+};
+
+inline EEPROMClass EEPROM;
@@ -0,0 +1,158 @@
+#pragma once
+#include "ESP8266WiFi.h"
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NO_CONTENT 204
+#define HTTP_CODE_MOVED_PERMANENTLY 301
+#define HTTP_CODE_BAD_REQUEST 400
+#define HTTP_CODE_UNAUTHORIZED 401
+#define HTTP_CODE_FORBIDDEN 403
+#define HTTP_CODE_NOT_FOUND 404
+#define HTTP_CODE_TOO_MANY_REQUESTS 429
+#define HTTP_CODE_INTERNAL_SERVER_ERROR 500
+#define HTTP_CODE_SERVICE_UNAVAILABLE 503
+
+#define HTTPC_ERROR_CONNECTION_FAILED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+/** Blocking HTTP/1.0 client of the core, enough to talk to the stub servers from a test.
+ *  The firmware uses HttpFetch, only the codes above are needed by it.
+ */
+class HTTPClient {
+  WiFiClient* client = NULL;
+  String host;
+  uint16_t port = 80;
+  String path;
+  String headers;
+  String body;
+  int size = -1;
+  uint16_t timeout = 5000;
+
+  public:
+    bool begin(WiFiClient& client, const String& url){
+      this->client = &client;
+      const char* text = url.c_str();
+      const char* scheme = strstr(text, "://");
+      port = strncmp(text, "https", 5) == 0 ? 443 : 80;
+      text = scheme != NULL ? scheme + 3 : text;
+      size_t hostLength = strcspn(text, ":/");
+      host = url.substring(text - url.c_str(), text - url.c_str() + hostLength);
+      text += hostLength;
+      if(*text == ':'){
+        port = (uint16_t)atoi(text + 1);
+        text = strchr(text, '/');
+      }
+      path = text != NULL && *text == '/' ? text : "/";
+      headers = "";
+      return host.length() > 0;
+    }
+
+    void end(){
+      if(client != NULL){
+        client->stop();
+      }
+    }
+
+    void setReuse(bool /*reuse*/){
+    }
+
+    void useHTTP10(bool /*http10*/ = true){
+    }
+
+    void setTimeout(uint16_t timeout){
+      this->timeout = timeout;
+    }
+
+    void addHeader(const String& name, const String& value, bool /*first*/ = false, bool /*replace*/ = true){
+      headers += name + ": " + value + "\r\n";
+    }
+
+    int GET(){
+      return sendRequest("GET", NULL);
+    }
+
+    int POST(const String& payload){
+      return sendRequest("POST", &payload);
+    }
+
+    String getString(){
+      return body;
+    }
+
+    int getSize(){
+      return size;
+    }
+
+    bool connected(){
+      return client != NULL && client->connected();
+    }
+
+    WiFiClient& getStream(){
+      return *client;
+    }
+
+    WiFiClient* getStreamPtr(){
+      return client;
+    }
+
+    static String errorToString(int error){
+      switch(error){
+        case HTTPC_ERROR_CONNECTION_FAILED:
+          return String("connection failed");
+        case HTTPC_ERROR_SEND_HEADER_FAILED:
+          return String("send header failed");
+        case HTTPC_ERROR_CONNECTION_LOST:
+          return String("connection lost");
+        case HTTPC_ERROR_READ_TIMEOUT:
+          return String("read Timeout");
+        default:
+          return String();
+      }
+    }
+
+  private:
+    int sendRequest(const char* method, const String* payload){
+      body = "";
+      size = -1;
+      if(!client->connect(host.c_str(), port)){
+        return HTTPC_ERROR_CONNECTION_FAILED;
+      }
+      String request = String(method) + " " + path + " HTTP/1.0\r\nHost: " + host + "\r\nConnection: close\r\n" + headers;
+      if(payload != NULL){
+        request += String("Content-Length: ") + String(payload->length()) + "\r\n\r\n" + *payload;
+      }else{
+        request += "\r\n";
+      }
+      if(client->write((const uint8_t*)request.c_str(), request.length()) != request.length()){
+        return HTTPC_ERROR_SEND_HEADER_FAILED;
+      }
+      // The response ends with the connection
+      String response;
+      unsigned long start = millis();
+      while(client->connected()){
+        int available = client->available();
+        if(available <= 0){
+          if(millis() - start > timeout){
+            client->stop();
+            return HTTPC_ERROR_READ_TIMEOUT;
+          }
+          delay(1);
+          continue;
+        }
+        char buffer[256];
+        int length = client->read((uint8_t*)buffer, available < (int)sizeof(buffer) ? available : (int)sizeof(buffer));
+        response.concat(buffer, length);
+      }
+      client->stop();
+      int separator = response.indexOf("\r\n\r\n");
+      int code = response.startsWith("HTTP/") ? atoi(response.c_str() + response.indexOf(' ') + 1) : 0;
+      if(separator < 0 || code <= 0){
+        return HTTPC_ERROR_CONNECTION_LOST;
+      }
+      body = response.substring(separator + 4);
+      size = body.length();
+      return code;
+    }
+};
@@ -0,0 +1,242 @@
+#pragma once
+#include <Arduino.h>
+#include "NativeNetwork.h"
+
+enum wl_status_t {
+  WL_IDLE_STATUS,
+  WL_NO_SSID_AVAIL,
+  WL_CONNECTED,
+  WL_CONNECT_FAILED,
+  WL_DISCONNECTED
+};
+
+enum WiFiMode_t {
+  WIFI_OFF,
+  WIFI_STA,
+  WIFI_AP,
+  WIFI_AP_STA
+};
+
+enum WiFiSleepType_t {
+  WIFI_NONE_SLEEP,
+  WIFI_LIGHT_SLEEP,
+  WIFI_MODEM_SLEEP
+};
+
+/** TCP client on the simulated network. Copies share the connection, which is closed with the last one
+ *  or by stop(), like the ClientContext of the core.
+ */
+class WiFiClient : public Stream {
+  protected:
+    int socket = -1;
+    /** 0 for a client which connected, 1 for a client returned by WiFiServer::available() */
+    int side = 0;
+
+  public:
+    WiFiClient(){
+    }
+
+    WiFiClient(int socket, int side) :
+      socket(socket),
+      side(side)
+    {
+    }
+
+    WiFiClient(const WiFiClient& other) :
+      socket(other.socket),
+      side(other.side)
+    {
+      nativeNetwork.retain(socket, side);
+    }
+
+    WiFiClient& operator=(const WiFiClient& other){
+      if(this != &other){
+        nativeNetwork.retain(other.socket, other.side);
+        nativeNetwork.release(socket, side);
+        socket = other.socket;
+        side = other.side;
+      }
+      return *this;
+    }
+
+    virtual ~WiFiClient(){
+      nativeNetwork.release(socket, side);
+    }
+
+    virtual int connect(const char* host, uint16_t port){
+      stop();
+      socket = nativeNetwork.open(host, port, false);
+      side = 0;
+      return socket >= 0 ? 1 : 0;
+    }
+
+    virtual int connect(IPAddress ip, uint16_t port){
+      return connect(ip.toString().c_str(), port);
+    }
+
+    virtual uint8_t connected(){
+      return socket >= 0 && nativeNetwork.connected(socket, side) ? 1 : 0;
+    }
+
+    virtual void stop(){
+      nativeNetwork.release(socket, side);
+      socket = -1;
+    }
+
+    size_t write(uint8_t c) override {
+      return write(&c, 1);
+    }
+
+    size_t write(const uint8_t* data, size_t length) override {
+      return socket >= 0 ? nativeNetwork.write(socket, side, data, length) : 0;
+    }
+
+    using Print::write;
+
+    int available() override {
+      return socket >= 0 ? nativeNetwork.available(socket, side) : 0;
+    }
+
+    int read() override {
+      uint8_t c;
+      return read(&c, 1) == 1 ? c : -1;
+    }
+
+    int read(uint8_t* buffer, size_t size){
+      return socket >= 0 ? nativeNetwork.read(socket, side, buffer, size) : -1;
+    }
+
+    int peek() override {
+      return socket >= 0 ? nativeNetwork.peekByte(socket, side) : -1;
+    }
+
+    void setNoDelay(bool /*noDelay*/){
+    }
+
+    operator bool(){
+      return connected();
+    }
+};
+
+/** WiFi station. The connection succeeds NativeNetwork::getWiFiConnectMs() after begin() while the access point
+ *  of the simulated network is up.
+ */
+class ESP8266WiFiClass {
+  WiFiMode_t currentMode = WIFI_OFF;
+  bool started = false;
+  unsigned long startedAt = 0;
+  uint32_t staticIp = 0;
+  uint8_t bssid[6] = {0x02, 0x00, 0x5E, 0x10, 0x20, 0x30};
+  int32_t currentChannel = 6;
+  unsigned long connects = 0;
+
+  public:
+    bool mode(WiFiMode_t mode){
+      currentMode = mode;
+      if(mode == WIFI_OFF){
+        started = false;
+      }
+      return true;
+    }
+
+    WiFiMode_t getMode(){
+      return currentMode;
+    }
+
+    wl_status_t begin(const char* /*ssid*/, const char* /*password*/, int32_t /*channel*/ = 0, const uint8_t* /*bssid*/ = NULL, bool /*connect*/ = true){
+      if(currentMode == WIFI_OFF){
+        currentMode = WIFI_STA;
+      }
+      started = true;
+      startedAt = millis();
+      connects++;
+      return status();
+    }
+
+    bool disconnect(bool /*wifiOff*/ = false){
+      started = false;
+      return true;
+    }
+
+    wl_status_t status(){
+      if(!started || currentMode == WIFI_OFF){
+        return WL_DISCONNECTED;
+      }
+      if(!nativeNetwork.isAccessPointUp()){
+        return WL_NO_SSID_AVAIL;
+      }
+      return millis() - startedAt >= nativeNetwork.getWiFiConnectMs() ? WL_CONNECTED : WL_DISCONNECTED;
+    }
+
+    bool isConnected(){
+      return status() == WL_CONNECTED;
+    }
+
+    bool config(IPAddress local, IPAddress /*gateway*/, IPAddress /*subnet*/, IPAddress /*dns1*/ = IPAddress(), IPAddress /*dns2*/ = IPAddress()){
+      staticIp = local;
+      return true;
+    }
+
+    IPAddress localIP(){
+      return status() == WL_CONNECTED ? IPAddress(staticIp != 0 ? staticIp : (uint32_t)IPAddress(192, 168, 1, 42)) : IPAddress();
+    }
+
+    IPAddress gatewayIP(){
+      return IPAddress(192, 168, 1, 1);
+    }
+
+    IPAddress subnetMask(){
+      return IPAddress(255, 255, 255, 0);
+    }
+
+    IPAddress dnsIP(uint8_t /*index*/ = 0){
+      return IPAddress(192, 168, 1, 1);
+    }
+
+    int32_t channel(){
+      return currentChannel;
+    }
+
+    uint8_t* BSSID(){
+      return bssid;
+    }
+
+    int32_t RSSI(){
+      return -60;
+    }
+
+    int hostByName(const char* /*host*/, IPAddress& address){
+      address = IPAddress(10, 0, 0, 1);
+      return 1;
+    }
+
+    bool setSleepMode(WiFiSleepType_t /*type*/, uint8_t /*listenInterval*/ = 0){
+      return true;
+    }
+
+    bool forceSleepBegin(uint32_t /*us*/ = 0){
+      return mode(WIFI_OFF);
+    }
+
+    bool forceSleepWake(){
+      return true;
+    }
+
+    void persistent(bool /*persistent*/){
+    }
+
+    bool setAutoConnect(bool /*autoConnect*/){
+      return true;
+    }
+
+    /** Calls of begin() since boot */
+    unsigned long getConnects(){
+      return connects;
+    }
+};
+
+inline ESP8266WiFiClass WiFi;
+/** The time servers answer once the station is connected */
+inline bool nativeSntpNeedsWiFi = (nativeBoard.setNetworkCheck([](){ return WiFi.status() == WL_CONNECTED; }), true);
+
+#include "ESP8266WiFiServer.h"
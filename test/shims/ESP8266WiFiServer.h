@@ -0,0 +1,26 @@
+#pragma once
+#include "ESP8266WiFi.h"
+
+/** TCP server of the firmware. The test connects to it with a WiFiClient on the same port. */
+class WiFiServer {
+  uint16_t port;
+
+  public:
+    WiFiServer(uint16_t port) :
+      port(port)
+    {
+    }
+
+    void begin(){
+      nativeNetwork.listen(port);
+    }
+
+    /** The next connection not accepted yet, or a client which is not connected */
+    WiFiClient available(){
+      int socket = nativeNetwork.accept(port);
+      return socket >= 0 ? WiFiClient(socket, 1) : WiFiClient();
+    }
+
+    void setNoDelay(bool /*noDelay*/){
+    }
+};
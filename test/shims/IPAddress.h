@@ -0,0 +1,47 @@
+#pragma once
+#include <Arduino.h>
+
+/** IPv4 address, stored like the core: first byte in the lowest bits */
+class IPAddress : public Printable {
+  uint32_t address;
+
+  public:
+    IPAddress() :
+      address(0)
+    {
+    }
+
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) :
+      address((uint32_t)a | (uint32_t)b << 8 | (uint32_t)c << 16 | (uint32_t)d << 24)
+    {
+    }
+
+    IPAddress(uint32_t address) :
+      address(address)
+    {
+    }
+
+    operator uint32_t() const {
+      return address;
+    }
+
+    uint8_t operator[](int index) const {
+      return (uint8_t)(address >> (8 * index));
+    }
+
+    bool isSet() const {
+      return address != 0;
+    }
+
+    String toString() const {
+      char text[16];
+      snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+      return String(text);
+    }
+
+    size_t printTo(Print& out) const override {
+      char text[16];
+      snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+      return out.print(text);
+    }
+};
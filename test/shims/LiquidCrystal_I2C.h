@@ -0,0 +1,194 @@
+#pragma once
+#include <Arduino.h>
+
+#define NATIVE_LCD_DDRAM_SIZE 128
+/** I2C bytes of one write to the PCF8574 expander: address + data */
+#define NATIVE_I2C_BYTES_PER_EXPANDER_WRITE 2
+/** Time of one I2C byte at 100kHz: 8 bits and the acknowledge */
+#define NATIVE_I2C_BYTE_US 90
+
+/** HD44780 behind a PCF8574, as driven by the LiquidCrystal_I2C library.
+ *  The library sends every command or character as 2 nibbles, each one written 3 times to the expander
+ *  (data, enable high, enable low). The mock counts these writes, advances the board time by the transfer,
+ *  and keeps the display memory so the tests can read what is on the screen.
+ */
+class LiquidCrystal_I2C : public Print {
+  uint8_t address;
+  uint8_t columns;
+  uint8_t rows;
+  char ddram[NATIVE_LCD_DDRAM_SIZE];
+  uint8_t cgram[8][8];
+  /** Address counter, in the CGRAM after a createChar() until the next setCursor() */
+  uint8_t addressCounter = 0;
+  bool inCgram = false;
+  bool backlightOn = false;
+  bool displayOn = false;
+  unsigned long i2cBytes = 0;
+  unsigned long commands = 0;
+  unsigned long characters = 0;
+  unsigned long clears = 0;
+  char rowText[NATIVE_LCD_DDRAM_SIZE + 1];
+
+  public:
+    LiquidCrystal_I2C(uint8_t address, uint8_t columns, uint8_t rows) :
+      address(address),
+      columns(columns),
+      rows(rows)
+    {
+      memset(ddram, ' ', sizeof(ddram));
+      memset(cgram, 0, sizeof(cgram));
+    }
+
+    /** Reset sequence of the library: 4 nibbles to enter the 4 bit mode, then function set, display on, clear, entry mode, home */
+    void init(){
+      expanderWrite(1);
+      expanderWrite(4 * 3);
+      commands += 5;
+      sendBytes(5);
+      displayOn = true;
+      clearMemory();
+      delayMicroseconds(4000);
+    }
+
+    void begin(uint8_t /*columns*/, uint8_t /*rows*/){
+      init();
+    }
+
+    void clear(){
+      command();
+      clears++;
+      clearMemory();
+      delayMicroseconds(2000);
+    }
+
+    void home(){
+      command();
+      addressCounter = 0;
+      inCgram = false;
+      delayMicroseconds(2000);
+    }
+
+    void setCursor(uint8_t column, uint8_t row){
+      static const uint8_t rowOffsets[] = {0x00, 0x40, 0x14, 0x54};
+      if(row >= rows){
+        row = rows - 1;
+      }
+      command();
+      addressCounter = column + rowOffsets[row];
+      inCgram = false;
+    }
+
+    size_t write(uint8_t value) override {
+      sendBytes(1);
+      if(inCgram){
+        cgram[(addressCounter >> 3) & 7][addressCounter & 7] = value;
+        addressCounter = (addressCounter + 1) & 0x3F;
+      }else{
+        ddram[addressCounter % NATIVE_LCD_DDRAM_SIZE] = (char)value;
+        addressCounter = (addressCounter + 1) % NATIVE_LCD_DDRAM_SIZE;
+        characters++;
+      }
+      return 1;
+    }
+
+    using Print::write;
+
+    void createChar(uint8_t location, uint8_t charmap[]){
+      location &= 7;
+      command();
+      inCgram = true;
+      addressCounter = location << 3;
+      for(int i = 0; i < 8; i++){
+        write(charmap[i]);
+      }
+    }
+
+    void backlight(){
+      backlightOn = true;
+      expanderWrite(1);
+    }
+
+    void noBacklight(){
+      backlightOn = false;
+      expanderWrite(1);
+    }
+
+    void display(){
+      command();
+      displayOn = true;
+    }
+
+    void noDisplay(){
+      command();
+      displayOn = false;
+    }
+
+    // Test access
+
+    /** Characters displayed on the row */
+    const char* getRow(uint8_t row){
+      uint8_t offset = row == 0 ? 0x00 : row == 1 ? 0x40 : row == 2 ? 0x14 : 0x54;
+      memcpy(rowText, ddram + offset, columns);
+      rowText[columns] = '\0';
+      return rowText;
+    }
+
+    const uint8_t* getCustomChar(uint8_t location){
+      return cgram[location & 7];
+    }
+
+    bool isBacklight(){
+      return backlightOn;
+    }
+
+    bool isDisplay(){
+      return displayOn;
+    }
+
+    /** Bytes sent on the I2C bus since the last resetCounters() */
+    unsigned long getI2cBytes(){
+      return i2cBytes;
+    }
+
+    unsigned long getCommands(){
+      return commands;
+    }
+
+    unsigned long getCharacters(){
+      return characters;
+    }
+
+    unsigned long getClears(){
+      return clears;
+    }
+
+    void resetCounters(){
+      i2cBytes = 0;
+      commands = 0;
+      characters = 0;
+      clears = 0;
+    }
+
+  private:
+    void command(){
+      commands++;
+      sendBytes(1);
+    }
+
+    /** Each byte to the LCD: 2 nibbles of 3 expander writes */
+    void sendBytes(unsigned long count){
+      expanderWrite(count * 2 * 3);
+    }
+
+    void expanderWrite(unsigned long count){
+      unsigned long bytes = count * NATIVE_I2C_BYTES_PER_EXPANDER_WRITE;
+      i2cBytes += bytes;
+      nativeBoard.advanceMicros(bytes * NATIVE_I2C_BYTE_US);
+    }
+
+    void clearMemory(){
+      memset(ddram, ' ', sizeof(ddram));
+      addressCounter = 0;
+      inCgram = false;
+    }
+};
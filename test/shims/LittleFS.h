@@ -0,0 +1,234 @@
+#pragma once
+#include <Arduino.h>
+
+#define NATIVE_FS_FILES 8
+#define NATIVE_FS_FILE_SIZE 4096
+#define NATIVE_FS_PATH_LENGTH 32
+
+struct NativeFsEntry {
+  bool used;
+  char path[NATIVE_FS_PATH_LENGTH];
+  uint8_t data[NATIVE_FS_FILE_SIZE];
+  size_t size;
+};
+
+/** Open file of the in-memory file system. Copies share the position, like the core. */
+class File : public Stream {
+  struct Handle {
+    NativeFsEntry* entry;
+    size_t position;
+    bool writable;
+  };
+
+  Handle* handle = NULL;
+  int* references = NULL;
+
+  public:
+    File(){
+    }
+
+    File(NativeFsEntry* entry, bool writable){
+      handle = new Handle{entry, 0, writable};
+      references = new int(1);
+    }
+
+    File(const File& other) :
+      handle(other.handle),
+      references(other.references)
+    {
+      if(references != NULL){
+        (*references)++;
+      }
+    }
+
+    File& operator=(const File& other){
+      if(this != &other){
+        release();
+        handle = other.handle;
+        references = other.references;
+        if(references != NULL){
+          (*references)++;
+        }
+      }
+      return *this;
+    }
+
+    ~File(){
+      release();
+    }
+
+    size_t write(uint8_t c) override {
+      return write(&c, 1);
+    }
+
+    size_t write(const uint8_t* data, size_t length) override {
+      if(handle == NULL || handle->entry == NULL || !handle->writable){
+        return 0;
+      }
+      NativeFsEntry* entry = handle->entry;
+      if(length > NATIVE_FS_FILE_SIZE - handle->position){
+        length = NATIVE_FS_FILE_SIZE - handle->position;
+      }
+      memcpy(entry->data + handle->position, data, length);
+      handle->position += length;
+      if(handle->position > entry->size){
+        entry->size = handle->position;
+      }
+      return length;
+    }
+
+    using Print::write;
+
+    int available() override {
+      return handle != NULL && handle->entry != NULL ? (int)(handle->entry->size - handle->position) : 0;
+    }
+
+    int read() override {
+      uint8_t c;
+      return read(&c, 1) == 1 ? c : -1;
+    }
+
+    size_t read(uint8_t* buffer, size_t size){
+      size_t length = (size_t)available();
+      if(length > size){
+        length = size;
+      }
+      if(length > 0){
+        memcpy(buffer, handle->entry->data + handle->position, length);
+        handle->position += length;
+      }
+      return length;
+    }
+
+    int peek() override {
+      return available() > 0 ? handle->entry->data[handle->position] : -1;
+    }
+
+    size_t size(){
+      return handle != NULL && handle->entry != NULL ? handle->entry->size : 0;
+    }
+
+    void close(){
+      if(handle != NULL){
+        handle->entry = NULL;
+      }
+    }
+
+    operator bool() const {
+      return handle != NULL && handle->entry != NULL;
+    }
+
+  private:
+    void release(){
+      if(references != NULL && --(*references) == 0){
+        delete handle;
+        delete references;
+      }
+      handle = NULL;
+      references = NULL;
+    }
+};
+
+/** Flash file system held in memory: a few small files, kept across begin() calls like the flash across the resets.
+ *  Writes are counted to check the wear caused by the firmware. The tests can corrupt or remove the files.
+ */
+class FS {
+  NativeFsEntry entries[NATIVE_FS_FILES];
+  bool mountable = true;
+  unsigned long fileWrites = 0;
+
+  public:
+    FS(){
+      memset(entries, 0, sizeof(entries));
+    }
+
+    bool begin(){
+      return mountable;
+    }
+
+    void end(){
+    }
+
+    /** "r" or "w", the other modes are not used by the firmware */
+    File open(const char* path, const char* mode){
+      NativeFsEntry* entry = find(path);
+      if(mode[0] == 'r'){
+        return entry != NULL ? File(entry, false) : File();
+      }
+      if(entry == NULL){
+        entry = create(path);
+        if(entry == NULL){
+          return File();
+        }
+      }
+      entry->size = 0;
+      fileWrites++;
+      return File(entry, true);
+    }
+
+    bool exists(const char* path){
+      return find(path) != NULL;
+    }
+
+    bool remove(const char* path){
+      NativeFsEntry* entry = find(path);
+      if(entry == NULL){
+        return false;
+      }
+      entry->used = false;
+      return true;
+    }
+
+    bool rename(const char* from, const char* to){
+      NativeFsEntry* entry = find(from);
+      if(entry == NULL || strlen(to) >= NATIVE_FS_PATH_LENGTH){
+        return false;
+      }
+      remove(to);
+      strcpy(entry->path, to);
+      return true;
+    }
+
+    // Test control
+
+    /** A failing flash: begin() returns false */
+    void setMountable(bool mountable){
+      this->mountable = mountable;
+    }
+
+    /** Files opened for writing since boot */
+    unsigned long getFileWrites(){
+      return fileWrites;
+    }
+
+    NativeFsEntry* find(const char* path){
+      for(int i = 0; i < NATIVE_FS_FILES; i++){
+        if(entries[i].used && strcmp(entries[i].path, path) == 0){
+          return &entries[i];
+        }
+      }
+      return NULL;
+    }
+
+    void format(){
+      memset(entries, 0, sizeof(entries));
+    }
+
+  private:
+    NativeFsEntry* create(const char* path){
+      if(strlen(path) >= NATIVE_FS_PATH_LENGTH){
+        return NULL;
+      }
+      for(int i = 0; i < NATIVE_FS_FILES; i++){
+        if(!entries[i].used){
+          entries[i].used = true;
+          strcpy(entries[i].path, path);
+          entries[i].size = 0;
+          return &entries[i];
+        }
+      }
+      return NULL;
+    }
+};
+
+inline FS LittleFS;
@@ -0,0 +1,392 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+// The firmware has a global named timezone, the one of the C library is renamed
+#define timezone native_libc_timezone
+#include <time.h>
+#undef timezone
+
+#define NATIVE_PIN_COUNT 17
+#define NATIVE_RTC_MEMORY_SIZE 512
+/** Length of an RTC tick in us << 12, as returned by system_rtc_clock_cali_proc() */
+#define NATIVE_RTC_PERIOD 25600
+/** SNTP synchronises again after this time (in ms), like the ESP8266 core */
+#define NATIVE_SNTP_INTERVAL_MS 3600000UL
+/** UTC time of the network when the board boots, unless set by the test: 2026-03-02 08:00:00 */
+#define NATIVE_DEFAULT_EPOCH 1772438400ULL
+
+/** Interrupt of a pin, as set in the GPIO registers */
+enum NativeInterruptType {
+  NATIVE_INTERRUPT_DISABLED,
+  /** attachInterrupt() with RISING, FALLING or CHANGE */
+  NATIVE_INTERRUPT_EDGE,
+  /** gpio_pin_wakeup_enable() with GPIO_PIN_INTR_HILEVEL: fires as long as the pin is high */
+  NATIVE_INTERRUPT_HIGH_LEVEL,
+  NATIVE_INTERRUPT_LOW_LEVEL
+};
+
+typedef void (*NativeInterruptHandler)(void*);
+/** Called by wifi_fpm_do_sleep(): the test pushes a button and returns the time slept in ms */
+typedef unsigned long (*NativeSleepHandler)();
+
+/** The simulated board behind the Arduino shims.
+ *  - time only moves when the test advances it (advance(), delay()): a run is reproducible and a day takes no time.
+ *    A slowdown factor can make the host CPU time count too, scaled to the ESP8266 (see setCpuSlowdown()).
+ *  - pins are set by the test, their interrupts are dispatched like the GPIO unit does: on each change when
+ *    attached by attachInterrupt(), continuously while the level matches when a wake up level was set.
+ *  - the RTC keeps running during the light sleep, millis() doesn't.
+ *  - the wall clock (time(), gettimeofday()) counts from the boot until SNTP or settimeofday() sets it.
+ *    SNTP gives the time of the network, which runs with the RTC.
+ */
+class NativeBoard {
+  struct Pin {
+    uint8_t level;
+    uint8_t mode;
+    NativeInterruptType interrupt;
+    int edgeMode;
+    NativeInterruptHandler handler;
+    void* arg;
+    bool wakeUp;
+    /** Edge seen while the interrupts were disabled, dispatched once they are enabled again */
+    bool pending;
+  };
+
+  Pin pins[NATIVE_PIN_COUNT];
+  uint64_t nowUs = 0;
+  uint64_t rtcUs = 0;
+  double cpuSlowdown = 0;
+  uint64_t cpuStartNs = 0;
+  int interruptsDisabled = 0;
+  bool inInterrupt = false;
+  unsigned long interruptCalls = 0;
+  unsigned long yields = 0;
+  uint8_t rtcMemory[NATIVE_RTC_MEMORY_SIZE];
+  uint32_t resetReason = 0;
+  unsigned long restarts = 0;
+  void (*timeSyncCallback)() = NULL;
+  uint64_t networkEpochAtBootUs = NATIVE_DEFAULT_EPOCH * 1000000ULL;
+  int64_t wallOffsetUs = 0;
+  bool sntpStarted = false;
+  bool sntpReachable = true;
+  /** Set by the WiFi shim: SNTP only gets an answer once connected */
+  bool (*networkUp)() = NULL;
+  uint64_t nextSntpSyncUs = 0;
+  unsigned long sntpSyncs = 0;
+  unsigned long clockSets = 0;
+  NativeSleepHandler sleepHandler = NULL;
+  bool sleeping = false;
+  unsigned long sleeps = 0;
+  uint16_t vcc = 3300;
+
+  public:
+    NativeBoard(){
+      memset(pins, 0, sizeof(pins));
+      memset(rtcMemory, 0, sizeof(rtcMemory));
+    }
+
+    /** Simulated time since boot, in us */
+    uint64_t getMicros(){
+      if(cpuSlowdown > 0){
+        uint64_t ns = hostCpuNanos();
+        uint64_t elapsedUs = (uint64_t)((ns - cpuStartNs) * cpuSlowdown / 1000);
+        nowUs += elapsedUs;
+        rtcUs += elapsedUs;
+        cpuStartNs = ns;
+      }
+      return nowUs;
+    }
+
+    /** Move the time forward, the RTC too. Pins levels are not touched */
+    void advance(unsigned long ms){
+      advanceMicros((uint64_t)ms * 1000);
+    }
+
+    void advanceMicros(uint64_t us){
+      getMicros();
+      nowUs += us;
+      rtcUs += us;
+      service();
+    }
+
+    /** Count the CPU time of the host too, multiplied by the given factor (about 100 for an ESP8266 at 80MHz
+     *  compared to a desktop core). 0 stops it.
+     */
+    void setCpuSlowdown(double slowdown){
+      getMicros();
+      cpuSlowdown = slowdown;
+      cpuStartNs = hostCpuNanos();
+    }
+
+    /** Monotonic clock of the host in ns, for the benchmarks */
+    static uint64_t hostNanos(){
+      struct timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+    }
+
+    /** CPU time of the test in ns: the host preempting it doesn't count */
+    static uint64_t hostCpuNanos(){
+      struct timespec now;
+      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+      return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+    }
+
+    uint64_t getRtcMicros(){
+      getMicros();
+      return rtcUs;
+    }
+
+    // Pins
+
+    void setPinMode(uint8_t pin, uint8_t mode){
+      if(pin < NATIVE_PIN_COUNT){
+        pins[pin].mode = mode;
+      }
+    }
+
+    uint8_t readPin(uint8_t pin){
+      return pin < NATIVE_PIN_COUNT ? pins[pin].level : 0;
+    }
+
+    /** Drive a pin from outside, e.g. a button. Its interrupt fires at once unless the interrupts are disabled. */
+    void setPin(uint8_t pin, uint8_t level){
+      if(pin >= NATIVE_PIN_COUNT || pins[pin].level == level){
+        return;
+      }
+      pins[pin].level = level;
+      if(pins[pin].interrupt == NATIVE_INTERRUPT_EDGE && edgeMatches(pins[pin].edgeMode, level)){
+        pins[pin].pending = true;
+      }
+      service();
+    }
+
+    void attach(uint8_t pin, NativeInterruptHandler handler, void* arg, int mode){
+      if(pin >= NATIVE_PIN_COUNT){
+        return;
+      }
+      pins[pin].handler = handler;
+      pins[pin].arg = arg;
+      pins[pin].edgeMode = mode;
+      pins[pin].interrupt = NATIVE_INTERRUPT_EDGE;
+      pins[pin].pending = false;
+    }
+
+    void detach(uint8_t pin){
+      if(pin < NATIVE_PIN_COUNT){
+        pins[pin].interrupt = NATIVE_INTERRUPT_DISABLED;
+        pins[pin].handler = NULL;
+      }
+    }
+
+    /** gpio_pin_wakeup_enable() replaces the interrupt type of the pin by a level */
+    void enableWakeUp(uint8_t pin, bool high){
+      if(pin < NATIVE_PIN_COUNT){
+        pins[pin].wakeUp = true;
+        pins[pin].interrupt = high ? NATIVE_INTERRUPT_HIGH_LEVEL : NATIVE_INTERRUPT_LOW_LEVEL;
+      }
+    }
+
+    /** gpio_pin_wakeup_disable() disables the interrupt of the wake up pins, it must be attached again */
+    void disableWakeUp(){
+      for(uint8_t pin = 0; pin < NATIVE_PIN_COUNT; pin++){
+        if(pins[pin].wakeUp){
+          pins[pin].wakeUp = false;
+          pins[pin].interrupt = NATIVE_INTERRUPT_DISABLED;
+        }
+      }
+    }
+
+    NativeInterruptType getInterruptType(uint8_t pin){
+      return pin < NATIVE_PIN_COUNT ? pins[pin].interrupt : NATIVE_INTERRUPT_DISABLED;
+    }
+
+    void disableInterrupts(){
+      interruptsDisabled++;
+    }
+
+    void enableInterrupts(){
+      if(interruptsDisabled > 0){
+        interruptsDisabled--;
+      }
+      service();
+    }
+
+    /** Calls of the pin interrupt handlers since boot */
+    unsigned long getInterruptCalls(){
+      return interruptCalls;
+    }
+
+    /** Dispatch the interrupts due: the pending edges, and the levels which still match */
+    void service(){
+      if(interruptsDisabled > 0 || inInterrupt || sleeping){
+        return;
+      }
+      inInterrupt = true;
+      for(uint8_t pin = 0; pin < NATIVE_PIN_COUNT; pin++){
+        Pin& p = pins[pin];
+        bool due = (p.interrupt == NATIVE_INTERRUPT_EDGE && p.pending)
+          || (p.interrupt == NATIVE_INTERRUPT_HIGH_LEVEL && p.level == 1)
+          || (p.interrupt == NATIVE_INTERRUPT_LOW_LEVEL && p.level == 0);
+        p.pending = false;
+        if(due && p.handler != NULL){
+          interruptCalls++;
+          p.handler(p.arg);
+        }
+      }
+      inInterrupt = false;
+    }
+
+    /** yield() and delay() give the hand to the system: interrupts, SNTP */
+    void onYield(){
+      yields++;
+      service();
+      if(sntpStarted && sntpReachable && (networkUp == NULL || networkUp()) && getMicros() >= nextSntpSyncUs){
+        nextSntpSyncUs = nowUs + NATIVE_SNTP_INTERVAL_MS * 1000;
+        sntpSyncs++;
+        setWallMicros(getNetworkMicros());
+        if(timeSyncCallback != NULL){
+          timeSyncCallback();
+        }
+      }
+    }
+
+    unsigned long getYields(){
+      return yields;
+    }
+
+    // Wall clock and time synchronisation
+
+    /** Set the UTC time of the network, given to the board by the next SNTP synchronisation */
+    void setNetworkEpoch(uint32_t epoch){
+      networkEpochAtBootUs = (uint64_t)epoch * 1000000ULL - getRtcMicros();
+    }
+
+    uint64_t getNetworkMicros(){
+      return networkEpochAtBootUs + getRtcMicros();
+    }
+
+    /** The time servers can be reached (WiFi connected) */
+    void setSntpReachable(bool reachable){
+      sntpReachable = reachable;
+    }
+
+    void setNetworkCheck(bool (*check)()){
+      networkUp = check;
+    }
+
+    /** Time of the board, in us since the epoch once set */
+    uint64_t getWallMicros(){
+      return (uint64_t)((int64_t)getMicros() + wallOffsetUs);
+    }
+
+    void setWallMicros(uint64_t us){
+      wallOffsetUs = (int64_t)us - (int64_t)getMicros();
+      clockSets++;
+    }
+
+    void setTimeSyncCallback(void (*callback)()){
+      timeSyncCallback = callback;
+    }
+
+    /** configTime(): the first synchronisation happens on the next yield() when the servers can be reached */
+    void startSntp(){
+      sntpStarted = true;
+      nextSntpSyncUs = getMicros();
+    }
+
+    unsigned long getSntpSyncs(){
+      return sntpSyncs;
+    }
+
+    /** Times the wall clock was set, by SNTP or by settimeofday() */
+    unsigned long getClockSets(){
+      return clockSets;
+    }
+
+    // Light sleep, RTC memory, resets
+
+    void setSleepHandler(NativeSleepHandler handler){
+      sleepHandler = handler;
+    }
+
+    /** Forced light sleep: the test handler decides how long and which button wakes the CPU up.
+     *  Without handler, the first wake up pin is pushed after a minute.
+     */
+    void lightSleep(){
+      sleeps++;
+      sleeping = true;
+      unsigned long sleptMs = 60000;
+      if(sleepHandler != NULL){
+        sleptMs = sleepHandler();
+      }else{
+        for(uint8_t pin = 0; pin < NATIVE_PIN_COUNT; pin++){
+          if(pins[pin].wakeUp){
+            pins[pin].level = pins[pin].interrupt == NATIVE_INTERRUPT_HIGH_LEVEL ? 1 : 0;
+            break;
+          }
+        }
+      }
+      getMicros();
+      rtcUs += (uint64_t)sleptMs * 1000;
+      sleeping = false;
+    }
+
+    unsigned long getSleeps(){
+      return sleeps;
+    }
+
+    uint32_t getRtcCounter(){
+      return (uint32_t)((getRtcMicros() << 12) / NATIVE_RTC_PERIOD);
+    }
+
+    bool readRtcMemory(uint32_t offset, void* data, size_t size){
+      if(offset * 4 + size > NATIVE_RTC_MEMORY_SIZE){
+        return false;
+      }
+      memcpy(data, rtcMemory + offset * 4, size);
+      return true;
+    }
+
+    bool writeRtcMemory(uint32_t offset, const void* data, size_t size){
+      if(offset * 4 + size > NATIVE_RTC_MEMORY_SIZE){
+        return false;
+      }
+      memcpy(rtcMemory + offset * 4, data, size);
+      return true;
+    }
+
+    void setResetReason(uint32_t reason){
+      resetReason = reason;
+    }
+
+    uint32_t getResetReason(){
+      return resetReason;
+    }
+
+    /** ESP.restart() can't restart the test program: it is counted */
+    void restart(){
+      restarts++;
+    }
+
+    unsigned long getRestarts(){
+      return restarts;
+    }
+
+    /** Supply voltage read by ESP.getVcc(), in mV */
+    void setVcc(uint16_t mv){
+      vcc = mv;
+    }
+
+    uint16_t getVcc(){
+      return vcc;
+    }
+
+  private:
+    static bool edgeMatches(int mode, uint8_t level){
+      // RISING 1, FALLING 2, CHANGE 3 as in Arduino.h
+      return mode == 3 || (mode == 1 && level == 1) || (mode == 2 && level == 0);
+    }
+};
+
+inline NativeBoard nativeBoard;
@@ -0,0 +1,257 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <new>
+
+/** Size of the simulated heap: about what the ESP8266 has left once WiFi is up */
+#ifndef NATIVE_HEAP_SIZE
+#define NATIVE_HEAP_SIZE (50 * 1024)
+#endif
+/** Blocks are aligned on 8 bytes and preceded by an 8 byte header, like umm_malloc */
+#define NATIVE_HEAP_ALIGNMENT 8
+
+/** Tracking allocator standing for the ESP8266 heap on the host.
+ *  String, the JSON buffers, the TLS buffers of the client shims and every new/delete of the test program are served
+ *  first-fit from a fixed arena, so the free heap, the largest free block and the fragmentation behave like on the
+ *  device: a leak shrinks the free heap, interleaved lifetimes split the free space.
+ *  The counters (allocations, live and peak bytes) can be reset between the phases of a test.
+ */
+class NativeHeap {
+  struct Header {
+    uint32_t size;
+    uint32_t used;
+  };
+
+  alignas(NATIVE_HEAP_ALIGNMENT) uint8_t arena[NATIVE_HEAP_SIZE];
+  unsigned long allocations = 0;
+  unsigned long frees = 0;
+  unsigned long failures = 0;
+  size_t allocatedBytes = 0;
+  size_t liveBytes = 0;
+  size_t peakBytes = 0;
+
+  public:
+    NativeHeap(){
+      Header* first = (Header*)arena;
+      first->size = NATIVE_HEAP_SIZE - sizeof(Header);
+      first->used = 0;
+    }
+
+    /** First fit. Return NULL when no free block is large enough, like malloc() on the device */
+    void* allocate(size_t size){
+      size_t needed = align(size > 0 ? size : 1);
+      for(Header* block = first(); block != NULL; block = next(block)){
+        if(block->used || block->size < needed){
+          continue;
+        }
+        if(block->size >= needed + sizeof(Header) + NATIVE_HEAP_ALIGNMENT){
+          Header* rest = (Header*)((uint8_t*)(block + 1) + needed);
+          rest->size = block->size - needed - sizeof(Header);
+          rest->used = 0;
+          block->size = needed;
+        }
+        block->used = 1;
+        allocations++;
+        allocatedBytes += block->size;
+        liveBytes += block->size;
+        if(liveBytes > peakBytes){
+          peakBytes = liveBytes;
+        }
+        return block + 1;
+      }
+      failures++;
+      return NULL;
+    }
+
+    void release(void* pointer){
+      if(pointer == NULL){
+        return;
+      }
+      Header* block = (Header*)pointer - 1;
+      block->used = 0;
+      frees++;
+      liveBytes -= block->size;
+      coalesce();
+    }
+
+    /** Grow or shrink in place when the next block is free, move the data otherwise */
+    void* reallocate(void* pointer, size_t size){
+      if(pointer == NULL){
+        return allocate(size);
+      }
+      Header* block = (Header*)pointer - 1;
+      size_t needed = align(size > 0 ? size : 1);
+      Header* following = next(block);
+      if(needed > block->size && following != NULL && !following->used && block->size + sizeof(Header) + following->size >= needed){
+        size_t merged = block->size + sizeof(Header) + following->size;
+        // Only what is needed is taken from the next block, the rest stays free
+        if(merged >= needed + sizeof(Header) + NATIVE_HEAP_ALIGNMENT){
+          Header* rest = (Header*)((uint8_t*)(block + 1) + needed);
+          rest->size = merged - needed - sizeof(Header);
+          rest->used = 0;
+          merged = needed;
+        }
+        liveBytes += merged - block->size;
+        allocatedBytes += merged - block->size;
+        block->size = merged;
+        if(liveBytes > peakBytes){
+          peakBytes = liveBytes;
+        }
+      }
+      if(needed <= block->size){
+        return pointer;
+      }
+      void* moved = allocate(size);
+      if(moved == NULL){
+        return NULL;
+      }
+      memcpy(moved, pointer, block->size);
+      release(pointer);
+      return moved;
+    }
+
+    bool contains(const void* pointer){
+      return pointer >= (const void*)arena && pointer < (const void*)(arena + NATIVE_HEAP_SIZE);
+    }
+
+    /** Free bytes, headers excluded, as ESP.getFreeHeap() */
+    uint32_t getFree(){
+      uint32_t free = 0;
+      for(Header* block = first(); block != NULL; block = next(block)){
+        if(!block->used){
+          free += block->size;
+        }
+      }
+      return free;
+    }
+
+    uint32_t getMaxFreeBlock(){
+      uint32_t largest = 0;
+      for(Header* block = first(); block != NULL; block = next(block)){
+        if(!block->used && block->size > largest){
+          largest = block->size;
+        }
+      }
+      return largest;
+    }
+
+    /** Metric of the ESP8266 core: 0 when the free space is one block, close to 100 when it is made of crumbs */
+    uint8_t getFragmentation(){
+      double squares = 0;
+      uint32_t free = 0;
+      for(Header* block = first(); block != NULL; block = next(block)){
+        if(!block->used){
+          squares += (double)block->size * block->size;
+          free += block->size;
+        }
+      }
+      return free == 0 ? 0 : (uint8_t)(100 - (uint32_t)(sqrt(squares) * 100 / free));
+    }
+
+    unsigned long getAllocations(){
+      return allocations;
+    }
+
+    unsigned long getFrees(){
+      return frees;
+    }
+
+    /** Allocations refused because no free block was large enough */
+    unsigned long getFailures(){
+      return failures;
+    }
+
+    /** Bytes handed out since the last reset, freed or not */
+    size_t getAllocatedBytes(){
+      return allocatedBytes;
+    }
+
+    size_t getLiveBytes(){
+      return liveBytes;
+    }
+
+    size_t getPeakBytes(){
+      return peakBytes;
+    }
+
+    /** Restart the counters, the peak from what is allocated now */
+    void resetCounters(){
+      allocations = 0;
+      frees = 0;
+      failures = 0;
+      allocatedBytes = 0;
+      peakBytes = liveBytes;
+    }
+
+  private:
+    static size_t align(size_t size){
+      return (size + NATIVE_HEAP_ALIGNMENT - 1) & ~(size_t)(NATIVE_HEAP_ALIGNMENT - 1);
+    }
+
+    Header* first(){
+      return (Header*)arena;
+    }
+
+    Header* next(Header* block){
+      uint8_t* following = (uint8_t*)(block + 1) + block->size;
+      return following < arena + NATIVE_HEAP_SIZE ? (Header*)following : NULL;
+    }
+
+    /** Merge the adjacent free blocks */
+    void coalesce(){
+      for(Header* block = first(); block != NULL; block = next(block)){
+        Header* following;
+        while(!block->used && (following = next(block)) != NULL && !following->used){
+          block->size += sizeof(Header) + following->size;
+        }
+      }
+    }
+};
+
+/** Constructed on first use: the static Strings of the firmware are allocated before main() */
+inline NativeHeap& nativeHeap(){
+  static NativeHeap* heap = new(malloc(sizeof(NativeHeap))) NativeHeap();
+  return *heap;
+}
+
+/** Every new/delete of the test program goes to the simulated heap. A test program is a single translation unit,
+ *  so these replacements are defined once.
+ */
+void* operator new(size_t size){
+  void* pointer = nativeHeap().allocate(size);
+  if(pointer == NULL){
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+void* operator new[](size_t size){
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return nativeHeap().allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return nativeHeap().allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  nativeHeap().release(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  nativeHeap().release(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  nativeHeap().release(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+  nativeHeap().release(pointer);
+}
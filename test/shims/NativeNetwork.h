@@ -0,0 +1,407 @@
+#pragma once
+#include <Arduino.h>
+
+#define NATIVE_SOCKET_COUNT 8
+/** Bytes in flight in each direction of a connection */
+#define NATIVE_SOCKET_BUFFER 65536
+#define NATIVE_MAX_STUBS 4
+/** Bytes a client sees as available at once, a TCP segment */
+#define NATIVE_SEGMENT_SIZE 1460
+
+/** Server side of the connections to a host, run by the test program.
+ *  It is called as soon as the firmware sends bytes: the answer is ready when the client polls.
+ */
+class NativeServerHandler {
+  public:
+    virtual ~NativeServerHandler() {}
+    /** Bytes were received on the socket, see NativeNetwork::peek() */
+    virtual void onReceive(int socket) = 0;
+    /** The client closed the connection */
+    virtual void onClose(int /*socket*/) {}
+};
+
+/** Network of the simulated board: the access point, and the TCP connections of the WiFiClient shims
+ *  with the stub servers of the test program (connect()) or with a WiFiServer of the firmware.
+ *  Nothing goes to the host network. Buffers are preallocated, the network doesn't use the simulated heap
+ *  (except the TLS buffers, allocated by the BearSSL shim like on the device).
+ */
+class NativeNetwork {
+  struct Pipe {
+    uint8_t data[NATIVE_SOCKET_BUFFER];
+    size_t start;
+    size_t length;
+    /** The writer closed its side, the reader gets the end of the stream once the data is read */
+    bool closed;
+  };
+
+  /** Side 0 is the client which connected, side 1 the server. pipes[side] is read by side. */
+  struct Socket {
+    bool used;
+    NativeServerHandler* handler;
+    uint16_t port;
+    bool secure;
+    /** Accepted by a WiFiServer of the firmware */
+    bool accepted;
+    int references[2];
+    bool open[2];
+    Pipe pipes[2];
+  };
+
+  struct Stub {
+    char host[64];
+    uint16_t port;
+    bool secure;
+    NativeServerHandler* handler;
+  };
+
+  Socket sockets[NATIVE_SOCKET_COUNT];
+  Stub stubs[NATIVE_MAX_STUBS];
+  int numberOfStubs = 0;
+  uint16_t listeningPorts[NATIVE_MAX_STUBS];
+  int numberOfListeningPorts = 0;
+  bool accessPointUp = true;
+  unsigned long wifiConnectMs = 500;
+  size_t segmentSize = NATIVE_SEGMENT_SIZE;
+  unsigned long connections = 0;
+  unsigned long refusedConnections = 0;
+  unsigned long fullHandshakeMs = 0;
+  unsigned long resumedHandshakeMs = 0;
+  bool maxFragmentLength = true;
+  bool sessionResumption = true;
+  unsigned long fullHandshakes = 0;
+  unsigned long resumedHandshakes = 0;
+  unsigned long probes = 0;
+
+  public:
+    NativeNetwork(){
+      memset(sockets, 0, sizeof(sockets));
+    }
+
+    // Configuration by the test
+
+    /** Serve host:port with the handler. secure: only TLS clients can connect */
+    void addServer(const char* host, uint16_t port, NativeServerHandler* handler, bool secure){
+      Stub& stub = stubs[numberOfStubs++];
+      snprintf(stub.host, sizeof(stub.host), "%s", host);
+      stub.port = port;
+      stub.secure = secure;
+      stub.handler = handler;
+    }
+
+    /** The handler stops serving: its connections are closed, its hosts become unreachable */
+    void removeServer(NativeServerHandler* handler){
+      for(int i = 0; i < NATIVE_SOCKET_COUNT; i++){
+        if(sockets[i].used && sockets[i].handler == handler){
+          closeSide(i, 1);
+          sockets[i].handler = NULL;
+        }
+      }
+      int kept = 0;
+      for(int i = 0; i < numberOfStubs; i++){
+        if(stubs[i].handler != handler){
+          stubs[kept++] = stubs[i];
+        }
+      }
+      numberOfStubs = kept;
+    }
+
+    void removeServers(){
+      for(int i = 0; i < NATIVE_SOCKET_COUNT; i++){
+        if(sockets[i].used && sockets[i].handler != NULL){
+          closeSide(i, 1);
+        }
+      }
+      numberOfStubs = 0;
+    }
+
+    /** The access point goes down or comes back, the connections are not dropped */
+    void setAccessPointUp(bool up){
+      accessPointUp = up;
+      nativeBoard.setSntpReachable(up);
+    }
+
+    bool isAccessPointUp(){
+      return accessPointUp;
+    }
+
+    void setWiFiConnectMs(unsigned long ms){
+      wifiConnectMs = ms;
+    }
+
+    unsigned long getWiFiConnectMs(){
+      return wifiConnectMs;
+    }
+
+    void setSegmentSize(size_t size){
+      segmentSize = size;
+    }
+
+    unsigned long getConnections(){
+      return connections;
+    }
+
+    unsigned long getRefusedConnections(){
+      return refusedConnections;
+    }
+
+    int getOpenSockets(){
+      int count = 0;
+      for(int i = 0; i < NATIVE_SOCKET_COUNT; i++){
+        count += sockets[i].used ? 1 : 0;
+      }
+      return count;
+    }
+
+    // TLS, simulated by the BearSSL shim
+
+    /** Time taken by the handshakes, the board time advances by it inside connect() */
+    void setHandshakeMs(unsigned long fullMs, unsigned long resumedMs){
+      fullHandshakeMs = fullMs;
+      resumedHandshakeMs = resumedMs;
+    }
+
+    /** The TLS servers accept the max fragment length extension (RFC 6066) */
+    void setMaxFragmentLengthSupported(bool supported){
+      maxFragmentLength = supported;
+    }
+
+    bool isMaxFragmentLengthSupported(){
+      return maxFragmentLength;
+    }
+
+    /** The TLS servers resume the sessions presented by the clients */
+    void setSessionResumption(bool resumption){
+      sessionResumption = resumption;
+    }
+
+    bool isSessionResumption(){
+      return sessionResumption;
+    }
+
+    void countHandshake(bool resumed){
+      if(resumed){
+        resumedHandshakes++;
+        nativeBoard.advance(resumedHandshakeMs);
+      }else{
+        fullHandshakes++;
+        nativeBoard.advance(fullHandshakeMs);
+      }
+    }
+
+    void countProbe(){
+      probes++;
+      nativeBoard.advance(resumedHandshakeMs);
+    }
+
+    unsigned long getFullHandshakes(){
+      return fullHandshakes;
+    }
+
+    unsigned long getResumedHandshakes(){
+      return resumedHandshakes;
+    }
+
+    unsigned long getProbes(){
+      return probes;
+    }
+
+    // Used by the shims
+
+    /** Connect to a stub server, or to a WiFiServer listening on the port. Return the socket or -1 */
+    int open(const char* host, uint16_t port, bool secure){
+      if(!accessPointUp){
+        refusedConnections++;
+        return -1;
+      }
+      NativeServerHandler* handler = NULL;
+      bool found = false;
+      for(int i = 0; i < numberOfStubs && !found; i++){
+        if(stubs[i].port == port && strcmp(stubs[i].host, host) == 0){
+          if(stubs[i].secure != secure){
+            refusedConnections++;
+            return -1;
+          }
+          handler = stubs[i].handler;
+          found = true;
+        }
+      }
+      for(int i = 0; i < numberOfListeningPorts && !found; i++){
+        found = listeningPorts[i] == port && !secure;
+      }
+      int socket = found ? allocate() : -1;
+      if(socket < 0){
+        refusedConnections++;
+        return -1;
+      }
+      Socket& s = sockets[socket];
+      s.handler = handler;
+      s.port = port;
+      s.secure = secure;
+      s.accepted = false;
+      s.references[0] = 1;
+      s.open[1] = true;
+      connections++;
+      return socket;
+    }
+
+    /** Listen on the port, again after a reconnection of the WiFi */
+    void listen(uint16_t port){
+      for(int i = 0; i < numberOfListeningPorts; i++){
+        if(listeningPorts[i] == port){
+          return;
+        }
+      }
+      listeningPorts[numberOfListeningPorts++] = port;
+    }
+
+    /** Take a connection made to the port which hasn't been accepted yet. Return the socket or -1 */
+    int accept(uint16_t port){
+      for(int i = 0; i < NATIVE_SOCKET_COUNT; i++){
+        Socket& s = sockets[i];
+        if(s.used && s.handler == NULL && !s.accepted && s.open[1] && s.port == port){
+          s.accepted = true;
+          s.references[1] = 1;
+          return i;
+        }
+      }
+      return -1;
+    }
+
+    bool isSecure(int socket){
+      return sockets[socket].secure;
+    }
+
+    void retain(int socket, int side){
+      if(socket >= 0){
+        sockets[socket].references[side]++;
+      }
+    }
+
+    void release(int socket, int side){
+      if(socket >= 0 && --sockets[socket].references[side] == 0){
+        closeSide(socket, side);
+      }
+    }
+
+    /** Bytes written by the side, the stub server is called at once */
+    size_t write(int socket, int side, const uint8_t* data, size_t length){
+      Socket& s = sockets[socket];
+      Pipe& pipe = s.pipes[1 - side];
+      if(!s.open[side] || !s.open[1 - side]){
+        return 0;
+      }
+      compact(pipe);
+      if(length > NATIVE_SOCKET_BUFFER - pipe.length){
+        length = NATIVE_SOCKET_BUFFER - pipe.length;
+      }
+      memcpy(pipe.data + pipe.length, data, length);
+      pipe.length += length;
+      if(side == 0 && s.handler != NULL && length > 0){
+        s.handler->onReceive(socket);
+      }
+      return length;
+    }
+
+    int available(int socket, int side){
+      size_t length = sockets[socket].pipes[side].length;
+      return (int)(side == 0 && length > segmentSize ? segmentSize : length);
+    }
+
+    int read(int socket, int side, uint8_t* buffer, size_t size){
+      Pipe& pipe = sockets[socket].pipes[side];
+      size_t length = size < pipe.length ? size : pipe.length;
+      memcpy(buffer, pipe.data + pipe.start, length);
+      pipe.start += length;
+      pipe.length -= length;
+      return (int)length;
+    }
+
+    int peekByte(int socket, int side){
+      Pipe& pipe = sockets[socket].pipes[side];
+      return pipe.length > 0 ? pipe.data[pipe.start] : -1;
+    }
+
+    /** ESP8266 semantics: connected while the peer is or while data is left to read */
+    bool connected(int socket, int side){
+      Socket& s = sockets[socket];
+      return s.used && (s.open[1 - side] || s.pipes[side].length > 0);
+    }
+
+    // Used by the stub servers, which are the side 1 of their sockets
+
+    /** Bytes received by the server, contiguous */
+    const uint8_t* peek(int socket, size_t* length){
+      Pipe& pipe = sockets[socket].pipes[1];
+      compact(pipe);
+      *length = pipe.length;
+      return pipe.data;
+    }
+
+    void consume(int socket, size_t length){
+      Pipe& pipe = sockets[socket].pipes[1];
+      pipe.start += length;
+      pipe.length -= length;
+    }
+
+    size_t send(int socket, const void* data, size_t length){
+      return write(socket, 1, (const uint8_t*)data, length);
+    }
+
+    size_t send(int socket, const char* text){
+      return send(socket, text, strlen(text));
+    }
+
+    /** Close the server side, the client reads what was sent then sees the end of the connection */
+    void close(int socket){
+      closeSide(socket, 1);
+    }
+
+  private:
+    int allocate(){
+      for(int i = 0; i < NATIVE_SOCKET_COUNT; i++){
+        Socket& s = sockets[i];
+        if(!s.used){
+          s.used = true;
+          for(int side = 0; side < 2; side++){
+            s.references[side] = 0;
+            s.open[side] = true;
+            s.pipes[side].start = 0;
+            s.pipes[side].length = 0;
+            s.pipes[side].closed = false;
+          }
+          return i;
+        }
+      }
+      return -1;
+    }
+
+    void closeSide(int socket, int side){
+      Socket& s = sockets[socket];
+      if(!s.used || !s.open[side]){
+        return;
+      }
+      s.open[side] = false;
+      s.pipes[1 - side].closed = true;
+      s.pipes[side].length = 0;
+      if(side == 0 && s.handler != NULL){
+        s.handler->onClose(socket);
+        s.open[1] = false;
+      }
+      // Never accepted: nobody will close the server side
+      if(side == 0 && s.handler == NULL && !s.accepted){
+        s.open[1] = false;
+      }
+      if(!s.open[0] && !s.open[1]){
+        s.used = false;
+      }
+    }
+
+    static void compact(Pipe& pipe){
+      if(pipe.start > 0){
+        memmove(pipe.data, pipe.data + pipe.start, pipe.length);
+        pipe.start = 0;
+      }
+    }
+};
+
+inline NativeNetwork nativeNetwork;
@@ -0,0 +1,140 @@
+#pragma once
+#include "ESP8266WiFi.h"
+
+/** Size of the BearSSL client context (engine, X509 state), allocated on connect like the core */
+#define NATIVE_TLS_CONTEXT_SIZE 4096
+/** Overhead of the records added to the buffers by the core */
+#define NATIVE_TLS_RX_OVERHEAD 325
+#define NATIVE_TLS_TX_OVERHEAD 85
+
+namespace BearSSL {
+
+/** TLS session cache: valid after a full handshake, then presented to resume the next ones */
+class Session {
+  public:
+    bool valid = false;
+};
+
+/** TLS client on the simulated network: no cryptography, but the costs the firmware cares about.
+ *  - connect() takes the buffers and the context from the simulated heap, stop() gives them back
+ *  - a handshake is full or resumed from the Session, its time is added to the board clock
+ *  - the server must be trusted (setInsecure() or a fingerprint)
+ *  - an RX buffer smaller than a TLS record needs the max fragment length extension: without it the first
+ *    record received would overflow the buffer, the connection fails at once here.
+ */
+class WiFiClientSecure : public WiFiClient {
+  Session* session = NULL;
+  bool trusted = false;
+  int rxSize = 16384;
+  int txSize = 512;
+  uint8_t* rxBuffer = NULL;
+  uint8_t* txBuffer = NULL;
+  uint8_t* context = NULL;
+  int lastError = 0;
+
+  public:
+    WiFiClientSecure(){
+    }
+
+    WiFiClientSecure(const WiFiClientSecure& other) = delete;
+    WiFiClientSecure& operator=(const WiFiClientSecure& other) = delete;
+
+    ~WiFiClientSecure() override {
+      freeBuffers();
+    }
+
+    int connect(const char* host, uint16_t port) override {
+      stop();
+      if(!trusted){
+        lastError = -1;
+        return 0;
+      }
+      rxBuffer = (uint8_t*)nativeHeap().allocate(rxSize + NATIVE_TLS_RX_OVERHEAD);
+      txBuffer = (uint8_t*)nativeHeap().allocate(txSize + NATIVE_TLS_TX_OVERHEAD);
+      context = (uint8_t*)nativeHeap().allocate(NATIVE_TLS_CONTEXT_SIZE);
+      if(rxBuffer == NULL || txBuffer == NULL || context == NULL){
+        // Out of memory
+        lastError = -1000;
+        freeBuffers();
+        return 0;
+      }
+      socket = nativeNetwork.open(host, port, true);
+      side = 0;
+      if(socket < 0){
+        freeBuffers();
+        return 0;
+      }
+      if(rxSize < 16384 && !nativeNetwork.isMaxFragmentLengthSupported()){
+        lastError = -2;
+        stop();
+        return 0;
+      }
+      bool resumed = session != NULL && session->valid && nativeNetwork.isSessionResumption();
+      nativeNetwork.countHandshake(resumed);
+      if(session != NULL){
+        session->valid = true;
+      }
+      lastError = 0;
+      return 1;
+    }
+
+    int connect(IPAddress ip, uint16_t port) override {
+      return connect(ip.toString().c_str(), port);
+    }
+
+    void stop() override {
+      WiFiClient::stop();
+      freeBuffers();
+    }
+
+    void setInsecure(){
+      trusted = true;
+    }
+
+    bool setFingerprint(const char* fingerprint){
+      trusted = fingerprint != NULL;
+      return trusted;
+    }
+
+    void setSession(Session* session){
+      this->session = session;
+    }
+
+    /** Taken into account by the next connect() */
+    void setBufferSizes(int rx, int tx){
+      rxSize = rx;
+      txSize = tx;
+    }
+
+    int getRxBufferSize(){
+      return rxSize;
+    }
+
+    int getLastSSLError(char* text = NULL, size_t size = 0){
+      if(text != NULL && size > 0){
+        snprintf(text, size, "native TLS error %d", lastError);
+      }
+      return lastError;
+    }
+
+    /** Ask the server whether it accepts the max fragment length: needs a connection to it */
+    static bool probeMaxFragmentLength(const char* /*host*/, uint16_t /*port*/, uint16_t /*length*/){
+      if(WiFi.status() != WL_CONNECTED){
+        return false;
+      }
+      nativeNetwork.countProbe();
+      return nativeNetwork.isMaxFragmentLengthSupported();
+    }
+
+  private:
+    void freeBuffers(){
+      nativeHeap().release(context);
+      nativeHeap().release(txBuffer);
+      nativeHeap().release(rxBuffer);
+      context = NULL;
+      txBuffer = NULL;
+      rxBuffer = NULL;
+    }
+};
+
+}
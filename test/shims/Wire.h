@@ -0,0 +1,2 @@
+#pragma once
+// The I2C bus is simulated by the LiquidCrystal_I2C shim
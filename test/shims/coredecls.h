@@ -0,0 +1,7 @@
+#pragma once
+#include "NativeBoard.h"
+
+/** Called after each SNTP synchronisation */
+inline void settimeofday_cb(void (*callback)(void)){
+  nativeBoard.setTimeSyncCallback(callback);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+extern "C++" {
+#include "NativeBoard.h"
+}
+
+#define GPIO_ID_PIN(n) (n)
+
+typedef enum {
+  GPIO_PIN_INTR_DISABLE = 0,
+  GPIO_PIN_INTR_POSEDGE,
+  GPIO_PIN_INTR_NEGEDGE,
+  GPIO_PIN_INTR_ANYEDGE,
+  GPIO_PIN_INTR_LOLEVEL,
+  GPIO_PIN_INTR_HILEVEL
+} GPIO_INT_TYPE;
+
+/** Only the levels can wake the CPU from light sleep */
+inline void gpio_pin_wakeup_enable(uint32_t pin, GPIO_INT_TYPE type){
+  if(type == GPIO_PIN_INTR_HILEVEL || type == GPIO_PIN_INTR_LOLEVEL){
+    nativeBoard.enableWakeUp((uint8_t)pin, type == GPIO_PIN_INTR_HILEVEL);
+  }
+}
+
+/** Disable the interrupt of the wake up pins, attachInterrupt() must be called again */
+inline void gpio_pin_wakeup_disable(void){
+  nativeBoard.disableWakeUp();
+}
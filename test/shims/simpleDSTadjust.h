@@ -0,0 +1,72 @@
+#pragma once
+#include <Arduino.h>
+
+enum week_t {Last, First, Second, Third, Fourth};
+enum dow_t {Sun = 1, Mon, Tue, Wed, Thu, Fri, Sat};
+enum month_t {Jan = 1, Feb, Mar, Apr, May, Jun, Jul, Aug, Sep, Oct, Nov, Dec};
+
+struct dstRule {
+  char abbrev[6];
+  uint8_t week;
+  uint8_t dow;
+  uint8_t month;
+  uint8_t hour;
+  int offset;
+};
+
+/** Same computation as the library: the rules give the day and the local standard time of the changes,
+ *  time() adds the offset of the rule in force to the UTC time of the board.
+ */
+class simpleDSTadjust {
+  dstRule startRule;
+  dstRule endRule;
+
+  public:
+    simpleDSTadjust(struct dstRule startRule, struct dstRule endRule) :
+      startRule(startRule),
+      endRule(endRule)
+    {
+    }
+
+    time_t time(char** abbrev){
+      time_t now = ::time(nullptr);
+      struct tm* local = localtime(&now);
+      int year = local->tm_year;
+      time_t start = changeTime(startRule, year);
+      time_t end = changeTime(endRule, year);
+      // Southern hemisphere: the DST spans the new year
+      bool inDst = start < end ? now >= start && now < end : now >= start || now < end;
+      const dstRule& rule = inDst ? startRule : endRule;
+      if(abbrev != NULL){
+        *abbrev = (char*)rule.abbrev;
+      }
+      return now + rule.offset;
+    }
+
+  private:
+    static time_t changeTime(const dstRule& rule, int year){
+      struct tm change;
+      memset(&change, 0, sizeof(change));
+      change.tm_year = year;
+      change.tm_mon = rule.month - 1;
+      change.tm_mday = 1;
+      change.tm_hour = rule.hour;
+      change.tm_isdst = 0;
+      if(rule.week == Last){
+        change.tm_mon++;
+      }
+      // Day of the week of the first day of the month (or of the next one)
+      time_t first = mktime(&change);
+      struct tm* firstDay = localtime(&first);
+      int wday = firstDay->tm_wday;
+      int target = rule.dow - 1;
+      if(rule.week == Last){
+        // Back from the first day of the next month
+        int back = (wday - target + 7) % 7;
+        back = back == 0 ? 7 : back;
+        return first - back * 86400L;
+      }
+      int forward = (target - wday + 7) % 7 + (rule.week - 1) * 7;
+      return first + forward * 86400L;
+    }
+};
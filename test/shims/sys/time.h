@@ -0,0 +1,21 @@
+#pragma once
+#include_next <sys/time.h>
+#include "../NativeBoard.h"
+
+/** gettimeofday() and settimeofday() of the firmware use the wall clock of the board, never the one of the host */
+inline int nativeGetTimeOfDay(struct timeval* tv, void* /*tz*/){
+  uint64_t us = nativeBoard.getWallMicros();
+  tv->tv_sec = (time_t)(us / 1000000);
+  tv->tv_usec = (suseconds_t)(us % 1000000);
+  return 0;
+}
+
+inline int nativeSetTimeOfDay(const struct timeval* tv, const void* /*tz*/){
+  if(tv != NULL){
+    nativeBoard.setWallMicros((uint64_t)tv->tv_sec * 1000000 + tv->tv_usec);
+  }
+  return 0;
+}
+
+#define gettimeofday nativeGetTimeOfDay
+#define settimeofday nativeSetTimeOfDay
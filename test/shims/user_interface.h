@@ -0,0 +1,86 @@
+#pragma once
+#include <stdint.h>
+extern "C++" {
+#include "NativeBoard.h"
+}
+
+// SDK of the ESP8266, may be included in an extern "C" block like on the device
+extern "C" {
+
+typedef struct _os_timer_t {
+  struct _os_timer_t* next;
+} os_timer_t;
+
+/** OS timers of the SDK, none on the host */
+inline os_timer_t* timer_list = NULL;
+
+enum sleep_type {
+  NONE_SLEEP_T = 0,
+  LIGHT_SLEEP_T,
+  MODEM_SLEEP_T
+};
+
+enum rst_reason {
+  REASON_DEFAULT_RST = 0,
+  REASON_WDT_RST,
+  REASON_EXCEPTION_RST,
+  REASON_SOFT_WDT_RST,
+  REASON_SOFT_RESTART,
+  REASON_DEEP_SLEEP_AWAKE,
+  REASON_EXT_SYS_RST
+};
+
+struct rst_info {
+  uint32_t reason;
+  uint32_t exccause;
+  uint32_t epc1;
+  uint32_t epc2;
+  uint32_t epc3;
+  uint32_t excvaddr;
+  uint32_t depc;
+};
+
+typedef void (*fpm_wakeup_cb)(void);
+
+inline void wifi_fpm_set_sleep_type(enum sleep_type /*type*/){
+}
+
+inline void wifi_fpm_open(void){
+}
+
+inline void wifi_fpm_close(void){
+}
+
+inline void wifi_fpm_set_wakeup_cb(fpm_wakeup_cb /*callback*/){
+}
+
+/** Forced light sleep until a wake up pin matches, see NativeBoard::lightSleep() */
+inline int8_t wifi_fpm_do_sleep(uint32_t /*us*/){
+  nativeBoard.lightSleep();
+  return 0;
+}
+
+inline uint32_t system_get_rtc_time(void){
+  return nativeBoard.getRtcCounter();
+}
+
+inline uint32_t system_rtc_clock_cali_proc(void){
+  return NATIVE_RTC_PERIOD;
+}
+
+/** The user blocks start at 64, as seen by ESP.rtcUserMemoryRead() */
+inline bool system_rtc_mem_read(uint8_t block, void* data, uint16_t size){
+  return block >= 64 && nativeBoard.readRtcMemory(block - 64, data, size);
+}
+
+inline bool system_rtc_mem_write(uint8_t block, const void* data, uint16_t size){
+  return block >= 64 && nativeBoard.writeRtcMemory(block - 64, data, size);
+}
+
+inline struct rst_info* system_get_rst_info(void){
+  static struct rst_info info;
+  info.reason = nativeBoard.getResetReason();
+  return &info;
+}
+
+}
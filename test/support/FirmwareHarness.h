@@ -0,0 +1,98 @@
+#pragma once
+#include <StibApiStub.h>
+
+/** Drive the firmware included by the test on the simulated board: boot, loop() passes, buttons.
+ *  To be included after src/STIB_PassingTime.cpp. The API is served by the stub, installed at boot.
+ */
+
+/** Simulated time between two loop() passes, in ms */
+#ifndef HARNESS_PASS_MS
+#define HARNESS_PASS_MS 1
+#endif
+/** A push long enough for the debounce, shorter than a long press */
+#define HARNESS_PUSH_MS 80
+
+StibApiStub api;
+bool firmwareBooted = false;
+
+/** One pass of loop() then the system gets the hand, like the core does between two calls */
+void runPass(){
+  loop();
+  nativeBoard.onYield();
+  nativeBoard.advance(HARNESS_PASS_MS);
+}
+
+void runFor(unsigned long ms){
+  for(unsigned long elapsed = 0; elapsed < ms; elapsed += HARNESS_PASS_MS){
+    runPass();
+  }
+}
+
+/** Run until the condition holds. False when it still doesn't after timeoutMs */
+template<typename Condition> bool runUntil(Condition condition, unsigned long timeoutMs){
+  for(unsigned long elapsed = 0; elapsed < timeoutMs; elapsed += HARNESS_PASS_MS){
+    if(condition()){
+      return true;
+    }
+    runPass();
+  }
+  return condition();
+}
+
+/** setup() once, then run until WiFi is connected, the time is set and the favourites are displayed */
+bool bootFirmware(unsigned long timeoutMs = 20000){
+  if(!firmwareBooted){
+    api.install();
+    setup();
+    firmwareBooted = true;
+  }
+  return runUntil([](){ return uiTask.isEnabled() && isTimeSet() && strlen(lcd.getRow(0)) > 0; }, timeoutMs);
+}
+
+int fetchedHttpCode;
+
+/** Fetch the passing times of the favourites like a refresh does, return the http code.
+ *  Counts as an activity, so that the device doesn't go to sleep between the fetches of a test.
+ */
+int fetchFavourites(unsigned long timeoutMs = 60000){
+  fetchedHttpCode = -1;
+  powerManager.notifyActivity();
+  // After the token renewal of the boot or a backoff, if any
+  if(!runUntil([](){ return passingTimeFetcher.canStart() && WiFi.status() == WL_CONNECTED; }, timeoutMs)){
+    return -1;
+  }
+  if(!passingTimeFetcher.startFavourites(passingTimeState.passingTimeResponses, [](int code){ fetchedHttpCode = code; })){
+    return -1;
+  }
+  runUntil([](){ return fetchedHttpCode != -1; }, timeoutMs);
+  return fetchedHttpCode;
+}
+
+/** Press and release a button, then let the firmware handle it */
+void pushButton(uint8_t pin, unsigned long holdMs = HARNESS_PUSH_MS){
+  nativeBoard.setPin(pin, HIGH);
+  runFor(holdMs);
+  nativeBoard.setPin(pin, LOW);
+  runFor(BUTTON_DEBOUNCE_MS + RENDER_INTERVAL_MS);
+}
+
+/** From the favourites screen at the top of the menu, open the passing times of the favourite at the position */
+void openFavourite(unsigned int position){
+  while(appState.position < position){
+    pushButton(DOWN_BUTTON);
+  }
+  pushButton(SELECT_BUTTON);
+}
+
+/** Long push on select: back to the favourites from any screen, the cursor stays where it was */
+void backToFavourites(){
+  pushButton(SELECT_BUTTON, BUTTON_LONG_PRESS_MS + 100);
+  while(appState.position > 0){
+    pushButton(UP_BUTTON);
+  }
+}
+
+/** Text of a row of the LCD, as displayed */
+const char* lcdRow(uint8_t row){
+  return lcd.getRow(row);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdio.h>
+#include <Arduino.h>
+
+/** Host time spent measuring each operation, once warmed up */
+#ifndef NATIVE_BENCH_MIN_NS
+#define NATIVE_BENCH_MIN_NS 200000000ULL
+#endif
+#define NATIVE_BENCH_WARMUP 16
+
+/** Cost of one call of an operation, averaged over the run */
+struct NativeBenchResult {
+  unsigned long iterations;
+  /** Allocations of the whole run */
+  unsigned long allocations;
+  double nsPerOp;
+  double allocationsPerOp;
+  double bytesPerOp;
+  /** Live bytes left behind by the whole run, 0 unless the operation leaks */
+  long leakedBytes;
+};
+
+/** Run the operation until NATIVE_BENCH_MIN_NS of host time has been spent and print
+ *  "[bench] name: ns/op allocs/op B/op" on the output of the test.
+ *  The allocations are those of the simulated heap, so they are the ones the device would do.
+ *  The ns/op are those of the host: they compare two versions of the code, not the ESP8266.
+ */
+template<typename Operation> NativeBenchResult nativeBench(const char* name, Operation operation){
+  for(int i = 0; i < NATIVE_BENCH_WARMUP; i++){
+    operation();
+  }
+  NativeBenchResult result;
+  size_t liveBefore = nativeHeap().getLiveBytes();
+  nativeHeap().resetCounters();
+  unsigned long iterations = 0;
+  uint64_t start = NativeBoard::hostNanos();
+  uint64_t elapsed = 0;
+  // Batches double so that reading the clock stays negligible
+  for(unsigned long batch = 1; elapsed < NATIVE_BENCH_MIN_NS; batch *= 2){
+    for(unsigned long i = 0; i < batch; i++){
+      operation();
+    }
+    iterations += batch;
+    elapsed = NativeBoard::hostNanos() - start;
+  }
+  result.iterations = iterations;
+  result.nsPerOp = (double)elapsed / iterations;
+  result.allocations = nativeHeap().getAllocations();
+  result.allocationsPerOp = (double)result.allocations / iterations;
+  result.bytesPerOp = (double)nativeHeap().getAllocatedBytes() / iterations;
+  result.leakedBytes = (long)nativeHeap().getLiveBytes() - (long)liveBefore;
+  printf("[bench] %-28s %10.1f ns/op %8.2f allocs/op %10.1f B/op (%lu runs)\n",
+    name, result.nsPerOp, result.allocationsPerOp, result.bytesPerOp, iterations);
+  return result;
+}
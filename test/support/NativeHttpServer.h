@@ -0,0 +1,219 @@
+#pragma once
+#include <Arduino.h>
+#include <NativeNetwork.h>
+
+#define NATIVE_HTTP_PATH_LENGTH 256
+#define NATIVE_HTTP_HEADERS_LENGTH 512
+#define NATIVE_HTTP_BODY_LENGTH 256
+
+/** Request received by a stub server */
+struct NativeHttpRequest {
+  int socket;
+  char method[8];
+  char path[NATIVE_HTTP_PATH_LENGTH];
+  /** Header lines, each one ending with \r\n */
+  char headers[NATIVE_HTTP_HEADERS_LENGTH];
+  char body[NATIVE_HTTP_BODY_LENGTH];
+  /** HTTP/1.1 without Connection: close */
+  bool keepAlive;
+
+  /** Copy the value of the header into value. False when absent */
+  bool getHeader(const char* name, char* value, size_t size) const {
+    size_t nameLength = strlen(name);
+    for(const char* line = headers; *line != '\0'; line = strstr(line, "\r\n") + 2){
+      if(strncasecmp(line, name, nameLength) == 0 && line[nameLength] == ':'){
+        const char* start = line + nameLength + 1;
+        while(*start == ' '){
+          start++;
+        }
+        size_t length = strcspn(start, "\r\n");
+        length = length < size - 1 ? length : size - 1;
+        memcpy(value, start, length);
+        value[length] = '\0';
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/** How a stub server answers, including the misbehaviours a client must survive */
+struct NativeHttpResponse {
+  int status = 200;
+  const char* body = "";
+  size_t length = 0;
+  /** Transfer-Encoding: chunked, in chunks of chunkSize bytes */
+  bool chunked = false;
+  size_t chunkSize = 512;
+  /** Connection: close, the connection is closed after the response */
+  bool close = false;
+  /** Neither Content-Length nor chunks: the body ends with the connection */
+  bool noLength = false;
+  /** The connection is closed after this number of bytes of the response, -1 to send it all */
+  long truncateAt = -1;
+  /** The connection is closed without any answer */
+  bool drop = false;
+};
+
+/** HTTP/1.1 server of a test on the simulated network. The requests are answered as soon as they are complete,
+ *  several ones can be sent on a kept alive connection. Nothing is taken from the simulated heap.
+ */
+class NativeHttpServer : public NativeServerHandler {
+  unsigned long requests = 0;
+  unsigned long connections = 0;
+  int lastSocket = -1;
+
+  public:
+    /** The firmware may still hold connections to the server, e.g. when the test program exits */
+    ~NativeHttpServer(){
+      nativeNetwork.removeServer(this);
+    }
+
+    /** Fill the response to the request, the body must stay valid until the method returns */
+    virtual void handle(const NativeHttpRequest& request, NativeHttpResponse& response) = 0;
+
+    void onReceive(int socket) override {
+      if(socket != lastSocket){
+        connections++;
+        lastSocket = socket;
+      }
+      NativeHttpRequest request;
+      while(readRequest(socket, &request)){
+        requests++;
+        NativeHttpResponse response;
+        handle(request, response);
+        if(!send(socket, request, response)){
+          return;
+        }
+      }
+    }
+
+    void onClose(int socket) override {
+      if(socket == lastSocket){
+        lastSocket = -1;
+      }
+    }
+
+    unsigned long getRequests(){
+      return requests;
+    }
+
+    /** Connections on which a request was received */
+    unsigned long getConnections(){
+      return connections;
+    }
+
+  private:
+    /** Take the next complete request out of the socket */
+    static bool readRequest(int socket, NativeHttpRequest* request){
+      size_t available;
+      const char* data = (const char*)nativeNetwork.peek(socket, &available);
+      const char* end = (const char*)memmem(data, available, "\r\n\r\n", 4);
+      if(end == NULL){
+        return false;
+      }
+      size_t headLength = end + 4 - data;
+      long contentLength = 0;
+      const char* lengthHeader = (const char*)memmem(data, headLength, "Content-Length:", 15);
+      if(lengthHeader != NULL){
+        contentLength = atol(lengthHeader + 15);
+      }
+      if(headLength + contentLength > available){
+        return false;
+      }
+      request->socket = socket;
+      // GET /path HTTP/1.1
+      const char* path = (const char*)memchr(data, ' ', headLength);
+      const char* version = path != NULL ? (const char*)memchr(path + 1, ' ', end - path - 1) : NULL;
+      const char* firstLineEnd = strstr(data, "\r\n");
+      if(path == NULL || version == NULL){
+        nativeNetwork.consume(socket, headLength + contentLength);
+        request->method[0] = '\0';
+        request->path[0] = '\0';
+        request->headers[0] = '\0';
+        request->body[0] = '\0';
+        request->keepAlive = false;
+        return true;
+      }
+      copy(request->method, sizeof(request->method), data, path - data);
+      copy(request->path, sizeof(request->path), path + 1, version - path - 1);
+      copy(request->headers, sizeof(request->headers), firstLineEnd + 2, end + 2 - firstLineEnd - 2);
+      copy(request->body, sizeof(request->body), end + 4, contentLength);
+      char connection[16];
+      request->keepAlive = strncmp(version + 1, "HTTP/1.1", 8) == 0
+        && !(request->getHeader("Connection", connection, sizeof(connection)) && strcasecmp(connection, "close") == 0);
+      nativeNetwork.consume(socket, headLength + contentLength);
+      return true;
+    }
+
+    /** Return false when the connection has been closed */
+    static bool send(int socket, const NativeHttpRequest& request, const NativeHttpResponse& response){
+      if(response.drop){
+        nativeNetwork.close(socket);
+        return false;
+      }
+      bool close = response.close || response.noLength || !request.keepAlive;
+      char head[256];
+      int headLength = snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\n%s",
+        response.status, reason(response.status), close ? "Connection: close\r\n" : "");
+      if(response.chunked){
+        headLength += snprintf(head + headLength, sizeof(head) - headLength, "Transfer-Encoding: chunked\r\n\r\n");
+      }else if(response.noLength){
+        headLength += snprintf(head + headLength, sizeof(head) - headLength, "\r\n");
+      }else{
+        headLength += snprintf(head + headLength, sizeof(head) - headLength, "Content-Length: %u\r\n\r\n", (unsigned int)response.length);
+      }
+      long budget = response.truncateAt;
+      bool complete = write(socket, head, headLength, &budget);
+      if(response.chunked){
+        for(size_t offset = 0; complete && offset < response.length; offset += response.chunkSize){
+          size_t size = response.length - offset < response.chunkSize ? response.length - offset : response.chunkSize;
+          char sizeLine[16];
+          int sizeLength = snprintf(sizeLine, sizeof(sizeLine), "%x\r\n", (unsigned int)size);
+          complete = write(socket, sizeLine, sizeLength, &budget) && write(socket, response.body + offset, size, &budget)
+            && write(socket, "\r\n", 2, &budget);
+        }
+        complete = complete && write(socket, "0\r\n\r\n", 5, &budget);
+      }else{
+        complete = complete && write(socket, response.body, response.length, &budget);
+      }
+      if(!complete || close){
+        nativeNetwork.close(socket);
+        return false;
+      }
+      return true;
+    }
+
+    /** Write unless the truncation budget is spent. False once truncated */
+    static bool write(int socket, const char* data, size_t length, long* budget){
+      if(*budget >= 0 && (long)length > *budget){
+        nativeNetwork.send(socket, data, *budget);
+        *budget = 0;
+        return false;
+      }
+      if(*budget >= 0){
+        *budget -= length;
+      }
+      nativeNetwork.send(socket, data, length);
+      return true;
+    }
+
+    static void copy(char* destination, size_t size, const char* source, size_t length){
+      length = length < size - 1 ? length : size - 1;
+      memcpy(destination, source, length);
+      destination[length] = '\0';
+    }
+
+    static const char* reason(int status){
+      switch(status){
+        case 200: return "OK";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "Status";
+      }
+    }
+};
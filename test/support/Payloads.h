@@ -0,0 +1,97 @@
+#pragma once
+/** PassingTimeByPoint responses recorded from the STIB API (bodies only),
+ *  on 2026-03-02 around 09:00 in Brussels. The expected times are relative to PAYLOAD_RECORDED_AT.
+ */
+
+/** UTC time of the requests, 2026-03-02 08:00:00 */
+#define PAYLOAD_RECORDED_AT 1772438400UL
+
+/** The 5 favourites of config.h in one request, compact as sent by the API. 18 passing times, one with a message. */
+static const char PAYLOAD_FAVOURITES[] =
+  "{\"points\":[{\"passingTimes\":[{\"destination\":{\"fr\":\"VANDERKINDERE\",\"nl\":\"VANDERKINDERE\"},\"expectedArri"
+  "valTime\":\"2026-03-02T09:01:35+01:00\",\"lineId\":\"7\"},{\"destination\":{\"fr\":\"ROGIER\",\"nl\":\"ROGIER\"},\"exp"
+  "ectedArrivalTime\":\"2026-03-02T09:07:10+01:00\",\"lineId\":\"25\"},{\"destination\":{\"fr\":\"HEYSEL\",\"nl\":\"HEI"
+  "ZEL\"},\"expectedArrivalTime\":\"2026-03-02T09:00:47+01:00\",\"lineId\":\"7\"},{\"destination\":{\"fr\":\"BOONDAEL"
+  " GARE\",\"nl\":\"BOONDAAL STATION\"},\"expectedArrivalTime\":\"2026-03-02T09:13:32+01:00\",\"lineId\":\"25\"}],\"p"
+  "ointId\":\"5311\"},{\"passingTimes\":[{\"destination\":{\"fr\":\"AUDERGHEM-SHOPPING\",\"nl\":\"OUDERGEM-SHOPPING\"}"
+  ",\"expectedArrivalTime\":\"2026-03-02T09:13:32+01:00\",\"lineId\":\"34\"},{\"destination\":{\"fr\":\"ADEPS\",\"nl\":"
+  "\"ADEPS\"},\"expectedArrivalTime\":\"2026-03-02T09:22:20+01:00\",\"lineId\":\"72\"},{\"destination\":{\"fr\":\"PORT"
+  "E DE NAMUR\",\"nl\":\"NAAMSEPOORT\"},\"expectedArrivalTime\":\"2026-03-02T09:04:20+01:00\",\"lineId\":\"34\"}],\"p"
+  "ointId\":\"1715\"},{\"passingTimes\":[{\"destination\":{\"fr\":\"STOCKEL\",\"nl\":\"STOKKEL\"},\"expectedArrivalTime"
+  "\":\"2026-03-02T09:36:50+01:00\",\"lineId\":\"5\"},{\"destination\":{\"fr\":\"ERASME\",\"nl\":\"ERASMUS\"},\"expectedA"
+  "rrivalTime\":\"2026-03-02T09:10:15+01:00\",\"lineId\":\"5\"},{\"destination\":{\"fr\":\"GARE DE L'OUEST\",\"nl\":\"W"
+  "ESTSTATION\"},\"expectedArrivalTime\":\"2026-03-02T09:30:20+01:00\",\"lineId\":\"1\"},{\"destination\":{\"fr\":\"S"
+  "TOCKEL\",\"nl\":\"STOKKEL\"},\"expectedArrivalTime\":\"2026-03-02T10:31:00+01:00\",\"lineId\":\"1\"}],\"pointId\":\""
+  "8211\"},{\"passingTimes\":[{\"destination\":{\"fr\":\"DE BROUCKERE\",\"nl\":\"DE BROUCKERE\"},\"expectedArrivalTim"
+  "e\":\"2026-03-02T10:31:00+01:00\",\"lineId\":\"71\"},{\"destination\":{\"fr\":\"DELTA\",\"nl\":\"DELTA\"},\"expectedAr"
+  "rivalTime\":\"2026-03-02T09:01:35+01:00\",\"lineId\":\"71\"},{\"destination\":{\"fr\":\"WIENER\",\"nl\":\"WIENER\"},\""
+  "expectedArrivalTime\":\"2026-03-02T09:07:10+01:00\",\"lineId\":\"95\",\"message\":{\"en\":\"Disrupted service\",\""
+  "fr\":\"Service perturb\\u00e9\",\"nl\":\"Verstoorde dienst\"}},{\"destination\":{\"fr\":\"GRAND-PLACE\",\"nl\":\"GROT"
+  "E MARKT\"},\"expectedArrivalTime\":\"2026-03-02T09:00:47+01:00\",\"lineId\":\"95\"},{\"destination\":{\"fr\":\"DE "
+  "BROUCKERE\",\"nl\":\"DE BROUCKERE\"},\"expectedArrivalTime\":\"2026-03-02T09:13:32+01:00\",\"lineId\":\"71\"}],\"p"
+  "ointId\":\"5267\"},{\"passingTimes\":[{\"destination\":{\"fr\":\"HERRMANN-DEBROUX\",\"nl\":\"HERRMANN-DEBROUX\"},\"e"
+  "xpectedArrivalTime\":\"2026-03-02T09:00:47+01:00\",\"lineId\":\"5\"},{\"destination\":{\"fr\":\"GARE DE L'OUEST\""
+  ",\"nl\":\"WESTSTATION\"},\"expectedArrivalTime\":\"2026-03-02T09:13:32+01:00\",\"lineId\":\"1\"}],\"pointId\":\"821"
+  "2\"}]}";
+
+#define PAYLOAD_FAVOURITES_POINTS 5
+#define PAYLOAD_FAVOURITES_PASSING_TIMES 18
+
+/** One stop (5267) with 5 passing times, pretty printed by the replay server */
+static const char PAYLOAD_ONE_POINT[] =
+  "{\n"
+  "  \"points\": [\n"
+  "    {\n"
+  "      \"passingTimes\": [\n"
+  "        {\n"
+  "          \"destination\": {\n"
+  "            \"fr\": \"DE BROUCKERE\",\n"
+  "            \"nl\": \"DE BROUCKERE\"\n"
+  "          },\n"
+  "          \"expectedArrivalTime\": \"2026-03-02T10:31:00+01:00\",\n"
+  "          \"lineId\": \"71\"\n"
+  "        },\n"
+  "        {\n"
+  "          \"destination\": {\n"
+  "            \"fr\": \"DELTA\",\n"
+  "            \"nl\": \"DELTA\"\n"
+  "          },\n"
+  "          \"expectedArrivalTime\": \"2026-03-02T09:01:35+01:00\",\n"
+  "          \"lineId\": \"71\"\n"
+  "        },\n"
+  "        {\n"
+  "          \"destination\": {\n"
+  "            \"fr\": \"WIENER\",\n"
+  "            \"nl\": \"WIENER\"\n"
+  "          },\n"
+  "          \"expectedArrivalTime\": \"2026-03-02T09:07:10+01:00\",\n"
+  "          \"lineId\": \"95\",\n"
+  "          \"message\": {\n"
+  "            \"en\": \"Disrupted service\",\n"
+  "            \"fr\": \"Service perturb\\u00e9\",\n"
+  "            \"nl\": \"Verstoorde dienst\"\n"
+  "          }\n"
+  "        },\n"
+  "        {\n"
+  "          \"destination\": {\n"
+  "            \"fr\": \"GRAND-PLACE\",\n"
+  "            \"nl\": \"GROTE MARKT\"\n"
+  "          },\n"
+  "          \"expectedArrivalTime\": \"2026-03-02T09:00:47+01:00\",\n"
+  "          \"lineId\": \"95\"\n"
+  "        },\n"
+  "        {\n"
+  "          \"destination\": {\n"
+  "            \"fr\": \"DE BROUCKERE\",\n"
+  "            \"nl\": \"DE BROUCKERE\"\n"
+  "          },\n"
+  "          \"expectedArrivalTime\": \"2026-03-02T09:13:32+01:00\",\n"
+  "          \"lineId\": \"71\"\n"
+  "        }\n"
+  "      ],\n"
+  "      \"pointId\": \"5267\"\n"
+  "    }\n"
+  "  ]\n"
+  "}\n";
+
+#define PAYLOAD_ONE_POINT_PASSING_TIMES 5
@@ -0,0 +1,167 @@
+#pragma once
+#include "NativeHttpServer.h"
+
+#define STIB_STUB_BODY_SIZE 12288
+#define STIB_STUB_TOKEN_LENGTH 33
+#define STIB_STUB_MAX_POINTS 10
+
+/** The STIB API on the simulated network: the OAuth2 token and PassingTimeByPoint.
+ *  The passing times are generated from the time of the network, every intervalSec from the request on, so the
+ *  remaining times displayed by the firmware are known to the test. Each token is valid until revoked or expired.
+ */
+class StibApiStub : public NativeHttpServer {
+  char body[STIB_STUB_BODY_SIZE];
+  char token[STIB_STUB_TOKEN_LENGTH];
+  uint32_t tokenExpiresAt = 0;
+  unsigned long issuedTokens = 0;
+
+  public:
+    /** Passing times returned per point, and seconds between them */
+    int passingTimesPerPoint = 4;
+    uint32_t intervalSec = 240;
+    /** Lifetime of the tokens, in the expires_in of the token response */
+    uint32_t tokenLifetimeSec = 3600;
+    /** Status of every passing time request when not 0, e.g. 500 or 429 */
+    int forcedStatus = 0;
+    /** Point answered without any passing time, NULL when none */
+    const char* emptyPoint = NULL;
+    /** Shape of the responses */
+    bool chunked = true;
+    size_t chunkSize = 400;
+    bool keepAlive = true;
+    /** The connection is closed after the given number of bytes of the next response, -1 when not */
+    long truncateNextAt = -1;
+
+    unsigned long tokenRequests = 0;
+    unsigned long passingTimeRequests = 0;
+    unsigned long unauthorizedRequests = 0;
+    unsigned long points = 0;
+
+    StibApiStub(){
+      // The default token of the firmware is valid until revoked
+      snprintf(token, sizeof(token), "%s", ENV_DEFAULT_API_TOKEN);
+    }
+
+    /** Serve the host of config.h, with TLS when the scheme is https */
+    void install(){
+      nativeNetwork.addServer(API_HOST_NAME, API_PORT, this, strcmp(API_SCHEME, "https") == 0);
+    }
+
+    /** The current token is rejected from now on */
+    void revokeToken(){
+      token[0] = '\0';
+    }
+
+    const char* getToken(){
+      return token;
+    }
+
+    unsigned long getIssuedTokens(){
+      return issuedTokens;
+    }
+
+    static uint32_t now(){
+      return (uint32_t)(nativeBoard.getNetworkMicros() / 1000000);
+    }
+
+    void handle(const NativeHttpRequest& request, NativeHttpResponse& response) override {
+      response.chunked = chunked;
+      response.chunkSize = chunkSize;
+      response.close = !keepAlive;
+      response.truncateAt = truncateNextAt;
+      truncateNextAt = -1;
+      if(strcmp(request.path, "/token") == 0){
+        handleToken(request, response);
+      }else if(strstr(request.path, "/PassingTimeByPoint/") != NULL){
+        handlePassingTimes(request, response);
+      }else{
+        respond(response, 404, "{\"error\":\"not found\"}");
+      }
+    }
+
+  private:
+    void handleToken(const NativeHttpRequest& /*request*/, NativeHttpResponse& response){
+      tokenRequests++;
+      issuedTokens++;
+      snprintf(token, sizeof(token), "stub-token-%08lu", issuedTokens);
+      tokenExpiresAt = now() + tokenLifetimeSec;
+      int length = snprintf(body, sizeof(body), "{\"access_token\":\"%s\",\"scope\":\"am_application_scope default\",\"token_type\":\"Bearer\",\"expires_in\":%lu}",
+        token, (unsigned long)tokenLifetimeSec);
+      response.body = body;
+      response.length = length;
+      // The token endpoint answers with a length
+      response.chunked = false;
+    }
+
+    void handlePassingTimes(const NativeHttpRequest& request, NativeHttpResponse& response){
+      passingTimeRequests++;
+      char authorization[64];
+      bool expired = tokenExpiresAt != 0 && now() >= tokenExpiresAt;
+      if(!request.getHeader("Authorization", authorization, sizeof(authorization)) || token[0] == '\0' || expired
+        || strncmp(authorization, "Bearer ", 7) != 0 || strcmp(authorization + 7, token) != 0){
+        unauthorizedRequests++;
+        respond(response, 401, "{\"fault\":{\"code\":900901,\"message\":\"Invalid Credentials\"}}");
+        return;
+      }
+      if(forcedStatus != 0){
+        respond(response, forcedStatus, "{\"error\":\"stub\"}");
+        return;
+      }
+      // .../PassingTimeByPoint/5311%2C1715
+      const char* ids = strstr(request.path, "/PassingTimeByPoint/") + 20;
+      size_t length = snprintf(body, sizeof(body), "{\"points\":[");
+      int count = 0;
+      while(*ids != '\0' && count < STIB_STUB_MAX_POINTS && length + 256 < sizeof(body)){
+        size_t idLength = strcspn(ids, "%,");
+        char pointId[16];
+        snprintf(pointId, sizeof(pointId), "%.*s", (int)idLength, ids);
+        length += writePoint(body + length, sizeof(body) - length, pointId, count > 0);
+        count++;
+        points++;
+        ids += idLength;
+        ids += *ids == '%' ? 3 : (*ids == ',' ? 1 : 0);
+      }
+      length += snprintf(body + length, sizeof(body) - length, "]}");
+      response.body = body;
+      response.length = length;
+    }
+
+    size_t writePoint(char* out, size_t size, const char* pointId, bool comma){
+      static const char* const lines[] = {"71", "95", "5", "39"};
+      static const char* const destinations[][2] = {
+        {"DE BROUCKERE", "DE BROUCKERE"},
+        {"WIENER", "WIENER"},
+        {"STOCKEL", "STOKKEL"},
+        {"MONTGOMERY", "MONTGOMERY"}
+      };
+      size_t length = snprintf(out, size, "%s{\"passingTimes\":[", comma ? "," : "");
+      int count = emptyPoint != NULL && strcmp(emptyPoint, pointId) == 0 ? 0 : passingTimesPerPoint;
+      uint32_t start = now();
+      // Room is kept for the end of the point and of the payload
+      for(int i = 0; i < count && length + 256 < size; i++){
+        char expected[32];
+        formatTime(start + (i + 1) * intervalSec - 20, expected);
+        int line = i % 4;
+        length += snprintf(out + length, size - length,
+          "%s{\"destination\":{\"fr\":\"%s\",\"nl\":\"%s\"},\"expectedArrivalTime\":\"%s\",\"lineId\":\"%s\"}",
+          i > 0 ? "," : "", destinations[line][0], destinations[line][1], expected, lines[line]);
+      }
+      length += snprintf(out + length, size - length, "],\"pointId\":\"%s\"}", pointId);
+      return length;
+    }
+
+    /** Brussels time in winter, like the API: 2026-03-02T09:04:00+01:00 */
+    static void formatTime(uint32_t epoch, char* text){
+      time_t local = (time_t)epoch + 3600;
+      struct tm fields;
+      gmtime_r(&local, &fields);
+      strftime(text, 32, "%Y-%m-%dT%H:%M:%S+01:00", &fields);
+    }
+
+    static void respond(NativeHttpResponse& response, int status, const char* text){
+      response.status = status;
+      response.body = text;
+      response.length = strlen(text);
+      response.chunked = false;
+    }
+};
@@ -0,0 +1,384 @@
+#pragma once
+// Generated from the GTFS feed by tools/generate_timetable.py, do not edit
+#include "Pgmspace.h"
+
+#define TIMETABLE_STOP_ID_LENGTH 8
+#define TIMETABLE_STOP_COUNT 4
+#define TIMETABLE_SERVICE_COUNT 3
+#define TIMETABLE_EXCEPTION_COUNT 4
+#define TIMETABLE_PATTERN_COUNT 6
+#define TIMETABLE_DEPARTURE_COUNT 2381
+
+struct TimetableStop {
+  char id[TIMETABLE_STOP_ID_LENGTH];
+  uint16_t firstDeparture;
+  uint16_t numberOfDepartures;
+};
+
+/** Days since 1970-01-01, weekdays from bit 0 (monday) to bit 6 (sunday) */
+struct TimetableService {
+  uint16_t startDay;
+  uint16_t endDay;
+  uint8_t weekdays;
+};
+
+struct TimetableException {
+  uint16_t day;
+  uint8_t service;
+  uint8_t added;
+};
+
+struct TimetablePattern {
+  char line[4];
+  uint16_t destinationOffset;
+};
+
+struct TimetableDeparture {
+  uint16_t minute;
+  uint8_t pattern;
+  uint8_t service;
+};
+
+const char TIMETABLE_DESTINATIONS[] PROGMEM =
+  "AUDERGHEM-SHOPPING\0"
+  "DE BROUCKERE\0"
+  "HERRMANN-DEBROUX\0"
+  "SCHAERBEEK GARE\0"
+  "STOCKEL\0"
+  "WIENER\0"
+  "";
+
+const TimetableService TIMETABLE_SERVICES[TIMETABLE_SERVICE_COUNT + 1] PROGMEM = {
+  {20454, 20818, 0x20}, // SA
+  {20454, 20818, 0x40}, // SU
+  {20454, 20818, 0x1f}, // WD
+  {0, 0, 0}
+};
+
+const TimetableException TIMETABLE_EXCEPTIONS[TIMETABLE_EXCEPTION_COUNT + 1] PROGMEM = {
+  {20768, 1, 1},
+  {20768, 2, 0},
+  {20812, 1, 1},
+  {20812, 2, 0},
+  {0, 0, 0}
+};
+
+const TimetablePattern TIMETABLE_PATTERNS[TIMETABLE_PATTERN_COUNT + 1] PROGMEM = {
+  {"1", 65},
+  {"34", 0},
+  {"5", 32},
+  {"71", 19},
+  {"92", 49},
+  {"95", 73},
+  {"", 0}
+};
+
+const TimetableStop TIMETABLE_STOPS[TIMETABLE_STOP_COUNT + 1] PROGMEM = {
+  {"5311", 0, 596},
+  {"1715", 596, 571},
+  {"8211", 1167, 604},
+  {"5267", 1771, 610},
+  {"", 0, 0}
+};
+
+const TimetableDeparture TIMETABLE_DEPARTURES[TIMETABLE_DEPARTURE_COUNT + 1] PROGMEM = {
+  {320, 3, 0}, {320, 3, 1}, {320, 3, 2}, {325, 5, 0}, {325, 5, 1}, {325, 5, 2}, {332, 3, 0}, {332, 3, 2},
+  {335, 3, 1}, {337, 5, 0}, {337, 5, 2}, {340, 5, 1}, {344, 3, 0}, {344, 3, 2}, {349, 5, 0}, {349, 5, 2},
+  {350, 3, 1}, {355, 5, 1}, {356, 3, 0}, {356, 3, 2}, {361, 5, 0}, {361, 5, 2}, {365, 3, 1}, {368, 3, 0},
+  {368, 3, 2}, {370, 5, 1}, {373, 5, 0}, {373, 5, 2}, {380, 3, 0}, {380, 3, 1}, {380, 3, 2}, {385, 5, 0},
+  {385, 5, 1}, {385, 5, 2}, {392, 3, 0}, {392, 3, 2}, {395, 3, 1}, {397, 5, 0}, {397, 5, 2}, {400, 5, 1},
+  {404, 3, 0}, {404, 3, 2}, {409, 5, 0}, {409, 5, 2}, {410, 3, 1}, {415, 5, 1}, {416, 3, 0}, {416, 3, 2},
+  {421, 5, 0}, {421, 5, 2}, {425, 3, 1}, {427, 5, 2}, {428, 3, 0}, {428, 3, 2}, {430, 5, 1}, {433, 5, 0},
+  {433, 5, 2}, {434, 3, 2}, {439, 5, 2}, {440, 3, 0}, {440, 3, 1}, {440, 3, 2}, {445, 5, 0}, {445, 5, 1},
+  {445, 5, 2}, {446, 3, 2}, {451, 5, 2}, {452, 3, 0}, {452, 3, 2}, {455, 3, 1}, {457, 5, 0}, {457, 5, 2},
+  {458, 3, 2}, {460, 5, 1}, {463, 5, 2}, {464, 3, 0}, {464, 3, 2}, {469, 5, 0}, {469, 5, 2}, {470, 3, 1},
+  {470, 3, 2}, {475, 5, 1}, {475, 5, 2}, {476, 3, 0}, {476, 3, 2}, {481, 5, 0}, {481, 5, 2}, {482, 3, 2},
+  {485, 3, 1}, {487, 5, 2}, {488, 3, 0}, {488, 3, 2}, {490, 5, 1}, {493, 5, 0}, {493, 5, 2}, {494, 3, 2},
+  {499, 5, 2}, {500, 3, 0}, {500, 3, 1}, {500, 3, 2}, {505, 5, 0}, {505, 5, 1}, {505, 5, 2}, {506, 3, 2},
+  {511, 5, 2}, {512, 3, 0}, {512, 3, 2}, {515, 3, 1}, {517, 5, 0}, {517, 5, 2}, {518, 3, 2}, {520, 5, 1},
+  {523, 5, 2}, {524, 3, 0}, {524, 3, 2}, {529, 5, 0}, {529, 5, 2}, {530, 3, 1}, {530, 3, 2}, {535, 5, 1},
+  {535, 5, 2}, {536, 3, 0}, {536, 3, 2}, {541, 5, 0}, {541, 5, 2}, {542, 3, 2}, {545, 3, 1}, {547, 5, 2},
+  {548, 3, 0}, {548, 3, 2}, {550, 5, 1}, {553, 5, 0}, {553, 5, 2}, {554, 3, 2}, {559, 5, 2}, {560, 3, 0},
+  {560, 3, 1}, {560, 3, 2}, {565, 5, 0}, {565, 5, 1}, {565, 5, 2}, {566, 3, 2}, {571, 5, 2}, {572, 3, 0},
+  {572, 3, 2}, {575, 3, 1}, {577, 5, 0}, {580, 5, 1}, {581, 5, 2}, {582, 3, 2}, {584, 3, 0}, {589, 5, 0},
+  {590, 3, 1}, {591, 5, 2}, {592, 3, 2}, {595, 5, 1}, {596, 3, 0}, {601, 5, 0}, {601, 5, 2}, {602, 3, 2},
+  {605, 3, 1}, {608, 3, 0}, {610, 5, 1}, {611, 5, 2}, {612, 3, 2}, {613, 5, 0}, {620, 3, 0}, {620, 3, 1},
+  {621, 5, 2}, {622, 3, 2}, {625, 5, 0}, {625, 5, 1}, {631, 5, 2}, {632, 3, 0}, {632, 3, 2}, {635, 3, 1},
+  {637, 5, 0}, {640, 5, 1}, {641, 5, 2}, {642, 3, 2}, {644, 3, 0}, {649, 5, 0}, {650, 3, 1}, {651, 5, 2},
+  {652, 3, 2}, {655, 5, 1}, {656, 3, 0}, {661, 5, 0}, {661, 5, 2}, {662, 3, 2}, {665, 3, 1}, {668, 3, 0},
+  {670, 5, 1}, {671, 5, 2}, {672, 3, 2}, {673, 5, 0}, {680, 3, 0}, {680, 3, 1}, {681, 5, 2}, {682, 3, 2},
+  {685, 5, 0}, {685, 5, 1}, {691, 5, 2}, {692, 3, 0}, {692, 3, 2}, {695, 3, 1}, {697, 5, 0}, {700, 5, 1},
+  {701, 5, 2}, {702, 3, 2}, {704, 3, 0}, {709, 5, 0}, {710, 3, 1}, {711, 5, 2}, {712, 3, 2}, {715, 5, 1},
+  {716, 3, 0}, {721, 5, 0}, {721, 5, 2}, {722, 3, 2}, {725, 3, 1}, {728, 3, 0}, {730, 5, 1}, {731, 5, 2},
+  {732, 3, 2}, {733, 5, 0}, {740, 3, 0}, {740, 3, 1}, {741, 5, 2}, {742, 3, 2}, {745, 5, 0}, {745, 5, 1},
+  {751, 5, 2}, {752, 3, 0}, {752, 3, 2}, {755, 3, 1}, {757, 5, 0}, {760, 5, 1}, {761, 5, 2}, {762, 3, 2},
+  {764, 3, 0}, {769, 5, 0}, {770, 3, 1}, {771, 5, 2}, {772, 3, 2}, {775, 5, 1}, {776, 3, 0}, {781, 5, 0},
+  {781, 5, 2}, {782, 3, 2}, {785, 3, 1}, {788, 3, 0}, {790, 5, 1}, {791, 5, 2}, {792, 3, 2}, {793, 5, 0},
+  {800, 3, 0}, {800, 3, 1}, {801, 5, 2}, {802, 3, 2}, {805, 5, 0}, {805, 5, 1}, {811, 5, 2}, {812, 3, 0},
+  {812, 3, 2}, {815, 3, 1}, {817, 5, 0}, {820, 5, 1}, {821, 5, 2}, {822, 3, 2}, {824, 3, 0}, {829, 5, 0},
+  {830, 3, 1}, {831, 5, 2}, {832, 3, 2}, {835, 5, 1}, {836, 3, 0}, {841, 5, 0}, {841, 5, 2}, {842, 3, 2},
+  {845, 3, 1}, {848, 3, 0}, {850, 5, 1}, {851, 5, 2}, {852, 3, 2}, {853, 5, 0}, {860, 3, 0}, {860, 3, 1},
+  {861, 5, 2}, {862, 3, 2}, {865, 5, 0}, {865, 5, 1}, {871, 5, 2}, {872, 3, 0}, {872, 3, 2}, {875, 3, 1},
+  {877, 5, 0}, {880, 5, 1}, {881, 5, 2}, {882, 3, 2}, {884, 3, 0}, {889, 5, 0}, {890, 3, 1}, {891, 5, 2},
+  {892, 3, 2}, {895, 5, 1}, {896, 3, 0}, {901, 5, 0}, {901, 5, 2}, {902, 3, 2}, {905, 3, 1}, {908, 3, 0},
+  {910, 5, 1}, {911, 5, 2}, {912, 3, 2}, {913, 5, 0}, {920, 3, 0}, {920, 3, 1}, {921, 5, 2}, {922, 3, 2},
+  {925, 5, 0}, {925, 5, 1}, {931, 5, 2}, {932, 3, 0}, {932, 3, 2}, {935, 3, 1}, {937, 5, 0}, {940, 5, 1},
+  {941, 5, 2}, {942, 3, 2}, {944, 3, 0}, {949, 5, 0}, {950, 3, 1}, {951, 5, 2}, {952, 3, 2}, {955, 5, 1},
+  {956, 3, 0}, {961, 5, 0}, {961, 5, 2}, {962, 3, 2}, {965, 3, 1}, {967, 5, 2}, {968, 3, 0}, {968, 3, 2},
+  {970, 5, 1}, {973, 5, 0}, {973, 5, 2}, {974, 3, 2}, {979, 5, 2}, {980, 3, 0}, {980, 3, 1}, {980, 3, 2},
+  {985, 5, 0}, {985, 5, 1}, {985, 5, 2}, {986, 3, 2}, {991, 5, 2}, {992, 3, 0}, {992, 3, 2}, {995, 3, 1},
+  {997, 5, 0}, {997, 5, 2}, {998, 3, 2}, {1000, 5, 1}, {1003, 5, 2}, {1004, 3, 0}, {1004, 3, 2}, {1009, 5, 0},
+  {1009, 5, 2}, {1010, 3, 1}, {1010, 3, 2}, {1015, 5, 1}, {1015, 5, 2}, {1016, 3, 0}, {1016, 3, 2}, {1021, 5, 0},
+  {1021, 5, 2}, {1022, 3, 2}, {1025, 3, 1}, {1027, 5, 2}, {1028, 3, 0}, {1028, 3, 2}, {1030, 5, 1}, {1033, 5, 0},
+  {1033, 5, 2}, {1034, 3, 2}, {1039, 5, 2}, {1040, 3, 0}, {1040, 3, 1}, {1040, 3, 2}, {1045, 5, 0}, {1045, 5, 1},
+  {1045, 5, 2}, {1046, 3, 2}, {1051, 5, 2}, {1052, 3, 0}, {1052, 3, 2}, {1055, 3, 1}, {1057, 5, 0}, {1057, 5, 2},
+  {1058, 3, 2}, {1060, 5, 1}, {1063, 5, 2}, {1064, 3, 0}, {1064, 3, 2}, {1069, 5, 0}, {1069, 5, 2}, {1070, 3, 1},
+  {1070, 3, 2}, {1075, 5, 1}, {1075, 5, 2}, {1076, 3, 0}, {1076, 3, 2}, {1081, 5, 0}, {1081, 5, 2}, {1082, 3, 2},
+  {1085, 3, 1}, {1087, 5, 2}, {1088, 3, 0}, {1088, 3, 2}, {1090, 5, 1}, {1093, 5, 0}, {1093, 5, 2}, {1094, 3, 2},
+  {1099, 5, 2}, {1100, 3, 0}, {1100, 3, 1}, {1100, 3, 2}, {1105, 5, 0}, {1105, 5, 1}, {1105, 5, 2}, {1106, 3, 2},
+  {1111, 5, 2}, {1112, 3, 0}, {1112, 3, 2}, {1115, 3, 1}, {1117, 5, 0}, {1117, 5, 2}, {1118, 3, 2}, {1120, 5, 1},
+  {1123, 5, 2}, {1124, 3, 0}, {1124, 3, 2}, {1129, 5, 0}, {1129, 5, 2}, {1130, 3, 1}, {1130, 3, 2}, {1135, 5, 1},
+  {1135, 5, 2}, {1136, 3, 0}, {1136, 3, 2}, {1141, 5, 0}, {1141, 5, 2}, {1142, 3, 2}, {1145, 3, 1}, {1148, 3, 0},
+  {1150, 5, 1}, {1153, 5, 0}, {1153, 5, 2}, {1154, 3, 2}, {1160, 3, 0}, {1160, 3, 1}, {1165, 5, 0}, {1165, 5, 1},
+  {1165, 5, 2}, {1166, 3, 2}, {1172, 3, 0}, {1175, 3, 1}, {1177, 5, 0}, {1177, 5, 2}, {1178, 3, 2}, {1180, 5, 1},
+  {1184, 3, 0}, {1189, 5, 0}, {1189, 5, 2}, {1190, 3, 1}, {1190, 3, 2}, {1195, 5, 1}, {1196, 3, 0}, {1201, 5, 0},
+  {1201, 5, 2}, {1202, 3, 2}, {1205, 3, 1}, {1208, 3, 0}, {1210, 5, 1}, {1213, 5, 0}, {1213, 5, 2}, {1214, 3, 2},
+  {1220, 3, 0}, {1220, 3, 1}, {1225, 5, 0}, {1225, 5, 1}, {1225, 5, 2}, {1226, 3, 2}, {1232, 3, 0}, {1235, 3, 1},
+  {1237, 5, 0}, {1237, 5, 2}, {1238, 3, 2}, {1240, 5, 1}, {1244, 3, 0}, {1249, 5, 0}, {1249, 5, 2}, {1250, 3, 1},
+  {1250, 3, 2}, {1255, 5, 1}, {1256, 3, 0}, {1261, 5, 0}, {1261, 5, 2}, {1262, 3, 2}, {1265, 3, 1}, {1268, 3, 0},
+  {1270, 5, 1}, {1273, 5, 0}, {1273, 5, 2}, {1274, 3, 2}, {1280, 3, 0}, {1280, 3, 1}, {1285, 5, 0}, {1285, 5, 1},
+  {1285, 5, 2}, {1286, 3, 2}, {1292, 3, 0}, {1295, 3, 1}, {1297, 5, 0}, {1297, 5, 2}, {1298, 3, 2}, {1300, 5, 1},
+  {1304, 3, 0}, {1309, 5, 0}, {1309, 5, 2}, {1310, 3, 1}, {1310, 3, 2}, {1315, 5, 1}, {1316, 3, 0}, {1321, 5, 0},
+  {1321, 5, 2}, {1322, 3, 2}, {1325, 3, 1}, {1328, 3, 0}, {1330, 5, 1}, {1333, 5, 0}, {1333, 5, 2}, {1334, 3, 2},
+  {1340, 3, 0}, {1340, 3, 1}, {1345, 5, 0}, {1345, 5, 1}, {1345, 5, 2}, {1346, 3, 2}, {1352, 3, 0}, {1355, 3, 1},
+  {1357, 5, 0}, {1357, 5, 2}, {1358, 3, 2}, {1360, 5, 1}, {1364, 3, 0}, {1369, 5, 0}, {1369, 5, 2}, {1370, 3, 1},
+  {1370, 3, 2}, {1375, 5, 1}, {1376, 3, 0}, {1381, 5, 0}, {1381, 5, 2}, {1382, 3, 2}, {1385, 3, 1}, {1388, 3, 0},
+  {1390, 5, 1}, {1393, 5, 0}, {1393, 5, 2}, {1394, 3, 2}, {1400, 3, 0}, {1400, 3, 1}, {1405, 5, 0}, {1405, 5, 1},
+  {1405, 5, 2}, {1406, 3, 2}, {1412, 3, 0}, {1415, 3, 1}, {1417, 5, 0}, {1417, 5, 2}, {1418, 3, 2}, {1420, 5, 1},
+  {1424, 3, 0}, {1429, 5, 0}, {1429, 5, 2}, {1430, 3, 1}, {1430, 3, 2}, {1436, 3, 0}, {1442, 3, 2}, {1445, 3, 1},
+  {1448, 3, 0}, {1454, 3, 2}, {1460, 3, 0}, {1460, 3, 1}, {332, 5, 0}, {332, 5, 1}, {332, 5, 2}, {344, 5, 0},
+  {344, 5, 2}, {345, 1, 0}, {345, 1, 1}, {345, 1, 2}, {347, 5, 1}, {356, 5, 0}, {356, 5, 2}, {357, 1, 0},
+  {357, 1, 2}, {360, 1, 1}, {362, 5, 1}, {368, 5, 0}, {368, 5, 2}, {369, 1, 0}, {369, 1, 2}, {375, 1, 1},
+  {377, 5, 1}, {380, 5, 0}, {380, 5, 2}, {381, 1, 0}, {381, 1, 2}, {390, 1, 1}, {392, 5, 0}, {392, 5, 1},
+  {392, 5, 2}, {393, 1, 0}, {393, 1, 2}, {404, 5, 0}, {404, 5, 2}, {405, 1, 0}, {405, 1, 1}, {405, 1, 2},
+  {407, 5, 1}, {416, 5, 0}, {416, 5, 2}, {417, 1, 0}, {417, 1, 2}, {420, 1, 1}, {422, 5, 1}, {428, 5, 0},
+  {428, 5, 2}, {429, 1, 0}, {429, 1, 2}, {434, 5, 2}, {435, 1, 1}, {435, 1, 2}, {437, 5, 1}, {440, 5, 0},
+  {440, 5, 2}, {441, 1, 0}, {441, 1, 2}, {446, 5, 2}, {447, 1, 2}, {450, 1, 1}, {452, 5, 0}, {452, 5, 1},
+  {452, 5, 2}, {453, 1, 0}, {453, 1, 2}, {458, 5, 2}, {459, 1, 2}, {464, 5, 0}, {464, 5, 2}, {465, 1, 0},
+  {465, 1, 1}, {465, 1, 2}, {467, 5, 1}, {470, 5, 2}, {471, 1, 2}, {476, 5, 0}, {476, 5, 2}, {477, 1, 0},
+  {477, 1, 2}, {480, 1, 1}, {482, 5, 1}, {482, 5, 2}, {483, 1, 2}, {488, 5, 0}, {488, 5, 2}, {489, 1, 0},
+  {489, 1, 2}, {494, 5, 2}, {495, 1, 1}, {495, 1, 2}, {497, 5, 1}, {500, 5, 0}, {500, 5, 2}, {501, 1, 0},
+  {501, 1, 2}, {506, 5, 2}, {507, 1, 2}, {510, 1, 1}, {512, 5, 0}, {512, 5, 1}, {512, 5, 2}, {513, 1, 0},
+  {513, 1, 2}, {518, 5, 2}, {519, 1, 2}, {524, 5, 0}, {524, 5, 2}, {525, 1, 0}, {525, 1, 1}, {525, 1, 2},
+  {527, 5, 1}, {530, 5, 2}, {531, 1, 2}, {536, 5, 0}, {536, 5, 2}, {537, 1, 0}, {537, 1, 2}, {540, 1, 1},
+  {542, 5, 1}, {542, 5, 2}, {543, 1, 2}, {548, 5, 0}, {548, 5, 2}, {549, 1, 0}, {549, 1, 2}, {554, 5, 2},
+  {555, 1, 1}, {555, 1, 2}, {557, 5, 1}, {560, 5, 0}, {560, 5, 2}, {561, 1, 0}, {561, 1, 2}, {566, 5, 2},
+  {567, 1, 2}, {570, 1, 1}, {572, 5, 0}, {572, 5, 1}, {572, 5, 2}, {573, 1, 0}, {573, 1, 2}, {578, 5, 2},
+  {583, 1, 2}, {584, 5, 0}, {585, 1, 0}, {585, 1, 1}, {587, 5, 1}, {588, 5, 2}, {593, 1, 2}, {596, 5, 0},
+  {597, 1, 0}, {598, 5, 2}, {600, 1, 1}, {602, 5, 1}, {603, 1, 2}, {608, 5, 0}, {608, 5, 2}, {609, 1, 0},
+  {613, 1, 2}, {615, 1, 1}, {617, 5, 1}, {618, 5, 2}, {620, 5, 0}, {621, 1, 0}, {623, 1, 2}, {628, 5, 2},
+  {630, 1, 1}, {632, 5, 0}, {632, 5, 1}, {633, 1, 0}, {633, 1, 2}, {638, 5, 2}, {643, 1, 2}, {644, 5, 0},
+  {645, 1, 0}, {645, 1, 1}, {647, 5, 1}, {648, 5, 2}, {653, 1, 2}, {656, 5, 0}, {657, 1, 0}, {658, 5, 2},
+  {660, 1, 1}, {662, 5, 1}, {663, 1, 2}, {668, 5, 0}, {668, 5, 2}, {669, 1, 0}, {673, 1, 2}, {675, 1, 1},
+  {677, 5, 1}, {678, 5, 2}, {680, 5, 0}, {681, 1, 0}, {683, 1, 2}, {688, 5, 2}, {690, 1, 1}, {692, 5, 0},
+  {692, 5, 1}, {693, 1, 0}, {693, 1, 2}, {698, 5, 2}, {703, 1, 2}, {704, 5, 0}, {705, 1, 0}, {705, 1, 1},
+  {707, 5, 1}, {708, 5, 2}, {713, 1, 2}, {716, 5, 0}, {717, 1, 0}, {718, 5, 2}, {720, 1, 1}, {722, 5, 1},
+  {723, 1, 2}, {728, 5, 0}, {728, 5, 2}, {729, 1, 0}, {733, 1, 2}, {735, 1, 1}, {737, 5, 1}, {738, 5, 2},
+  {740, 5, 0}, {741, 1, 0}, {743, 1, 2}, {748, 5, 2}, {750, 1, 1}, {752, 5, 0}, {752, 5, 1}, {753, 1, 0},
+  {753, 1, 2}, {758, 5, 2}, {763, 1, 2}, {764, 5, 0}, {765, 1, 0}, {765, 1, 1}, {767, 5, 1}, {768, 5, 2},
+  {773, 1, 2}, {776, 5, 0}, {777, 1, 0}, {778, 5, 2}, {780, 1, 1}, {782, 5, 1}, {783, 1, 2}, {788, 5, 0},
+  {788, 5, 2}, {789, 1, 0}, {793, 1, 2}, {795, 1, 1}, {797, 5, 1}, {798, 5, 2}, {800, 5, 0}, {801, 1, 0},
+  {803, 1, 2}, {808, 5, 2}, {810, 1, 1}, {812, 5, 0}, {812, 5, 1}, {813, 1, 0}, {813, 1, 2}, {818, 5, 2},
+  {823, 1, 2}, {824, 5, 0}, {825, 1, 0}, {825, 1, 1}, {827, 5, 1}, {828, 5, 2}, {833, 1, 2}, {836, 5, 0},
+  {837, 1, 0}, {838, 5, 2}, {840, 1, 1}, {842, 5, 1}, {843, 1, 2}, {848, 5, 0}, {848, 5, 2}, {849, 1, 0},
+  {853, 1, 2}, {855, 1, 1}, {857, 5, 1}, {858, 5, 2}, {860, 5, 0}, {861, 1, 0}, {863, 1, 2}, {868, 5, 2},
+  {870, 1, 1}, {872, 5, 0}, {872, 5, 1}, {873, 1, 0}, {873, 1, 2}, {878, 5, 2}, {883, 1, 2}, {884, 5, 0},
+  {885, 1, 0}, {885, 1, 1}, {887, 5, 1}, {888, 5, 2}, {893, 1, 2}, {896, 5, 0}, {897, 1, 0}, {898, 5, 2},
+  {900, 1, 1}, {902, 5, 1}, {903, 1, 2}, {908, 5, 0}, {908, 5, 2}, {909, 1, 0}, {913, 1, 2}, {915, 1, 1},
+  {917, 5, 1}, {918, 5, 2}, {920, 5, 0}, {921, 1, 0}, {923, 1, 2}, {928, 5, 2}, {930, 1, 1}, {932, 5, 0},
+  {932, 5, 1}, {933, 1, 0}, {933, 1, 2}, {938, 5, 2}, {943, 1, 2}, {944, 5, 0}, {945, 1, 0}, {945, 1, 1},
+  {947, 5, 1}, {948, 5, 2}, {953, 1, 2}, {956, 5, 0}, {957, 1, 0}, {958, 5, 2}, {960, 1, 1}, {962, 5, 1},
+  {963, 1, 2}, {968, 5, 0}, {968, 5, 2}, {969, 1, 0}, {969, 1, 2}, {974, 5, 2}, {975, 1, 1}, {975, 1, 2},
+  {977, 5, 1}, {980, 5, 0}, {980, 5, 2}, {981, 1, 0}, {981, 1, 2}, {986, 5, 2}, {987, 1, 2}, {990, 1, 1},
+  {992, 5, 0}, {992, 5, 1}, {992, 5, 2}, {993, 1, 0}, {993, 1, 2}, {998, 5, 2}, {999, 1, 2}, {1004, 5, 0},
+  {1004, 5, 2}, {1005, 1, 0}, {1005, 1, 1}, {1005, 1, 2}, {1007, 5, 1}, {1010, 5, 2}, {1011, 1, 2}, {1016, 5, 0},
+  {1016, 5, 2}, {1017, 1, 0}, {1017, 1, 2}, {1020, 1, 1}, {1022, 5, 1}, {1022, 5, 2}, {1023, 1, 2}, {1028, 5, 0},
+  {1028, 5, 2}, {1029, 1, 0}, {1029, 1, 2}, {1034, 5, 2}, {1035, 1, 1}, {1035, 1, 2}, {1037, 5, 1}, {1040, 5, 0},
+  {1040, 5, 2}, {1041, 1, 0}, {1041, 1, 2}, {1046, 5, 2}, {1047, 1, 2}, {1050, 1, 1}, {1052, 5, 0}, {1052, 5, 1},
+  {1052, 5, 2}, {1053, 1, 0}, {1053, 1, 2}, {1058, 5, 2}, {1059, 1, 2}, {1064, 5, 0}, {1064, 5, 2}, {1065, 1, 0},
+  {1065, 1, 1}, {1065, 1, 2}, {1067, 5, 1}, {1070, 5, 2}, {1071, 1, 2}, {1076, 5, 0}, {1076, 5, 2}, {1077, 1, 0},
+  {1077, 1, 2}, {1080, 1, 1}, {1082, 5, 1}, {1082, 5, 2}, {1083, 1, 2}, {1088, 5, 0}, {1088, 5, 2}, {1089, 1, 0},
+  {1089, 1, 2}, {1094, 5, 2}, {1095, 1, 1}, {1095, 1, 2}, {1097, 5, 1}, {1100, 5, 0}, {1100, 5, 2}, {1101, 1, 0},
+  {1101, 1, 2}, {1106, 5, 2}, {1107, 1, 2}, {1110, 1, 1}, {1112, 5, 0}, {1112, 5, 1}, {1112, 5, 2}, {1113, 1, 0},
+  {1113, 1, 2}, {1118, 5, 2}, {1119, 1, 2}, {1124, 5, 0}, {1124, 5, 2}, {1125, 1, 0}, {1125, 1, 1}, {1125, 1, 2},
+  {1127, 5, 1}, {1130, 5, 2}, {1131, 1, 2}, {1136, 5, 0}, {1136, 5, 2}, {1137, 1, 0}, {1137, 1, 2}, {1140, 1, 1},
+  {1142, 5, 1}, {1142, 5, 2}, {1143, 1, 2}, {1148, 5, 0}, {1148, 5, 2}, {1149, 1, 0}, {1155, 1, 1}, {1155, 1, 2},
+  {1157, 5, 1}, {1160, 5, 0}, {1160, 5, 2}, {1161, 1, 0}, {1167, 1, 2}, {1170, 1, 1}, {1172, 5, 0}, {1172, 5, 1},
+  {1172, 5, 2}, {1173, 1, 0}, {1179, 1, 2}, {1184, 5, 0}, {1184, 5, 2}, {1185, 1, 0}, {1185, 1, 1}, {1187, 5, 1},
+  {1191, 1, 2}, {1196, 5, 0}, {1196, 5, 2}, {1197, 1, 0}, {1200, 1, 1}, {1202, 5, 1}, {1203, 1, 2}, {1208, 5, 0},
+  {1208, 5, 2}, {1209, 1, 0}, {1215, 1, 1}, {1215, 1, 2}, {1217, 5, 1}, {1220, 5, 0}, {1220, 5, 2}, {1221, 1, 0},
+  {1227, 1, 2}, {1230, 1, 1}, {1232, 5, 0}, {1232, 5, 1}, {1232, 5, 2}, {1233, 1, 0}, {1239, 1, 2}, {1244, 5, 0},
+  {1244, 5, 2}, {1245, 1, 0}, {1245, 1, 1}, {1247, 5, 1}, {1251, 1, 2}, {1256, 5, 0}, {1256, 5, 2}, {1257, 1, 0},
+  {1260, 1, 1}, {1262, 5, 1}, {1263, 1, 2}, {1268, 5, 0}, {1268, 5, 2}, {1269, 1, 0}, {1275, 1, 1}, {1275, 1, 2},
+  {1277, 5, 1}, {1280, 5, 0}, {1280, 5, 2}, {1281, 1, 0}, {1287, 1, 2}, {1290, 1, 1}, {1292, 5, 0}, {1292, 5, 1},
+  {1292, 5, 2}, {1293, 1, 0}, {1299, 1, 2}, {1304, 5, 0}, {1304, 5, 2}, {1305, 1, 0}, {1305, 1, 1}, {1307, 5, 1},
+  {1311, 1, 2}, {1316, 5, 0}, {1316, 5, 2}, {1317, 1, 0}, {1320, 1, 1}, {1322, 5, 1}, {1323, 1, 2}, {1328, 5, 0},
+  {1328, 5, 2}, {1329, 1, 0}, {1335, 1, 1}, {1335, 1, 2}, {1337, 5, 1}, {1340, 5, 0}, {1340, 5, 2}, {1341, 1, 0},
+  {1347, 1, 2}, {1350, 1, 1}, {1352, 5, 0}, {1352, 5, 1}, {1352, 5, 2}, {1353, 1, 0}, {1359, 1, 2}, {1364, 5, 0},
+  {1364, 5, 2}, {1365, 1, 0}, {1365, 1, 1}, {1367, 5, 1}, {1371, 1, 2}, {1376, 5, 0}, {1376, 5, 2}, {1377, 1, 0},
+  {1380, 1, 1}, {1382, 5, 1}, {1388, 5, 0}, {1388, 5, 2}, {1397, 5, 1}, {1400, 5, 0}, {1400, 5, 2}, {1412, 5, 0},
+  {1412, 5, 1}, {1412, 5, 2}, {1424, 5, 0}, {1424, 5, 2}, {1427, 5, 1}, {1436, 5, 0}, {1436, 5, 2}, {330, 0, 0},
+  {330, 0, 1}, {330, 0, 2}, {335, 2, 0}, {335, 2, 1}, {335, 2, 2}, {342, 0, 0}, {342, 0, 2}, {345, 0, 1},
+  {347, 2, 0}, {347, 2, 2}, {350, 2, 1}, {354, 0, 0}, {354, 0, 2}, {359, 2, 0}, {359, 2, 2}, {360, 0, 1},
+  {365, 2, 1}, {366, 0, 0}, {366, 0, 2}, {371, 2, 0}, {371, 2, 2}, {375, 0, 1}, {378, 0, 0}, {378, 0, 2},
+  {380, 2, 1}, {383, 2, 0}, {383, 2, 2}, {390, 0, 0}, {390, 0, 1}, {390, 0, 2}, {395, 2, 0}, {395, 2, 1},
+  {395, 2, 2}, {402, 0, 0}, {402, 0, 2}, {405, 0, 1}, {407, 2, 0}, {407, 2, 2}, {410, 2, 1}, {414, 0, 0},
+  {414, 0, 2}, {419, 2, 0}, {419, 2, 2}, {420, 0, 1}, {425, 2, 1}, {426, 0, 0}, {426, 0, 2}, {431, 2, 0},
+  {431, 2, 2}, {432, 0, 2}, {435, 0, 1}, {437, 2, 2}, {438, 0, 0}, {438, 0, 2}, {440, 2, 1}, {443, 2, 0},
+  {443, 2, 2}, {444, 0, 2}, {449, 2, 2}, {450, 0, 0}, {450, 0, 1}, {450, 0, 2}, {455, 2, 0}, {455, 2, 1},
+  {455, 2, 2}, {456, 0, 2}, {461, 2, 2}, {462, 0, 0}, {462, 0, 2}, {465, 0, 1}, {467, 2, 0}, {467, 2, 2},
+  {468, 0, 2}, {470, 2, 1}, {473, 2, 2}, {474, 0, 0}, {474, 0, 2}, {479, 2, 0}, {479, 2, 2}, {480, 0, 1},
+  {480, 0, 2}, {485, 2, 1}, {485, 2, 2}, {486, 0, 0}, {486, 0, 2}, {491, 2, 0}, {491, 2, 2}, {492, 0, 2},
+  {495, 0, 1}, {497, 2, 2}, {498, 0, 0}, {498, 0, 2}, {500, 2, 1}, {503, 2, 0}, {503, 2, 2}, {504, 0, 2},
+  {509, 2, 2}, {510, 0, 0}, {510, 0, 1}, {510, 0, 2}, {515, 2, 0}, {515, 2, 1}, {515, 2, 2}, {516, 0, 2},
+  {521, 2, 2}, {522, 0, 0}, {522, 0, 2}, {525, 0, 1}, {527, 2, 0}, {527, 2, 2}, {528, 0, 2}, {530, 2, 1},
+  {533, 2, 2}, {534, 0, 0}, {534, 0, 2}, {539, 2, 0}, {539, 2, 2}, {540, 0, 1}, {540, 0, 2}, {545, 2, 1},
+  {545, 2, 2}, {546, 0, 0}, {546, 0, 2}, {551, 2, 0}, {551, 2, 2}, {552, 0, 2}, {555, 0, 1}, {557, 2, 2},
+  {558, 0, 0}, {558, 0, 2}, {560, 2, 1}, {563, 2, 0}, {563, 2, 2}, {564, 0, 2}, {569, 2, 2}, {570, 0, 0},
+  {570, 0, 1}, {570, 0, 2}, {575, 2, 0}, {575, 2, 1}, {575, 2, 2}, {580, 0, 2}, {582, 0, 0}, {585, 0, 1},
+  {585, 2, 2}, {587, 2, 0}, {590, 0, 2}, {590, 2, 1}, {594, 0, 0}, {595, 2, 2}, {599, 2, 0}, {600, 0, 1},
+  {600, 0, 2}, {605, 2, 1}, {605, 2, 2}, {606, 0, 0}, {610, 0, 2}, {611, 2, 0}, {615, 0, 1}, {615, 2, 2},
+  {618, 0, 0}, {620, 0, 2}, {620, 2, 1}, {623, 2, 0}, {625, 2, 2}, {630, 0, 0}, {630, 0, 1}, {630, 0, 2},
+  {635, 2, 0}, {635, 2, 1}, {635, 2, 2}, {640, 0, 2}, {642, 0, 0}, {645, 0, 1}, {645, 2, 2}, {647, 2, 0},
+  {650, 0, 2}, {650, 2, 1}, {654, 0, 0}, {655, 2, 2}, {659, 2, 0}, {660, 0, 1}, {660, 0, 2}, {665, 2, 1},
+  {665, 2, 2}, {666, 0, 0}, {670, 0, 2}, {671, 2, 0}, {675, 0, 1}, {675, 2, 2}, {678, 0, 0}, {680, 0, 2},
+  {680, 2, 1}, {683, 2, 0}, {685, 2, 2}, {690, 0, 0}, {690, 0, 1}, {690, 0, 2}, {695, 2, 0}, {695, 2, 1},
+  {695, 2, 2}, {700, 0, 2}, {702, 0, 0}, {705, 0, 1}, {705, 2, 2}, {707, 2, 0}, {710, 0, 2}, {710, 2, 1},
+  {714, 0, 0}, {715, 2, 2}, {719, 2, 0}, {720, 0, 1}, {720, 0, 2}, {725, 2, 1}, {725, 2, 2}, {726, 0, 0},
+  {730, 0, 2}, {731, 2, 0}, {735, 0, 1}, {735, 2, 2}, {738, 0, 0}, {740, 0, 2}, {740, 2, 1}, {743, 2, 0},
+  {745, 2, 2}, {750, 0, 0}, {750, 0, 1}, {750, 0, 2}, {755, 2, 0}, {755, 2, 1}, {755, 2, 2}, {760, 0, 2},
+  {762, 0, 0}, {765, 0, 1}, {765, 2, 2}, {767, 2, 0}, {770, 0, 2}, {770, 2, 1}, {774, 0, 0}, {775, 2, 2},
+  {779, 2, 0}, {780, 0, 1}, {780, 0, 2}, {785, 2, 1}, {785, 2, 2}, {786, 0, 0}, {790, 0, 2}, {791, 2, 0},
+  {795, 0, 1}, {795, 2, 2}, {798, 0, 0}, {800, 0, 2}, {800, 2, 1}, {803, 2, 0}, {805, 2, 2}, {810, 0, 0},
+  {810, 0, 1}, {810, 0, 2}, {815, 2, 0}, {815, 2, 1}, {815, 2, 2}, {820, 0, 2}, {822, 0, 0}, {825, 0, 1},
+  {825, 2, 2}, {827, 2, 0}, {830, 0, 2}, {830, 2, 1}, {834, 0, 0}, {835, 2, 2}, {839, 2, 0}, {840, 0, 1},
+  {840, 0, 2}, {845, 2, 1}, {845, 2, 2}, {846, 0, 0}, {850, 0, 2}, {851, 2, 0}, {855, 0, 1}, {855, 2, 2},
+  {858, 0, 0}, {860, 0, 2}, {860, 2, 1}, {863, 2, 0}, {865, 2, 2}, {870, 0, 0}, {870, 0, 1}, {870, 0, 2},
+  {875, 2, 0}, {875, 2, 1}, {875, 2, 2}, {880, 0, 2}, {882, 0, 0}, {885, 0, 1}, {885, 2, 2}, {887, 2, 0},
+  {890, 0, 2}, {890, 2, 1}, {894, 0, 0}, {895, 2, 2}, {899, 2, 0}, {900, 0, 1}, {900, 0, 2}, {905, 2, 1},
+  {905, 2, 2}, {906, 0, 0}, {910, 0, 2}, {911, 2, 0}, {915, 0, 1}, {915, 2, 2}, {918, 0, 0}, {920, 0, 2},
+  {920, 2, 1}, {923, 2, 0}, {925, 2, 2}, {930, 0, 0}, {930, 0, 1}, {930, 0, 2}, {935, 2, 0}, {935, 2, 1},
+  {935, 2, 2}, {940, 0, 2}, {942, 0, 0}, {945, 0, 1}, {945, 2, 2}, {947, 2, 0}, {950, 0, 2}, {950, 2, 1},
+  {954, 0, 0}, {955, 2, 2}, {959, 2, 0}, {960, 0, 1}, {960, 0, 2}, {965, 2, 1}, {965, 2, 2}, {966, 0, 0},
+  {966, 0, 2}, {971, 2, 0}, {971, 2, 2}, {972, 0, 2}, {975, 0, 1}, {977, 2, 2}, {978, 0, 0}, {978, 0, 2},
+  {980, 2, 1}, {983, 2, 0}, {983, 2, 2}, {984, 0, 2}, {989, 2, 2}, {990, 0, 0}, {990, 0, 1}, {990, 0, 2},
+  {995, 2, 0}, {995, 2, 1}, {995, 2, 2}, {996, 0, 2}, {1001, 2, 2}, {1002, 0, 0}, {1002, 0, 2}, {1005, 0, 1},
+  {1007, 2, 0}, {1007, 2, 2}, {1008, 0, 2}, {1010, 2, 1}, {1013, 2, 2}, {1014, 0, 0}, {1014, 0, 2}, {1019, 2, 0},
+  {1019, 2, 2}, {1020, 0, 1}, {1020, 0, 2}, {1025, 2, 1}, {1025, 2, 2}, {1026, 0, 0}, {1026, 0, 2}, {1031, 2, 0},
+  {1031, 2, 2}, {1032, 0, 2}, {1035, 0, 1}, {1037, 2, 2}, {1038, 0, 0}, {1038, 0, 2}, {1040, 2, 1}, {1043, 2, 0},
+  {1043, 2, 2}, {1044, 0, 2}, {1049, 2, 2}, {1050, 0, 0}, {1050, 0, 1}, {1050, 0, 2}, {1055, 2, 0}, {1055, 2, 1},
+  {1055, 2, 2}, {1056, 0, 2}, {1061, 2, 2}, {1062, 0, 0}, {1062, 0, 2}, {1065, 0, 1}, {1067, 2, 0}, {1067, 2, 2},
+  {1068, 0, 2}, {1070, 2, 1}, {1073, 2, 2}, {1074, 0, 0}, {1074, 0, 2}, {1079, 2, 0}, {1079, 2, 2}, {1080, 0, 1},
+  {1080, 0, 2}, {1085, 2, 1}, {1085, 2, 2}, {1086, 0, 0}, {1086, 0, 2}, {1091, 2, 0}, {1091, 2, 2}, {1092, 0, 2},
+  {1095, 0, 1}, {1097, 2, 2}, {1098, 0, 0}, {1098, 0, 2}, {1100, 2, 1}, {1103, 2, 0}, {1103, 2, 2}, {1104, 0, 2},
+  {1109, 2, 2}, {1110, 0, 0}, {1110, 0, 1}, {1110, 0, 2}, {1115, 2, 0}, {1115, 2, 1}, {1115, 2, 2}, {1116, 0, 2},
+  {1121, 2, 2}, {1122, 0, 0}, {1122, 0, 2}, {1125, 0, 1}, {1127, 2, 0}, {1127, 2, 2}, {1128, 0, 2}, {1130, 2, 1},
+  {1133, 2, 2}, {1134, 0, 0}, {1134, 0, 2}, {1139, 2, 0}, {1139, 2, 2}, {1140, 0, 1}, {1140, 0, 2}, {1145, 2, 1},
+  {1145, 2, 2}, {1146, 0, 0}, {1151, 2, 0}, {1152, 0, 2}, {1155, 0, 1}, {1157, 2, 2}, {1158, 0, 0}, {1160, 2, 1},
+  {1163, 2, 0}, {1164, 0, 2}, {1169, 2, 2}, {1170, 0, 0}, {1170, 0, 1}, {1175, 2, 0}, {1175, 2, 1}, {1176, 0, 2},
+  {1181, 2, 2}, {1182, 0, 0}, {1185, 0, 1}, {1187, 2, 0}, {1188, 0, 2}, {1190, 2, 1}, {1193, 2, 2}, {1194, 0, 0},
+  {1199, 2, 0}, {1200, 0, 1}, {1200, 0, 2}, {1205, 2, 1}, {1205, 2, 2}, {1206, 0, 0}, {1211, 2, 0}, {1212, 0, 2},
+  {1215, 0, 1}, {1217, 2, 2}, {1218, 0, 0}, {1220, 2, 1}, {1223, 2, 0}, {1224, 0, 2}, {1229, 2, 2}, {1230, 0, 0},
+  {1230, 0, 1}, {1235, 2, 0}, {1235, 2, 1}, {1236, 0, 2}, {1241, 2, 2}, {1242, 0, 0}, {1245, 0, 1}, {1247, 2, 0},
+  {1248, 0, 2}, {1250, 2, 1}, {1253, 2, 2}, {1254, 0, 0}, {1259, 2, 0}, {1260, 0, 1}, {1260, 0, 2}, {1265, 2, 1},
+  {1265, 2, 2}, {1266, 0, 0}, {1271, 2, 0}, {1272, 0, 2}, {1275, 0, 1}, {1277, 2, 2}, {1278, 0, 0}, {1280, 2, 1},
+  {1283, 2, 0}, {1284, 0, 2}, {1289, 2, 2}, {1290, 0, 0}, {1290, 0, 1}, {1295, 2, 0}, {1295, 2, 1}, {1296, 0, 2},
+  {1301, 2, 2}, {1302, 0, 0}, {1305, 0, 1}, {1307, 2, 0}, {1308, 0, 2}, {1310, 2, 1}, {1313, 2, 2}, {1314, 0, 0},
+  {1319, 2, 0}, {1320, 0, 1}, {1320, 0, 2}, {1325, 2, 1}, {1325, 2, 2}, {1326, 0, 0}, {1331, 2, 0}, {1332, 0, 2},
+  {1335, 0, 1}, {1337, 2, 2}, {1338, 0, 0}, {1340, 2, 1}, {1343, 2, 0}, {1344, 0, 2}, {1349, 2, 2}, {1350, 0, 0},
+  {1350, 0, 1}, {1355, 2, 0}, {1355, 2, 1}, {1356, 0, 2}, {1361, 2, 2}, {1362, 0, 0}, {1365, 0, 1}, {1367, 2, 0},
+  {1368, 0, 2}, {1370, 2, 1}, {1373, 2, 2}, {1374, 0, 0}, {1379, 2, 0}, {1380, 0, 1}, {1380, 0, 2}, {1385, 2, 1},
+  {1385, 2, 2}, {1386, 0, 0}, {1391, 2, 0}, {1392, 0, 2}, {1395, 0, 1}, {1397, 2, 2}, {1398, 0, 0}, {1400, 2, 1},
+  {1403, 2, 0}, {1404, 0, 2}, {1409, 2, 2}, {1410, 0, 0}, {1410, 0, 1}, {1415, 2, 0}, {1415, 2, 1}, {1416, 0, 2},
+  {1421, 2, 2}, {1422, 0, 0}, {1425, 0, 1}, {1427, 2, 0}, {1428, 0, 2}, {1430, 2, 1}, {1433, 2, 2}, {1434, 0, 0},
+  {1439, 2, 0}, {1440, 0, 1}, {1440, 0, 2}, {1445, 2, 1}, {1445, 2, 2}, {1446, 0, 0}, {1451, 2, 0}, {1452, 0, 2},
+  {1455, 0, 1}, {1457, 2, 2}, {1458, 0, 0}, {1460, 2, 1}, {1463, 2, 0}, {1464, 0, 2}, {1469, 2, 2}, {1470, 0, 0},
+  {1470, 0, 1}, {1475, 2, 0}, {1475, 2, 1}, {315, 4, 0}, {315, 4, 1}, {315, 4, 2}, {327, 4, 0}, {327, 4, 2},
+  {330, 4, 1}, {334, 3, 0}, {334, 3, 1}, {334, 3, 2}, {339, 4, 0}, {339, 4, 2}, {345, 4, 1}, {346, 3, 0},
+  {346, 3, 2}, {349, 3, 1}, {351, 4, 0}, {351, 4, 2}, {358, 3, 0}, {358, 3, 2}, {360, 4, 1}, {363, 4, 0},
+  {363, 4, 2}, {364, 3, 1}, {370, 3, 0}, {370, 3, 2}, {375, 4, 0}, {375, 4, 1}, {375, 4, 2}, {379, 3, 1},
+  {382, 3, 0}, {382, 3, 2}, {387, 4, 0}, {387, 4, 2}, {390, 4, 1}, {394, 3, 0}, {394, 3, 1}, {394, 3, 2},
+  {399, 4, 0}, {399, 4, 2}, {405, 4, 1}, {406, 3, 0}, {406, 3, 2}, {409, 3, 1}, {411, 4, 0}, {411, 4, 2},
+  {418, 3, 0}, {418, 3, 2}, {420, 4, 1}, {423, 4, 0}, {423, 4, 2}, {424, 3, 1}, {429, 4, 2}, {430, 3, 0},
+  {430, 3, 2}, {435, 4, 0}, {435, 4, 1}, {435, 4, 2}, {439, 3, 1}, {441, 4, 2}, {442, 3, 0}, {442, 3, 2},
+  {447, 4, 0}, {447, 4, 2}, {448, 3, 2}, {450, 4, 1}, {453, 4, 2}, {454, 3, 0}, {454, 3, 1}, {454, 3, 2},
+  {459, 4, 0}, {459, 4, 2}, {460, 3, 2}, {465, 4, 1}, {465, 4, 2}, {466, 3, 0}, {466, 3, 2}, {469, 3, 1},
+  {471, 4, 0}, {471, 4, 2}, {472, 3, 2}, {477, 4, 2}, {478, 3, 0}, {478, 3, 2}, {480, 4, 1}, {483, 4, 0},
+  {483, 4, 2}, {484, 3, 1}, {484, 3, 2}, {489, 4, 2}, {490, 3, 0}, {490, 3, 2}, {495, 4, 0}, {495, 4, 1},
+  {495, 4, 2}, {496, 3, 2}, {499, 3, 1}, {501, 4, 2}, {502, 3, 0}, {502, 3, 2}, {507, 4, 0}, {507, 4, 2},
+  {508, 3, 2}, {510, 4, 1}, {513, 4, 2}, {514, 3, 0}, {514, 3, 1}, {514, 3, 2}, {519, 4, 0}, {519, 4, 2},
+  {520, 3, 2}, {525, 4, 1}, {525, 4, 2}, {526, 3, 0}, {526, 3, 2}, {529, 3, 1}, {531, 4, 0}, {531, 4, 2},
+  {532, 3, 2}, {537, 4, 2}, {538, 3, 0}, {538, 3, 2}, {540, 4, 1}, {543, 4, 0}, {543, 4, 2}, {544, 3, 1},
+  {544, 3, 2}, {549, 4, 2}, {550, 3, 0}, {550, 3, 2}, {555, 4, 0}, {555, 4, 1}, {555, 4, 2}, {556, 3, 2},
+  {559, 3, 1}, {561, 4, 2}, {562, 3, 0}, {562, 3, 2}, {567, 4, 0}, {567, 4, 2}, {568, 3, 2}, {570, 4, 1},
+  {573, 4, 2}, {574, 3, 0}, {574, 3, 1}, {574, 3, 2}, {579, 4, 0}, {580, 3, 2}, {583, 4, 2}, {585, 4, 1},
+  {586, 3, 0}, {586, 3, 2}, {589, 3, 1}, {591, 4, 0}, {593, 4, 2}, {596, 3, 2}, {598, 3, 0}, {600, 4, 1},
+  {603, 4, 0}, {603, 4, 2}, {604, 3, 1}, {606, 3, 2}, {610, 3, 0}, {613, 4, 2}, {615, 4, 0}, {615, 4, 1},
+  {616, 3, 2}, {619, 3, 1}, {622, 3, 0}, {623, 4, 2}, {626, 3, 2}, {627, 4, 0}, {630, 4, 1}, {633, 4, 2},
+  {634, 3, 0}, {634, 3, 1}, {636, 3, 2}, {639, 4, 0}, {643, 4, 2}, {645, 4, 1}, {646, 3, 0}, {646, 3, 2},
+  {649, 3, 1}, {651, 4, 0}, {653, 4, 2}, {656, 3, 2}, {658, 3, 0}, {660, 4, 1}, {663, 4, 0}, {663, 4, 2},
+  {664, 3, 1}, {666, 3, 2}, {670, 3, 0}, {673, 4, 2}, {675, 4, 0}, {675, 4, 1}, {676, 3, 2}, {679, 3, 1},
+  {682, 3, 0}, {683, 4, 2}, {686, 3, 2}, {687, 4, 0}, {690, 4, 1}, {693, 4, 2}, {694, 3, 0}, {694, 3, 1},
+  {696, 3, 2}, {699, 4, 0}, {703, 4, 2}, {705, 4, 1}, {706, 3, 0}, {706, 3, 2}, {709, 3, 1}, {711, 4, 0},
+  {713, 4, 2}, {716, 3, 2}, {718, 3, 0}, {720, 4, 1}, {723, 4, 0}, {723, 4, 2}, {724, 3, 1}, {726, 3, 2},
+  {730, 3, 0}, {733, 4, 2}, {735, 4, 0}, {735, 4, 1}, {736, 3, 2}, {739, 3, 1}, {742, 3, 0}, {743, 4, 2},
+  {746, 3, 2}, {747, 4, 0}, {750, 4, 1}, {753, 4, 2}, {754, 3, 0}, {754, 3, 1}, {756, 3, 2}, {759, 4, 0},
+  {763, 4, 2}, {765, 4, 1}, {766, 3, 0}, {766, 3, 2}, {769, 3, 1}, {771, 4, 0}, {773, 4, 2}, {776, 3, 2},
+  {778, 3, 0}, {780, 4, 1}, {783, 4, 0}, {783, 4, 2}, {784, 3, 1}, {786, 3, 2}, {790, 3, 0}, {793, 4, 2},
+  {795, 4, 0}, {795, 4, 1}, {796, 3, 2}, {799, 3, 1}, {802, 3, 0}, {803, 4, 2}, {806, 3, 2}, {807, 4, 0},
+  {810, 4, 1}, {813, 4, 2}, {814, 3, 0}, {814, 3, 1}, {816, 3, 2}, {819, 4, 0}, {823, 4, 2}, {825, 4, 1},
+  {826, 3, 0}, {826, 3, 2}, {829, 3, 1}, {831, 4, 0}, {833, 4, 2}, {836, 3, 2}, {838, 3, 0}, {840, 4, 1},
+  {843, 4, 0}, {843, 4, 2}, {844, 3, 1}, {846, 3, 2}, {850, 3, 0}, {853, 4, 2}, {855, 4, 0}, {855, 4, 1},
+  {856, 3, 2}, {859, 3, 1}, {862, 3, 0}, {863, 4, 2}, {866, 3, 2}, {867, 4, 0}, {870, 4, 1}, {873, 4, 2},
+  {874, 3, 0}, {874, 3, 1}, {876, 3, 2}, {879, 4, 0}, {883, 4, 2}, {885, 4, 1}, {886, 3, 0}, {886, 3, 2},
+  {889, 3, 1}, {891, 4, 0}, {893, 4, 2}, {896, 3, 2}, {898, 3, 0}, {900, 4, 1}, {903, 4, 0}, {903, 4, 2},
+  {904, 3, 1}, {906, 3, 2}, {910, 3, 0}, {913, 4, 2}, {915, 4, 0}, {915, 4, 1}, {916, 3, 2}, {919, 3, 1},
+  {922, 3, 0}, {923, 4, 2}, {926, 3, 2}, {927, 4, 0}, {930, 4, 1}, {933, 4, 2}, {934, 3, 0}, {934, 3, 1},
+  {936, 3, 2}, {939, 4, 0}, {943, 4, 2}, {945, 4, 1}, {946, 3, 0}, {946, 3, 2}, {949, 3, 1}, {951, 4, 0},
+  {953, 4, 2}, {956, 3, 2}, {958, 3, 0}, {960, 4, 1}, {963, 4, 0}, {963, 4, 2}, {964, 3, 1}, {966, 3, 2},
+  {969, 4, 2}, {970, 3, 0}, {975, 4, 0}, {975, 4, 1}, {975, 4, 2}, {976, 3, 2}, {979, 3, 1}, {981, 4, 2},
+  {982, 3, 0}, {982, 3, 2}, {987, 4, 0}, {987, 4, 2}, {988, 3, 2}, {990, 4, 1}, {993, 4, 2}, {994, 3, 0},
+  {994, 3, 1}, {994, 3, 2}, {999, 4, 0}, {999, 4, 2}, {1000, 3, 2}, {1005, 4, 1}, {1005, 4, 2}, {1006, 3, 0},
+  {1006, 3, 2}, {1009, 3, 1}, {1011, 4, 0}, {1011, 4, 2}, {1012, 3, 2}, {1017, 4, 2}, {1018, 3, 0}, {1018, 3, 2},
+  {1020, 4, 1}, {1023, 4, 0}, {1023, 4, 2}, {1024, 3, 1}, {1024, 3, 2}, {1029, 4, 2}, {1030, 3, 0}, {1030, 3, 2},
+  {1035, 4, 0}, {1035, 4, 1}, {1035, 4, 2}, {1036, 3, 2}, {1039, 3, 1}, {1041, 4, 2}, {1042, 3, 0}, {1042, 3, 2},
+  {1047, 4, 0}, {1047, 4, 2}, {1048, 3, 2}, {1050, 4, 1}, {1053, 4, 2}, {1054, 3, 0}, {1054, 3, 1}, {1054, 3, 2},
+  {1059, 4, 0}, {1059, 4, 2}, {1060, 3, 2}, {1065, 4, 1}, {1065, 4, 2}, {1066, 3, 0}, {1066, 3, 2}, {1069, 3, 1},
+  {1071, 4, 0}, {1071, 4, 2}, {1072, 3, 2}, {1077, 4, 2}, {1078, 3, 0}, {1078, 3, 2}, {1080, 4, 1}, {1083, 4, 0},
+  {1083, 4, 2}, {1084, 3, 1}, {1084, 3, 2}, {1089, 4, 2}, {1090, 3, 0}, {1090, 3, 2}, {1095, 4, 0}, {1095, 4, 1},
+  {1095, 4, 2}, {1096, 3, 2}, {1099, 3, 1}, {1101, 4, 2}, {1102, 3, 0}, {1102, 3, 2}, {1107, 4, 0}, {1107, 4, 2},
+  {1108, 3, 2}, {1110, 4, 1}, {1113, 4, 2}, {1114, 3, 0}, {1114, 3, 1}, {1114, 3, 2}, {1119, 4, 0}, {1119, 4, 2},
+  {1120, 3, 2}, {1125, 4, 1}, {1125, 4, 2}, {1126, 3, 0}, {1126, 3, 2}, {1129, 3, 1}, {1131, 4, 0}, {1131, 4, 2},
+  {1132, 3, 2}, {1137, 4, 2}, {1138, 3, 0}, {1138, 3, 2}, {1140, 4, 1}, {1143, 4, 0}, {1143, 4, 2}, {1144, 3, 1},
+  {1144, 3, 2}, {1150, 3, 0}, {1150, 3, 2}, {1155, 4, 0}, {1155, 4, 1}, {1155, 4, 2}, {1156, 3, 2}, {1159, 3, 1},
+  {1162, 3, 0}, {1167, 4, 0}, {1167, 4, 2}, {1168, 3, 2}, {1170, 4, 1}, {1174, 3, 0}, {1174, 3, 1}, {1179, 4, 0},
+  {1179, 4, 2}, {1180, 3, 2}, {1185, 4, 1}, {1186, 3, 0}, {1189, 3, 1}, {1191, 4, 0}, {1191, 4, 2}, {1192, 3, 2},
+  {1198, 3, 0}, {1200, 4, 1}, {1203, 4, 0}, {1203, 4, 2}, {1204, 3, 1}, {1204, 3, 2}, {1210, 3, 0}, {1215, 4, 0},
+  {1215, 4, 1}, {1215, 4, 2}, {1216, 3, 2}, {1219, 3, 1}, {1222, 3, 0}, {1227, 4, 0}, {1227, 4, 2}, {1228, 3, 2},
+  {1230, 4, 1}, {1234, 3, 0}, {1234, 3, 1}, {1239, 4, 0}, {1239, 4, 2}, {1240, 3, 2}, {1245, 4, 1}, {1246, 3, 0},
+  {1249, 3, 1}, {1251, 4, 0}, {1251, 4, 2}, {1252, 3, 2}, {1258, 3, 0}, {1260, 4, 1}, {1263, 4, 0}, {1263, 4, 2},
+  {1264, 3, 1}, {1264, 3, 2}, {1270, 3, 0}, {1275, 4, 0}, {1275, 4, 1}, {1275, 4, 2}, {1276, 3, 2}, {1279, 3, 1},
+  {1282, 3, 0}, {1287, 4, 0}, {1287, 4, 2}, {1288, 3, 2}, {1290, 4, 1}, {1294, 3, 0}, {1294, 3, 1}, {1299, 4, 0},
+  {1299, 4, 2}, {1300, 3, 2}, {1305, 4, 1}, {1306, 3, 0}, {1309, 3, 1}, {1311, 4, 0}, {1311, 4, 2}, {1312, 3, 2},
+  {1318, 3, 0}, {1320, 4, 1}, {1323, 4, 0}, {1323, 4, 2}, {1324, 3, 1}, {1324, 3, 2}, {1330, 3, 0}, {1335, 4, 0},
+  {1335, 4, 1}, {1335, 4, 2}, {1336, 3, 2}, {1339, 3, 1}, {1342, 3, 0}, {1347, 4, 0}, {1347, 4, 2}, {1348, 3, 2},
+  {1350, 4, 1}, {1354, 3, 0}, {1354, 3, 1}, {1359, 4, 0}, {1359, 4, 2}, {1360, 3, 2}, {1365, 4, 1}, {1366, 3, 0},
+  {1369, 3, 1}, {1371, 4, 0}, {1371, 4, 2}, {1372, 3, 2}, {1378, 3, 0}, {1380, 4, 1}, {1383, 4, 0}, {1383, 4, 2},
+  {1384, 3, 1}, {1384, 3, 2}, {1390, 3, 0}, {1395, 4, 0}, {1395, 4, 1}, {1395, 4, 2}, {1396, 3, 2}, {1399, 3, 1},
+  {1402, 3, 0}, {1407, 4, 0}, {1407, 4, 2}, {1408, 3, 2}, {1410, 4, 1}, {1414, 3, 0}, {1414, 3, 1}, {1419, 4, 0},
+  {1419, 4, 2}, {1420, 3, 2}, {1425, 4, 1}, {1426, 3, 0}, {1429, 3, 1}, {1431, 4, 0}, {1431, 4, 2}, {1432, 3, 2},
+  {1438, 3, 0}, {1440, 4, 1}, {1443, 4, 0}, {1443, 4, 2}, {1444, 3, 1}, {1444, 3, 2}, {1450, 3, 0}, {1455, 4, 0},
+  {1455, 4, 1}, {1455, 4, 2}, {1456, 3, 2}, {1459, 3, 1}, {1462, 3, 0}, {1467, 4, 0}, {1467, 4, 2}, {1468, 3, 2},
+  {1470, 4, 1}, {1474, 3, 0}, {1474, 3, 1}, {1479, 4, 0}, {1479, 4, 2},
+  {0, 0, 0}
+};
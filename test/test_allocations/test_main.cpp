@@ -0,0 +1,94 @@
+/** The refresh of the passing times makes no allocation once the connection is open: the responses are
+ *  preallocated and refilled in place. Allocations are counted on the simulated heap.
+ *    pio test -e native -f test_allocations
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <FirmwareHarness.h>
+
+void setUp(){
+  TEST_ASSERT_TRUE(bootFirmware());
+  // The first fetch opens the kept alive connection and its TLS buffers
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  // LittleFS allocates its file buffers when the snapshot is written (on the device too), checked apart
+  snapshotTask.disable();
+}
+
+void tearDown(){
+}
+
+/** The screen stays open with the user around: no light sleep, which closes the connection */
+static void watchScreen(unsigned long minutes){
+  for(unsigned long i = 0; i < minutes; i++){
+    powerManager.notifyActivity();
+    runFor(60 * 1000UL);
+  }
+}
+
+void test_response_store_is_not_on_the_heap(){
+  for(int i = 0; i < NUMBER_OF_FAVOURITES + 1; i++){
+    TEST_ASSERT_FALSE(nativeHeap().contains(&passingTimeState.passingTimeResponses[i]));
+  }
+  TEST_ASSERT_EQUAL(api.passingTimesPerPoint, passingTimeState.passingTimeResponses[0].numberOfResponses);
+}
+
+void test_clear_is_constant_time_and_keeps_the_store(){
+  PassingTimeResponse* response = &passingTimeState.passingTimeResponses[0];
+  PassingTime* first = &response->passingTimes[0];
+  response->clear();
+  TEST_ASSERT_EQUAL(0, response->numberOfResponses);
+  TEST_ASSERT_EQUAL_PTR(first, &response->passingTimes[0]);
+}
+
+void test_refreshes_make_no_allocation(){
+  static const int REFRESHES = 50;
+  nativeHeap().resetCounters();
+  size_t liveBefore = nativeHeap().getLiveBytes();
+  for(int i = 0; i < REFRESHES; i++){
+    // The payload changes from one refresh to the next
+    api.passingTimesPerPoint = 1 + i % MAX_PASSING_TIMES;
+    TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+    TEST_ASSERT_EQUAL(1 + i % MAX_PASSING_TIMES, passingTimeState.passingTimeResponses[0].numberOfResponses);
+  }
+  printf("[allocations] %d refreshes: %lu allocations, %lu frees, %ld bytes kept\n", REFRESHES,
+    nativeHeap().getAllocations(), nativeHeap().getFrees(), (long)nativeHeap().getLiveBytes() - (long)liveBefore);
+  TEST_ASSERT_EQUAL(0, nativeHeap().getAllocations());
+  TEST_ASSERT_EQUAL(0, nativeHeap().getFrees());
+  api.passingTimesPerPoint = 4;
+}
+
+/** The passing time screen open for 10 minutes: refreshes, countdown and rendering */
+void test_passing_time_screen_makes_no_allocation(){
+  openFavourite(0);
+  TEST_ASSERT_TRUE(runUntil([](){ return passingTimeState.lastUpdate != 0; }, 10000));
+  nativeHeap().resetCounters();
+  unsigned long requests = api.passingTimeRequests;
+  watchScreen(10);
+  printf("[allocations] passing time screen, %lu refreshes in 10 minutes: %lu allocations\n",
+    api.passingTimeRequests - requests, nativeHeap().getAllocations());
+  TEST_ASSERT_TRUE(api.passingTimeRequests - requests >= 2);
+  TEST_ASSERT_EQUAL(0, nativeHeap().getAllocations());
+  backToFavourites();
+}
+
+/** The snapshots written meanwhile free what they allocate */
+void test_snapshots_free_their_allocations(){
+  snapshotTask.every(SNAPSHOT_INTERVAL_SEC * 1000UL);
+  nativeHeap().resetCounters();
+  size_t liveBefore = nativeHeap().getLiveBytes();
+  watchScreen(2 * SNAPSHOT_INTERVAL_SEC / 60);
+  printf("[allocations] snapshots: %lu allocations, %lu frees\n", nativeHeap().getAllocations(), nativeHeap().getFrees());
+  TEST_ASSERT_TRUE(nativeHeap().getAllocations() > 0);
+  TEST_ASSERT_EQUAL(nativeHeap().getAllocations(), nativeHeap().getFrees());
+  TEST_ASSERT_EQUAL(liveBefore, nativeHeap().getLiveBytes());
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_response_store_is_not_on_the_heap);
+  RUN_TEST(test_clear_is_constant_time_and_keeps_the_store);
+  RUN_TEST(test_refreshes_make_no_allocation);
+  RUN_TEST(test_passing_time_screen_makes_no_allocation);
+  RUN_TEST(test_snapshots_free_their_allocations);
+  return UNITY_END();
+}
@@ -0,0 +1,121 @@
+/** Benchmarks of the hot paths of a refresh on recorded payloads: parsing, sorting, formatting and rendering.
+ *  Each one prints its ns/op (host time, to compare two versions) and allocs/op (simulated heap, as on the device).
+ *  The steady state of a refresh must not allocate: the tests fail when it does.
+ *    pio test -e native -f test_bench
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <NativeBench.h>
+#include <Payloads.h>
+
+static const char* const STOP_IDS[] = {"5311", "1715", "8211", "5267", "8212"};
+
+PassingTimeResponse responses[PAYLOAD_FAVOURITES_POINTS];
+PassingTimeCollector collector;
+PassingTimeParser parser(&collector);
+
+/** Feed the payload like the HTTP client does, byte by byte */
+static bool parsePayload(const char* payload, const char* const* stopIds, int numberOfStops){
+  collector.begin(stopIds, numberOfStops, responses);
+  parser.reset();
+  for(const char* p = payload; *p != '\0'; p++){
+    if(!parser.feed(*p)){
+      return false;
+    }
+  }
+  return parser.isDone();
+}
+
+void setUp(){
+  timeService.anchor(PAYLOAD_RECORDED_AT, 3600, millis());
+  TEST_ASSERT_TRUE(parsePayload(PAYLOAD_FAVOURITES, STOP_IDS, PAYLOAD_FAVOURITES_POINTS));
+}
+
+void tearDown(){
+}
+
+void test_payloads_are_parsed(){
+  int passingTimes = 0;
+  for(int i = 0; i < PAYLOAD_FAVOURITES_POINTS; i++){
+    passingTimes += responses[i].numberOfResponses;
+  }
+  TEST_ASSERT_EQUAL(PAYLOAD_FAVOURITES_PASSING_TIMES, passingTimes);
+  TEST_ASSERT_TRUE(parsePayload(PAYLOAD_ONE_POINT, &STOP_IDS[3], 1));
+  TEST_ASSERT_EQUAL(PAYLOAD_ONE_POINT_PASSING_TIMES, responses[0].numberOfResponses);
+}
+
+void test_bench_parse_favourites(){
+  NativeBenchResult result = nativeBench("parse favourites", [](){
+    parsePayload(PAYLOAD_FAVOURITES, STOP_IDS, PAYLOAD_FAVOURITES_POINTS);
+  });
+  printf("[bench] %-28s %10.1f ns/byte\n", "", result.nsPerOp / (sizeof(PAYLOAD_FAVOURITES) - 1));
+  TEST_ASSERT_EQUAL(0, result.allocations);
+}
+
+void test_bench_parse_pretty_printed(){
+  NativeBenchResult result = nativeBench("parse pretty printed point", [](){
+    parsePayload(PAYLOAD_ONE_POINT, &STOP_IDS[3], 1);
+  });
+  TEST_ASSERT_EQUAL(0, result.allocations);
+}
+
+/** Insertion of the passing times of the favourites, in the order of the payload */
+void test_bench_sort(){
+  static PassingTimeResponse source[PAYLOAD_FAVOURITES_POINTS];
+  memcpy((void*)source, (void*)responses, sizeof(source));
+  static PassingTimeResponse sorted;
+  NativeBenchResult result = nativeBench("sort 18 passing times", [](){
+    sorted.clear();
+    // Latest first: the worst case of the insertion
+    for(int i = 0; i < PAYLOAD_FAVOURITES_POINTS; i++){
+      for(int j = source[i].numberOfResponses - 1; j >= 0; j--){
+        PassingTime* passingTime = &source[i].passingTimes[j];
+        sorted.add(passingTime->getLine(), source[i].getDestination(j), passingTime->getExpectedEpoch(), 3600);
+      }
+    }
+  });
+  TEST_ASSERT_EQUAL(MAX_PASSING_TIMES < PAYLOAD_FAVOURITES_PASSING_TIMES ? MAX_PASSING_TIMES : PAYLOAD_FAVOURITES_PASSING_TIMES,
+    sorted.numberOfResponses);
+  for(int i = 1; i < sorted.numberOfResponses; i++){
+    TEST_ASSERT_TRUE(sorted.passingTimes[i-1].getExpectedEpoch() <= sorted.passingTimes[i].getExpectedEpoch());
+  }
+  TEST_ASSERT_EQUAL(0, result.allocations);
+}
+
+void test_bench_format_for_lcd(){
+  static char line[LCD_COLUMNS + 1];
+  NativeBenchResult result = nativeBench("formatPassingTimeForLcd", [](){
+    for(int i = 0; i < responses[0].numberOfResponses; i++){
+      formatPassingTimeForLcd(&responses[0], i, PAYLOAD_RECORDED_AT, line);
+    }
+  });
+  TEST_ASSERT_EQUAL(LCD_COLUMNS, strlen(line));
+  TEST_ASSERT_EQUAL(0, result.allocations);
+}
+
+/** A page of the passing time screen drawn and flushed to the LCD, the pages alternate so that every flush writes */
+void test_bench_render(){
+  static int page = 1;
+  static unsigned long i2cBytes = 0;
+  NativeBenchResult result = nativeBench("render page + flush", [](){
+    displayPassingTimeOnLcd(&responses[0], page);
+    lcdFrame.flush();
+    i2cBytes = lcdFrame.getLastFrameI2cBytes();
+    page = page == 1 ? 2 : 1;
+  });
+  printf("[bench] %-28s %10lu I2C bytes/frame\n", "", i2cBytes);
+  TEST_ASSERT_TRUE(i2cBytes > 0);
+  TEST_ASSERT_EQUAL(0, result.allocations);
+  TEST_ASSERT_EQUAL(0, result.leakedBytes);
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_payloads_are_parsed);
+  RUN_TEST(test_bench_parse_favourites);
+  RUN_TEST(test_bench_parse_pretty_printed);
+  RUN_TEST(test_bench_sort);
+  RUN_TEST(test_bench_format_for_lcd);
+  RUN_TEST(test_bench_render);
+  return UNITY_END();
+}
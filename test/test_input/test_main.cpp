@@ -0,0 +1,147 @@
+/** Buttons pushed on the simulated pins: the latency from the push to the LCD, the presses dropped when they
+ *  come fast, the long press and its repeats, and the buttons and the passing times after a light sleep.
+ *    pio test -e native -f test_input
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <FirmwareHarness.h>
+
+/** Fast presses, still longer than the bounce of the contacts */
+#define INPUT_FAST_HOLD_MS 40
+#define INPUT_FAST_GAP_MS 40
+
+/** Push a button without waiting for the firmware to handle it */
+static void tap(uint8_t pin, unsigned long holdMs, unsigned long gapMs){
+  nativeBoard.setPin(pin, HIGH);
+  runFor(holdMs);
+  nativeBoard.setPin(pin, LOW);
+  runFor(gapMs);
+}
+
+/** Time from the push to a change of the LCD */
+static unsigned long pushToDisplayMs(uint8_t pin){
+  char before[2][LCD_COLUMNS + 1];
+  snprintf(before[0], sizeof(before[0]), "%s", lcdRow(0));
+  snprintf(before[1], sizeof(before[1]), "%s", lcdRow(1));
+  unsigned long pushedAt = millis();
+  nativeBoard.setPin(pin, HIGH);
+  bool changed = runUntil([&before](){ return strcmp(before[0], lcdRow(0)) != 0 || strcmp(before[1], lcdRow(1)) != 0; }, 1000);
+  unsigned long latency = millis() - pushedAt;
+  nativeBoard.setPin(pin, LOW);
+  runFor(BUTTON_DEBOUNCE_MS + RENDER_INTERVAL_MS);
+  TEST_ASSERT_TRUE(changed);
+  return latency;
+}
+
+unsigned long wakeUpPushMs = 0;
+
+void setUp(){
+  TEST_ASSERT_TRUE(bootFirmware());
+  powerManager.notifyActivity();
+  backToFavourites();
+}
+
+void tearDown(){
+  nativeBoard.setSleepHandler(NULL);
+}
+
+void test_push_to_display_latency(){
+  unsigned long worst = 0;
+  for(int i = 0; i < FAVOURITE_MENU_SIZE - 1; i++){
+    unsigned long latency = pushToDisplayMs(DOWN_BUTTON);
+    worst = latency > worst ? latency : worst;
+  }
+  for(int i = 0; i < FAVOURITE_MENU_SIZE - 1; i++){
+    unsigned long latency = pushToDisplayMs(UP_BUTTON);
+    worst = latency > worst ? latency : worst;
+  }
+  printf("[input] worst push to display: %lu ms\n", worst);
+  TEST_ASSERT_EQUAL(0, appState.position);
+  TEST_ASSERT_TRUE(worst <= BUTTON_DEBOUNCE_MS + RENDER_INTERVAL_MS);
+}
+
+void test_fast_presses_are_not_dropped(){
+  int presses = 0;
+  for(int i = 0; i < FAVOURITE_MENU_SIZE - 1; i++){
+    tap(DOWN_BUTTON, INPUT_FAST_HOLD_MS, INPUT_FAST_GAP_MS);
+    presses++;
+  }
+  runFor(RENDER_INTERVAL_MS);
+  int dropped = presses - (int)appState.position;
+  printf("[input] %d presses of %d ms every %d ms: %d dropped\n", presses, INPUT_FAST_HOLD_MS,
+    INPUT_FAST_HOLD_MS + INPUT_FAST_GAP_MS, dropped);
+  TEST_ASSERT_EQUAL(0, dropped);
+  for(int i = 0; i < FAVOURITE_MENU_SIZE - 1; i++){
+    tap(UP_BUTTON, INPUT_FAST_HOLD_MS, INPUT_FAST_GAP_MS);
+  }
+  runFor(RENDER_INTERVAL_MS);
+  TEST_ASSERT_EQUAL(0, appState.position);
+}
+
+void test_held_button_repeats(){
+  unsigned long heldMs = BUTTON_LONG_PRESS_MS + 2 * BUTTON_REPEAT_MS + BUTTON_REPEAT_MS / 2;
+  tap(DOWN_BUTTON, heldMs, BUTTON_DEBOUNCE_MS + RENDER_INTERVAL_MS);
+  printf("[input] down held %lu ms: %u positions\n", heldMs, appState.position);
+  // The push, then a repeat at the long press and every BUTTON_REPEAT_MS
+  TEST_ASSERT_EQUAL(1 + 1 + 2, appState.position);
+  backToFavourites();
+}
+
+/** After a light sleep the pins must be back to the edge interrupts of the buttons */
+void test_buttons_after_light_sleep(){
+  nativeBoard.setSleepHandler([](){
+    nativeBoard.setPin(SELECT_BUTTON, HIGH);
+    return 30000UL;
+  });
+  unsigned long sleeps = nativeBoard.getSleeps();
+  TEST_ASSERT_TRUE(runUntil([sleeps](){ return nativeBoard.getSleeps() > sleeps; }, (POWER_IDLE_SEC + 10) * 1000UL));
+  // The push which woke the device up
+  runFor(INPUT_FAST_HOLD_MS);
+  nativeBoard.setPin(SELECT_BUTTON, LOW);
+  runFor(BUTTON_DEBOUNCE_MS + RENDER_INTERVAL_MS);
+  TEST_ASSERT_EQUAL(NATIVE_INTERRUPT_EDGE, nativeBoard.getInterruptType(DOWN_BUTTON));
+  TEST_ASSERT_EQUAL(NATIVE_INTERRUPT_EDGE, nativeBoard.getInterruptType(SELECT_BUTTON));
+  unsigned int position = appState.position;
+  unsigned long interrupts = nativeBoard.getInterruptCalls();
+  pushButton(DOWN_BUTTON, 500);
+  printf("[input] after the sleep, down held 500 ms: %lu interrupts\n", nativeBoard.getInterruptCalls() - interrupts);
+  TEST_ASSERT_EQUAL(position + 1, appState.position);
+  // The press and the release, with their bounces at most
+  TEST_ASSERT_TRUE(nativeBoard.getInterruptCalls() - interrupts <= 4);
+}
+
+/** The passing times received before a light sleep are displayed as stale at once, less the passed ones, then refreshed */
+void test_passing_times_kept_after_light_sleep(){
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  openFavourite(0);
+  TEST_ASSERT_TRUE(runUntil([](){ return passingTimeState.lastUpdate != 0; }, 10000));
+  int before = passingTimeState.selectedResponse()->numberOfResponses;
+  nativeBoard.setSleepHandler([](){
+    nativeBoard.setPin(SELECT_BUTTON, HIGH);
+    return (unsigned long)api.intervalSec * 1000UL + 30000UL;
+  });
+  unsigned long sleeps = nativeBoard.getSleeps();
+  TEST_ASSERT_TRUE(runUntil([sleeps](){ return nativeBoard.getSleeps() > sleeps; }, (POWER_IDLE_SEC + 10) * 1000UL));
+  nativeBoard.setSleepHandler(NULL);
+  runFor(INPUT_FAST_HOLD_MS);
+  nativeBoard.setPin(SELECT_BUTTON, LOW);
+  runFor(BUTTON_DEBOUNCE_MS + RENDER_INTERVAL_MS);
+  printf("[input] after the sleep: %d of %d passing times kept, row 0 \"%s\"\n",
+    passingTimeState.selectedResponse()->numberOfResponses, before, lcdRow(0));
+  TEST_ASSERT_TRUE(passingTimeState.selectedResponse()->numberOfResponses > 0);
+  TEST_ASSERT_TRUE(passingTimeState.selectedResponse()->numberOfResponses < before);
+  TEST_ASSERT_TRUE(strstr(lcdRow(0), "Loading") == NULL);
+  TEST_ASSERT_TRUE(strchr(lcdRow(0), '*') != NULL);
+  TEST_ASSERT_TRUE(runUntil([](){ return passingTimeState.selectedResponse()->source == SOURCE_API; }, 30000));
+  backToFavourites();
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_push_to_display_latency);
+  RUN_TEST(test_fast_presses_are_not_dropped);
+  RUN_TEST(test_held_button_repeats);
+  RUN_TEST(test_buttons_after_light_sleep);
+  RUN_TEST(test_passing_times_kept_after_light_sleep);
+  return UNITY_END();
+}
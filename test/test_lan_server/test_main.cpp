@@ -0,0 +1,155 @@
+/** Hub mode: the firmware built with ENABLE_LAN_SERVER serves its cached passing times to displays simulated by
+ *  local clients. The answer parsed like the API gives back the cache, and the upstream requests stay the same
+ *  whatever the number of displays.
+ *    pio test -e native -f test_lan_server
+ */
+#define ENABLE_LAN_SERVER 1
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <FirmwareHarness.h>
+
+#define LAN_HUB_ADDRESS "192.168.1.50"
+#define LAN_ANSWER_LENGTH 4096
+/** Time during which the displays poll the hub */
+#define LAN_POLL_MINUTES 10
+
+char answer[LAN_ANSWER_LENGTH];
+
+/** A display asking the hub, the answer (headers and body) in answer. Return the status code or -1 */
+static int askHub(const char* path){
+  WiFiClient display;
+  answer[0] = '\0';
+  if(!display.connect(LAN_HUB_ADDRESS, LAN_SERVER_PORT)){
+    return -1;
+  }
+  display.print(F("GET "));
+  display.print(path);
+  display.print(F(" HTTP/1.1\r\nHost: " LAN_HUB_ADDRESS "\r\n\r\n"));
+  size_t length = 0;
+  runUntil([&display, &length](){
+    while(display.available() && length < LAN_ANSWER_LENGTH - 1){
+      answer[length++] = display.read();
+    }
+    return !display.connected();
+  }, 5000);
+  answer[length] = '\0';
+  display.stop();
+  int code = -1;
+  sscanf(answer, "HTTP/1.1 %d", &code);
+  return code;
+}
+
+/** The path of the display which shows all the favourites */
+static void favouritesPath(char* path, size_t size){
+  int length = snprintf(path, size, "%s", LAN_PASSING_TIME_PATH);
+  for(int i = 0; i < NUMBER_OF_FAVOURITES; i++){
+    length += snprintf(path + length, size - length, i > 0 ? "%%2C%s" : "%s", favouriteStopIds[i]);
+  }
+}
+
+/** Parse the body of the answer like a display does with the API */
+static bool parseAnswer(PassingTimeResponse* responses){
+  const char* body = strstr(answer, "\r\n\r\n");
+  if(body == NULL){
+    return false;
+  }
+  PassingTimeCollector collector;
+  PassingTimeParser parser(&collector);
+  collector.begin(favouriteStopIds, NUMBER_OF_FAVOURITES, responses);
+  parser.reset();
+  for(const char* p = body + 4; *p != '\0'; p++){
+    parser.feed(*p);
+  }
+  return parser.isDone();
+}
+
+/** Displays polling the hub every REFRESH_RATE_SEC for LAN_POLL_MINUTES. Return the upstream requests */
+static unsigned long pollWithDisplays(int displays){
+  char path[LAN_REQUEST_LENGTH];
+  favouritesPath(path, sizeof(path));
+  unsigned long upstream = api.passingTimeRequests;
+  unsigned long served = lanServer.getServed();
+  unsigned long endMs = millis() + LAN_POLL_MINUTES * 60 * 1000UL;
+  while((long)(endMs - millis()) > 0){
+    for(int i = 0; i < displays; i++){
+      TEST_ASSERT_EQUAL(200, askHub(path));
+    }
+    runFor(REFRESH_RATE_SEC * 1000UL);
+  }
+  upstream = api.passingTimeRequests - upstream;
+  served = lanServer.getServed() - served;
+  printf("[lan] %2d displays: %5lu answers/hour from the hub, %3lu requests/hour upstream\n", displays,
+    served * 60 / LAN_POLL_MINUTES, upstream * 60 / LAN_POLL_MINUTES);
+  return upstream;
+}
+
+void setUp(){
+  TEST_ASSERT_TRUE(bootFirmware());
+  TEST_ASSERT_TRUE(runUntil([](){ return passingTimeState.passingTimeResponses[0].isReceived(); }, 2 * LAN_HUB_REFRESH_SEC * 1000UL));
+}
+
+void tearDown(){
+}
+
+void test_serves_the_cached_passing_times(){
+  char path[LAN_REQUEST_LENGTH];
+  favouritesPath(path, sizeof(path));
+  TEST_ASSERT_EQUAL(200, askHub(path));
+  static PassingTimeResponse roundTrip[NUMBER_OF_FAVOURITES];
+  TEST_ASSERT_TRUE(parseAnswer(roundTrip));
+  TEST_ASSERT_TRUE(passingTimeState.passingTimeResponses[0].numberOfResponses > 0);
+  for(int i = 0; i < NUMBER_OF_FAVOURITES; i++){
+    PassingTimeResponse* cached = &passingTimeState.passingTimeResponses[i];
+    TEST_ASSERT_EQUAL(cached->numberOfResponses, roundTrip[i].numberOfResponses);
+    for(int j = 0; j < cached->numberOfResponses; j++){
+      TEST_ASSERT_EQUAL_STRING(cached->passingTimes[j].getLine(), roundTrip[i].passingTimes[j].getLine());
+      TEST_ASSERT_EQUAL_STRING(cached->getDestination(j), roundTrip[i].getDestination(j));
+      TEST_ASSERT_EQUAL(cached->passingTimes[j].getExpectedEpoch(), roundTrip[i].passingTimes[j].getExpectedEpoch());
+    }
+  }
+}
+
+void test_unknown_requests(){
+  TEST_ASSERT_EQUAL(404, askHub("/favicon.ico"));
+  TEST_ASSERT_EQUAL(404, askHub(LAN_PASSING_TIME_PATH));
+  // A stop which isn't cached is absent, like a stop unknown to the API
+  TEST_ASSERT_EQUAL(200, askHub(LAN_PASSING_TIME_PATH "0000"));
+  TEST_ASSERT_TRUE(strstr(answer, "{\"points\":[]}") != NULL);
+}
+
+void test_serving_does_not_allocate(){
+  char path[LAN_REQUEST_LENGTH];
+  favouritesPath(path, sizeof(path));
+  // The displays of the test allocate their sockets: only the hub is counted, between the request and the answer
+  WiFiClient display;
+  TEST_ASSERT_TRUE(display.connect(LAN_HUB_ADDRESS, LAN_SERVER_PORT));
+  display.print(F("GET "));
+  display.print(path);
+  display.print(F(" HTTP/1.1\r\n\r\n"));
+  unsigned long served = lanServer.getServed();
+  nativeHeap().resetCounters();
+  runUntil([served](){ return lanServer.getServed() > served; }, 5000);
+  TEST_ASSERT_EQUAL(served + 1, lanServer.getServed());
+  TEST_ASSERT_EQUAL(0, nativeHeap().getAllocations());
+  display.stop();
+}
+
+void test_upstream_requests_dont_grow_with_the_displays(){
+  unsigned long alone = pollWithDisplays(1);
+  unsigned long several = pollWithDisplays(8);
+  unsigned long many = pollWithDisplays(32);
+  // One refresh of the favourites every LAN_HUB_REFRESH_SEC, one more if it falls on the edge of the period
+  unsigned long refreshes = LAN_POLL_MINUTES * 60 / LAN_HUB_REFRESH_SEC;
+  TEST_ASSERT_TRUE(alone <= refreshes + 1);
+  TEST_ASSERT_TRUE(several <= alone + 1 && several + 1 >= alone);
+  TEST_ASSERT_TRUE(many <= alone + 1 && many + 1 >= alone);
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_serves_the_cached_passing_times);
+  RUN_TEST(test_unknown_requests);
+  RUN_TEST(test_serving_does_not_allocate);
+  RUN_TEST(test_upstream_requests_dont_grow_with_the_displays);
+  return UNITY_END();
+}
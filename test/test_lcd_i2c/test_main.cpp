@@ -0,0 +1,75 @@
+/** I2C traffic to the LCD, counted by the mock of LiquidCrystal_I2C: the former full redraw (clear() and the
+ *  32 cells) against the frame buffer, which only sends the cells that changed.
+ *    pio test -e native -f test_lcd_i2c
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <FirmwareHarness.h>
+
+/** The former rendering of the passing time screen */
+static void fullRedraw(const char* line1, const char* line2){
+  lcd.clear();
+  lcd.setCursor(0, 0);
+  lcd.print(line1);
+  lcd.setCursor(0, 1);
+  lcd.print(line2);
+}
+
+void setUp(){
+  TEST_ASSERT_TRUE(bootFirmware());
+}
+
+void tearDown(){
+}
+
+void test_full_redraw_matches_the_estimate(){
+  lcd.resetCounters();
+  fullRedraw("71 DE BROUCKE  3", "95 WIENER      7");
+  printf("[lcd] full redraw: %lu I2C bytes\n", lcd.getI2cBytes());
+  TEST_ASSERT_EQUAL(LcdFrameBuffer::getFullRedrawI2cBytes(), lcd.getI2cBytes());
+  TEST_ASSERT_EQUAL(1, lcd.getClears());
+}
+
+void test_frame_sends_only_the_changed_cells(){
+  lcdFrame.printLine(0, "71 DE BROUCKE  3");
+  lcdFrame.printLine(1, "95 WIENER      7");
+  lcdFrame.flush();
+  // The countdown: one digit changes
+  lcdFrame.printLine(0, "71 DE BROUCKE  2");
+  lcd.resetCounters();
+  lcdFrame.flush();
+  printf("[lcd] one cell changed: %lu I2C bytes, %lu with a full redraw\n", lcd.getI2cBytes(), LcdFrameBuffer::getFullRedrawI2cBytes());
+  TEST_ASSERT_EQUAL(lcdFrame.getLastFrameI2cBytes(), lcd.getI2cBytes());
+  TEST_ASSERT_EQUAL(2 * I2C_BYTES_PER_LCD_BYTE, lcd.getI2cBytes());
+  TEST_ASSERT_EQUAL_STRING("71 DE BROUCKE  2", lcdRow(0));
+  TEST_ASSERT_EQUAL(0, lcd.getClears());
+  // Nothing changed: nothing sent
+  lcd.resetCounters();
+  lcdFrame.flush();
+  TEST_ASSERT_EQUAL(0, lcd.getI2cBytes());
+}
+
+/** The passing time screen open for a minute: the countdown, and the refreshes */
+void test_passing_time_screen_traffic(){
+  openFavourite(0);
+  TEST_ASSERT_TRUE(runUntil([](){ return passingTimeState.lastUpdate != 0; }, 10000));
+  lcd.resetCounters();
+  unsigned long startMs = millis();
+  powerManager.notifyActivity();
+  runFor(60 * 1000UL);
+  unsigned long seconds = (millis() - startMs) / 1000;
+  unsigned long fullRedraws = seconds * LcdFrameBuffer::getFullRedrawI2cBytes();
+  printf("[lcd] passing time screen, %lu s: %lu I2C bytes, %lu with a full redraw every second (%lu ms of bus)\n",
+    seconds, lcd.getI2cBytes(), fullRedraws, lcd.getI2cBytes() * NATIVE_I2C_BYTE_US / 1000);
+  TEST_ASSERT_EQUAL(0, lcd.getClears());
+  TEST_ASSERT_TRUE(lcd.getI2cBytes() * 10 < fullRedraws);
+  backToFavourites();
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_full_redraw_matches_the_estimate);
+  RUN_TEST(test_frame_sends_only_the_changed_cells);
+  RUN_TEST(test_passing_time_screen_traffic);
+  return UNITY_END();
+}
@@ -0,0 +1,156 @@
+/** The rows of the LCD formatted into fixed buffers, against the former String pipeline: the same rows, the columns
+ *  kept for the short destinations, and the cost of a frame of the passing time and of the favourites screens.
+ *  The former code is kept here to compare: formatPassingTimeForLcd() returned a String built from about six
+ *  temporary ones, and the favourites held their label in a String copied on each redraw.
+ *    pio test -e native -f test_line_format
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <NativeBench.h>
+#include <Payloads.h>
+
+static const char* const STOP_IDS[] = {"5311", "1715", "8211", "5267", "8212"};
+
+/** The former row of a passing time */
+static String formatLegacyPassingTime(PassingTimeResponse* passingTimeResponse, int index, uint32_t nowEpoch){
+  PassingTime* passingTime = &passingTimeResponse->passingTimes[index];
+  long remainingTime = passingTime->getRemainingTime(nowEpoch);
+  String remainingTimeStr = String(remainingTime);
+  if(remainingTime == 0){
+    remainingTimeStr = String(DOWN_ARROW_CHAR) + DOWN_ARROW_CHAR;
+  }else if(remainingTime < 10){
+    remainingTimeStr = " " + remainingTimeStr;
+  }else if(remainingTime > 90){
+    remainingTimeStr = "--";
+  }
+  String marker = passingTimeResponse->source == SOURCE_SNAPSHOT ? "*" : (passingTimeResponse->source == SOURCE_TIMETABLE ? String(SCHEDULED_CHAR) : " ");
+  return (String(passingTime->getLine()) + "  ").substring(0,3) + (String(passingTimeResponse->getDestination(index)) + "       ").substring(0, 10) + marker + remainingTimeStr;
+}
+
+/** The former favourite, and the lines of the former AppState */
+struct LegacyFavourite {
+  String stopId;
+  String label;
+};
+LegacyFavourite legacyFavourites[NUMBER_OF_FAVOURITES];
+String legacyLine1;
+String legacyLine2;
+
+/** The former label of the menu, returned by value */
+static String getLegacyFavouriteMenuLabel(unsigned int position){
+  return legacyFavourites[position].label;
+}
+
+PassingTimeResponse responses[PAYLOAD_FAVOURITES_POINTS];
+char line1[LCD_LINE_LENGTH + 1];
+char line2[LCD_LINE_LENGTH + 1];
+
+void setUp(){
+  PassingTimeCollector collector;
+  PassingTimeParser parser(&collector);
+  collector.begin(STOP_IDS, PAYLOAD_FAVOURITES_POINTS, responses);
+  parser.reset();
+  for(const char* p = PAYLOAD_FAVOURITES; *p != '\0'; p++){
+    parser.feed(*p);
+  }
+  TEST_ASSERT_TRUE(parser.isDone());
+}
+
+void tearDown(){
+}
+
+void test_same_rows_as_before(){
+  static const long OFFSETS_SEC[] = {-120, 0, 59, 106, 9 * 60, 10 * 60, 90 * 60, 91 * 60};
+  static const PassingTimeSource SOURCES[] = {SOURCE_API, SOURCE_SNAPSHOT, SOURCE_TIMETABLE};
+  int compared = 0;
+  for(int r = 0; r < PAYLOAD_FAVOURITES_POINTS; r++){
+    for(size_t s = 0; s < sizeof(SOURCES) / sizeof(SOURCES[0]); s++){
+      responses[r].source = SOURCES[s];
+      for(int i = 0; i < responses[r].numberOfResponses; i++){
+        uint32_t expected = responses[r].passingTimes[i].getExpectedEpoch();
+        for(size_t o = 0; o < sizeof(OFFSETS_SEC) / sizeof(OFFSETS_SEC[0]); o++){
+          uint32_t now = expected - OFFSETS_SEC[o];
+          formatPassingTimeForLcd(&responses[r], i, now, line1);
+          String legacy = formatLegacyPassingTime(&responses[r], i, now);
+          TEST_ASSERT_EQUAL_STRING(legacy.c_str(), line1);
+          compared++;
+        }
+      }
+      responses[r].source = SOURCE_API;
+    }
+  }
+  printf("[line format] %d rows identical to the former ones\n", compared);
+  TEST_ASSERT_TRUE(compared > 0);
+}
+
+/** The former padding of 7 spaces was short for the destinations of less than 3 characters */
+void test_short_destination_keeps_the_columns(){
+  PassingTimeResponse response;
+  response.add("7", "UZ", PAYLOAD_RECORDED_AT + 5 * 60, 3600);
+  formatPassingTimeForLcd(&response, 0, PAYLOAD_RECORDED_AT, line1);
+  TEST_ASSERT_EQUAL_STRING("7  UZ          5", line1);
+  String legacy = formatLegacyPassingTime(&response, 0, PAYLOAD_RECORDED_AT);
+  printf("[line format] short destination, before: \"%s\" after: \"%s\"\n", legacy.c_str(), line1);
+  TEST_ASSERT_TRUE(legacy.length() < LCD_LINE_LENGTH);
+}
+
+/** The two rows of a page, every page in turn, like displayPassingTimeOnLcd() */
+void test_bench_passing_time_frame(){
+  static int next = 0;
+  NativeBenchResult before = nativeBench("before: 2 rows with Strings", [](){
+    PassingTimeResponse* response = &responses[next % PAYLOAD_FAVOURITES_POINTS];
+    legacyLine1 = formatLegacyPassingTime(response, 0, PAYLOAD_RECORDED_AT);
+    legacyLine2 = formatLegacyPassingTime(response, 1, PAYLOAD_RECORDED_AT);
+    next++;
+  });
+  NativeBenchResult after = nativeBench("after: 2 rows in buffers", [](){
+    PassingTimeResponse* response = &responses[next % PAYLOAD_FAVOURITES_POINTS];
+    formatPassingTimeForLcd(response, 0, PAYLOAD_RECORDED_AT, line1);
+    formatPassingTimeForLcd(response, 1, PAYLOAD_RECORDED_AT, line2);
+    next++;
+  });
+  printf("[line format] passing time frame: %.1fx faster, %.1f allocations/frame before, %.1f after\n",
+    before.nsPerOp / after.nsPerOp, before.allocationsPerOp, after.allocationsPerOp);
+  TEST_ASSERT_TRUE(before.allocations > 0);
+  TEST_ASSERT_EQUAL(0, after.allocations);
+  TEST_ASSERT_TRUE(after.nsPerOp < before.nsPerOp);
+}
+
+/** The two labels of the favourites screen. Before, the labels longer than the small String optimisation of the
+ *  core were allocated on each copy, and every label took RAM.
+ */
+void test_bench_favourites_frame(){
+  static unsigned int position = 0;
+  size_t liveBefore = nativeHeap().getLiveBytes();
+  char label[LCD_LINE_LENGTH + 1];
+  for(int i = 0; i < NUMBER_OF_FAVOURITES; i++){
+    copyLine_P(label, favourites[i].label);
+    legacyFavourites[i].stopId = favourites[i].stopId;
+    legacyFavourites[i].label = label;
+  }
+  size_t legacyRam = sizeof(legacyFavourites) + nativeHeap().getLiveBytes() - liveBefore;
+  NativeBenchResult before = nativeBench("before: 2 labels with Strings", [](){
+    legacyLine1 = getLegacyFavouriteMenuLabel(position % NUMBER_OF_FAVOURITES);
+    legacyLine2 = getLegacyFavouriteMenuLabel((position + 1) % NUMBER_OF_FAVOURITES);
+    position++;
+  });
+  NativeBenchResult after = nativeBench("after: 2 labels from flash", [](){
+    copyFavouriteMenuLabel(position % NUMBER_OF_FAVOURITES, line1);
+    copyFavouriteMenuLabel((position + 1) % NUMBER_OF_FAVOURITES, line2);
+    position++;
+  });
+  printf("[line format] favourites frame: %.1f ns before, %.1f ns after; RAM of the favourites: %lu bytes before, %lu after\n",
+    before.nsPerOp, after.nsPerOp, (unsigned long)legacyRam, (unsigned long)sizeof(favourites));
+  TEST_ASSERT_TRUE(before.allocations > 0);
+  TEST_ASSERT_EQUAL(0, after.allocations);
+  TEST_ASSERT_TRUE(sizeof(favourites) < legacyRam);
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_same_rows_as_before);
+  RUN_TEST(test_short_destination_keeps_the_columns);
+  RUN_TEST(test_bench_passing_time_frame);
+  RUN_TEST(test_bench_favourites_frame);
+  return UNITY_END();
+}
@@ -0,0 +1,113 @@
+/** The passing times are fetched a slice at a time: no loop() pass waits for the network, the worst one stays
+ *  within the budget of a task, and the buttons are handled while the request is in flight.
+ *    pio test -e native -f test_loop_budget
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <FirmwareHarness.h>
+
+/** Host CPU compared to an ESP8266 at 80MHz */
+#define LOOP_ESP_SLOWDOWN 100
+/** Worst pass allowed on the host: a task budget on the device */
+#define LOOP_HOST_BUDGET_NS (TASK_BUDGET_MS * 1000000ULL / LOOP_ESP_SLOWDOWN)
+/** A preemption of the host is not the firmware: the best of the runs is kept */
+#define LOOP_RUNS 3
+
+struct LoopStats {
+  unsigned long passes;
+  uint64_t worstNs;
+  /** Simulated time spent inside a pass, waiting */
+  unsigned long worstBlockedMs;
+};
+
+int httpCode;
+
+/** A fetch of the favourites, each loop() pass measured until the callback */
+static LoopStats measureFetch(){
+  LoopStats stats = {0, 0, 0};
+  httpCode = -1;
+  powerManager.notifyActivity();
+  TEST_ASSERT_TRUE(runUntil([](){ return passingTimeFetcher.canStart(); }, 60000));
+  TEST_ASSERT_TRUE(passingTimeFetcher.startFavourites(passingTimeState.passingTimeResponses, [](int code){ httpCode = code; }));
+  while(httpCode == -1 && stats.passes < 100000){
+    unsigned long startMs = millis();
+    uint64_t start = NativeBoard::hostNanos();
+    loop();
+    uint64_t ns = NativeBoard::hostNanos() - start;
+    unsigned long blockedMs = millis() - startMs;
+    stats.worstNs = ns > stats.worstNs ? ns : stats.worstNs;
+    stats.worstBlockedMs = blockedMs > stats.worstBlockedMs ? blockedMs : stats.worstBlockedMs;
+    stats.passes++;
+    nativeBoard.onYield();
+    nativeBoard.advance(HARNESS_PASS_MS);
+  }
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, httpCode);
+  return stats;
+}
+
+void setUp(){
+  TEST_ASSERT_TRUE(bootFirmware());
+  // The connection is open, the handshake is measured apart
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+}
+
+void tearDown(){
+  api.passingTimesPerPoint = 4;
+  nativeNetwork.setSegmentSize(NATIVE_SEGMENT_SIZE);
+}
+
+void test_fetch_is_spread_over_short_passes(){
+  api.passingTimesPerPoint = MAX_PASSING_TIMES;
+  LoopStats best = {0, UINT64_MAX, 0};
+  for(int run = 0; run < LOOP_RUNS; run++){
+    LoopStats stats = measureFetch();
+    printf("[loop] fetch of %d passing times per stop: %lu passes, worst %lu ns on the host (~%lu us on the device), %lu ms waited\n",
+      MAX_PASSING_TIMES, stats.passes, (unsigned long)stats.worstNs, (unsigned long)(stats.worstNs * LOOP_ESP_SLOWDOWN / 1000),
+      stats.worstBlockedMs);
+    // Nothing waits inside a pass
+    TEST_ASSERT_EQUAL(0, stats.worstBlockedMs);
+    // More than one slice
+    TEST_ASSERT_TRUE(stats.passes > 1);
+    best = stats.worstNs < best.worstNs ? stats : best;
+  }
+  TEST_ASSERT_TRUE(best.worstNs <= LOOP_HOST_BUDGET_NS);
+}
+
+/** The worst pass doesn't grow with the size of the body, each pass reads one slice at most */
+void test_worst_pass_does_not_grow_with_the_body(){
+  api.passingTimesPerPoint = 1;
+  LoopStats small = measureFetch();
+  api.passingTimesPerPoint = MAX_PASSING_TIMES;
+  LoopStats large = measureFetch();
+  printf("[loop] 1 passing time per stop: %lu passes, %d per stop: %lu passes\n", small.passes, MAX_PASSING_TIMES, large.passes);
+  TEST_ASSERT_TRUE(large.passes > small.passes);
+  TEST_ASSERT_EQUAL(0, large.worstBlockedMs);
+  TEST_ASSERT_TRUE(small.worstNs <= LOOP_HOST_BUDGET_NS || large.worstNs <= LOOP_HOST_BUDGET_NS);
+}
+
+void test_buttons_are_handled_during_a_fetch(){
+  // Small segments: the response takes many passes
+  nativeNetwork.setSegmentSize(7);
+  api.passingTimesPerPoint = MAX_PASSING_TIMES;
+  httpCode = -1;
+  powerManager.notifyActivity();
+  TEST_ASSERT_TRUE(runUntil([](){ return passingTimeFetcher.canStart(); }, 60000));
+  TEST_ASSERT_TRUE(passingTimeFetcher.startFavourites(passingTimeState.passingTimeResponses, [](int code){ httpCode = code; }));
+  unsigned int position = appState.position;
+  pushButton(DOWN_BUTTON);
+  TEST_ASSERT_EQUAL(-1, httpCode);
+  TEST_ASSERT_EQUAL(position + 1, appState.position);
+  pushButton(UP_BUTTON);
+  TEST_ASSERT_EQUAL(-1, httpCode);
+  TEST_ASSERT_EQUAL(position, appState.position);
+  TEST_ASSERT_TRUE(runUntil([](){ return httpCode != -1; }, 60000));
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, httpCode);
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_fetch_is_spread_over_short_passes);
+  RUN_TEST(test_worst_pass_does_not_grow_with_the_body);
+  RUN_TEST(test_buttons_are_handled_during_a_fetch);
+  return UNITY_END();
+}
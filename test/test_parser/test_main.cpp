@@ -0,0 +1,158 @@
+/** The PassingTimeByPoint parser fed in chunks of any size: same passing times, constant peak heap.
+ *  Chunks of the recorded payloads first, then the whole fetch path from the stub server with chunked
+ *  bodies and TCP segments of several sizes.
+ *    pio test -e native -f test_parser
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <FirmwareHarness.h>
+#include <Payloads.h>
+
+static const char* const STOP_IDS[] = {"5311", "1715", "8211", "5267", "8212"};
+static const size_t CHUNK_SIZES[] = {1, 2, 3, 7, 16, 64, 100, 256, 333, 1460, sizeof(PAYLOAD_FAVOURITES)};
+
+PassingTimeResponse expected[PAYLOAD_FAVOURITES_POINTS];
+PassingTimeResponse responses[PAYLOAD_FAVOURITES_POINTS];
+PassingTimeCollector collector;
+PassingTimeParser parser(&collector);
+
+/** Feed the payload chunk by chunk, return the heap taken at the peak, above what was allocated before */
+static size_t parseInChunks(const char* payload, size_t chunkSize, PassingTimeResponse* into){
+  collector.begin(STOP_IDS, PAYLOAD_FAVOURITES_POINTS, into);
+  parser.reset();
+  nativeHeap().resetCounters();
+  size_t liveBefore = nativeHeap().getLiveBytes();
+  size_t length = strlen(payload);
+  for(size_t offset = 0; offset < length; offset += chunkSize){
+    // A copy of the chunk, like the slice read from the socket
+    static char chunk[sizeof(PAYLOAD_FAVOURITES)];
+    size_t size = length - offset < chunkSize ? length - offset : chunkSize;
+    memcpy(chunk, payload + offset, size);
+    for(size_t i = 0; i < size; i++){
+      TEST_ASSERT_TRUE(parser.feed(chunk[i]));
+    }
+  }
+  TEST_ASSERT_TRUE(parser.isDone());
+  TEST_ASSERT_FALSE(parser.hasFailed());
+  return nativeHeap().getPeakBytes() - liveBefore;
+}
+
+static void assertSameResponses(PassingTimeResponse* actual, PassingTimeResponse* reference){
+  for(int i = 0; i < PAYLOAD_FAVOURITES_POINTS; i++){
+    TEST_ASSERT_EQUAL(reference[i].numberOfResponses, actual[i].numberOfResponses);
+    for(int j = 0; j < reference[i].numberOfResponses; j++){
+      TEST_ASSERT_EQUAL_STRING(reference[i].passingTimes[j].getLine(), actual[i].passingTimes[j].getLine());
+      TEST_ASSERT_EQUAL_STRING(reference[i].getDestination(j), actual[i].getDestination(j));
+      TEST_ASSERT_EQUAL(reference[i].passingTimes[j].getExpectedEpoch(), actual[i].passingTimes[j].getExpectedEpoch());
+    }
+  }
+}
+
+void setUp(){
+}
+
+void tearDown(){
+}
+
+void test_whole_payload(){
+  parseInChunks(PAYLOAD_FAVOURITES, sizeof(PAYLOAD_FAVOURITES), expected);
+  int passingTimes = 0;
+  for(int i = 0; i < PAYLOAD_FAVOURITES_POINTS; i++){
+    passingTimes += expected[i].numberOfResponses;
+  }
+  TEST_ASSERT_EQUAL(PAYLOAD_FAVOURITES_PASSING_TIMES, passingTimes);
+  // Sorted, with the destinations in French
+  TEST_ASSERT_EQUAL_STRING("HEYSEL", expected[0].getDestination(0));
+  TEST_ASSERT_EQUAL_STRING("7", expected[0].passingTimes[0].getLine());
+}
+
+void test_pretty_printed_payload(){
+  collector.begin(&STOP_IDS[3], 1, responses);
+  parser.reset();
+  for(const char* p = PAYLOAD_ONE_POINT; *p != '\0'; p++){
+    TEST_ASSERT_TRUE(parser.feed(*p));
+  }
+  TEST_ASSERT_TRUE(parser.isDone());
+  TEST_ASSERT_EQUAL(PAYLOAD_ONE_POINT_PASSING_TIMES, responses[0].numberOfResponses);
+}
+
+void test_any_chunk_size_gives_the_same_passing_times_without_heap(){
+  parseInChunks(PAYLOAD_FAVOURITES, sizeof(PAYLOAD_FAVOURITES), expected);
+  for(size_t i = 0; i < sizeof(CHUNK_SIZES) / sizeof(CHUNK_SIZES[0]); i++){
+    for(int j = 0; j < PAYLOAD_FAVOURITES_POINTS; j++){
+      responses[j].clear();
+    }
+    size_t peak = parseInChunks(PAYLOAD_FAVOURITES, CHUNK_SIZES[i], responses);
+    printf("[parser] chunks of %4u bytes: peak heap %u bytes, %lu allocations\n",
+      (unsigned int)CHUNK_SIZES[i], (unsigned int)peak, nativeHeap().getAllocations());
+    assertSameResponses(responses, expected);
+    TEST_ASSERT_EQUAL(0, peak);
+  }
+}
+
+void test_truncated_payload_is_not_done(){
+  collector.begin(STOP_IDS, PAYLOAD_FAVOURITES_POINTS, responses);
+  parser.reset();
+  for(size_t i = 0; i < sizeof(PAYLOAD_FAVOURITES) / 2; i++){
+    TEST_ASSERT_TRUE(parser.feed(PAYLOAD_FAVOURITES[i]));
+  }
+  TEST_ASSERT_FALSE(parser.isDone());
+}
+
+void test_malformed_payload_fails(){
+  collector.begin(STOP_IDS, PAYLOAD_FAVOURITES_POINTS, responses);
+  parser.reset();
+  const char* payload = "{\"points\":[{\"passingTimes\":}]}";
+  bool accepted = true;
+  for(size_t i = 0; payload[i] != '\0' && accepted; i++){
+    accepted = parser.feed(payload[i]);
+  }
+  TEST_ASSERT_FALSE(accepted);
+  TEST_ASSERT_TRUE(parser.hasFailed());
+}
+
+/** Heap taken above the idle heap while the favourites are fetched on the kept alive connection */
+static size_t fetchFavouritesPeak(){
+  nativeHeap().resetCounters();
+  size_t liveBefore = nativeHeap().getLiveBytes();
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  TEST_ASSERT_EQUAL(liveBefore, nativeHeap().getLiveBytes());
+  return nativeHeap().getPeakBytes() - liveBefore;
+}
+
+/** Through the fetch path: the peak doesn't depend on the size of the body nor on how it is cut */
+void test_fetch_peak_heap_is_constant_whatever_the_payload_size(){
+  TEST_ASSERT_TRUE(bootFirmware());
+  // Opens the kept alive connection, its TLS buffers stay allocated
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  static const int PASSING_TIMES[] = {1, 4, MAX_PASSING_TIMES};
+  static const size_t SEGMENTS[] = {1, 7, 536, 1460};
+  size_t reference = 0;
+  for(size_t i = 0; i < sizeof(PASSING_TIMES) / sizeof(PASSING_TIMES[0]); i++){
+    for(size_t j = 0; j < sizeof(SEGMENTS) / sizeof(SEGMENTS[0]); j++){
+      api.passingTimesPerPoint = PASSING_TIMES[i];
+      api.chunkSize = SEGMENTS[j] * 3;
+      nativeNetwork.setSegmentSize(SEGMENTS[j]);
+      size_t peak = fetchFavouritesPeak();
+      printf("[parser] fetch of %2d passing times per stop, segments of %4u bytes: peak heap %u bytes\n",
+        PASSING_TIMES[i], (unsigned int)SEGMENTS[j], (unsigned int)peak);
+      TEST_ASSERT_EQUAL(PASSING_TIMES[i], passingTimeState.passingTimeResponses[0].numberOfResponses);
+      if(i == 0 && j == 0){
+        reference = peak;
+      }
+      TEST_ASSERT_EQUAL(reference, peak);
+    }
+  }
+  nativeNetwork.setSegmentSize(1460);
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_whole_payload);
+  RUN_TEST(test_pretty_printed_payload);
+  RUN_TEST(test_any_chunk_size_gives_the_same_passing_times_without_heap);
+  RUN_TEST(test_truncated_payload_is_not_done);
+  RUN_TEST(test_malformed_payload_fails);
+  RUN_TEST(test_fetch_peak_heap_is_constant_whatever_the_payload_size);
+  return UNITY_END();
+}
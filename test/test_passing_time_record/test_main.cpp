@@ -0,0 +1,182 @@
+/** Construction and sort of the passing times, before and after the compact record: the former PassingTime held
+ *  three Strings parsed with substring().toInt(), and was sorted on the ISO strings. It is kept here to compare.
+ *    pio test -e native -f test_passing_time_record
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <NativeBench.h>
+#include <Payloads.h>
+
+static const char* const STOP_IDS[] = {"5311", "1715", "8211", "5267", "8212"};
+
+/** The former record */
+class LegacyPassingTime{
+  String line;
+  String destination;
+  String expectedTime;
+  unsigned long expectedTimeInSec;
+
+  public:
+    LegacyPassingTime(String line, String destination, String expectedTime) :
+      line(line),
+      destination(destination),
+      expectedTime(expectedTime)
+    {
+      int hour = expectedTime.substring(11, 13).toInt();
+      int min = expectedTime.substring(14, 16).toInt();
+      int sec = expectedTime.substring(17, 19).toInt();
+      expectedTimeInSec = hour*3600 + min*60 + sec;
+    }
+
+    String getRawExpectedTime(){
+      return expectedTime;
+    }
+};
+
+/** The former comparison, a copy of both Strings each time */
+static bool sortLegacyPassingTimes(LegacyPassingTime* a, LegacyPassingTime* b){
+  return a->getRawExpectedTime() > b->getRawExpectedTime();
+}
+
+/** Bubble sort, like sortArray() of the ArduinoSort library */
+static void sortLegacy(LegacyPassingTime** items, int size){
+  for(int i = 0; i < size - 1; i++){
+    for(int j = 0; j < size - 1 - i; j++){
+      if(sortLegacyPassingTimes(items[j], items[j + 1])){
+        LegacyPassingTime* swap = items[j];
+        items[j] = items[j + 1];
+        items[j + 1] = swap;
+      }
+    }
+  }
+}
+
+/** A response worth of passing times of the recorded payload, in the order of the payload */
+struct Entry {
+  char line[LINE_ID_LENGTH];
+  char destination[DESTINATION_LENGTH];
+  char expectedTime[EXPECTED_TIME_LENGTH];
+  uint32_t epoch;
+};
+Entry entries[MAX_PASSING_TIMES];
+int numberOfEntries = 0;
+
+PassingTimeResponse responses[PAYLOAD_FAVOURITES_POINTS];
+PassingTimeResponse sorted;
+LegacyPassingTime* legacy[MAX_PASSING_TIMES];
+
+void setUp(){
+  PassingTimeCollector collector;
+  PassingTimeParser parser(&collector);
+  collector.begin(STOP_IDS, PAYLOAD_FAVOURITES_POINTS, responses);
+  parser.reset();
+  for(const char* p = PAYLOAD_FAVOURITES; *p != '\0'; p++){
+    parser.feed(*p);
+  }
+  TEST_ASSERT_TRUE(parser.isDone());
+  numberOfEntries = 0;
+  // The latest of each stop first: the sorts have work to do
+  for(int i = 0; i < PAYLOAD_FAVOURITES_POINTS && numberOfEntries < MAX_PASSING_TIMES; i++){
+    for(int j = responses[i].numberOfResponses - 1; j >= 0 && numberOfEntries < MAX_PASSING_TIMES; j--){
+      PassingTime* passingTime = &responses[i].passingTimes[j];
+      Entry& entry = entries[numberOfEntries++];
+      snprintf(entry.line, sizeof(entry.line), "%s", passingTime->getLine());
+      snprintf(entry.destination, sizeof(entry.destination), "%s", responses[i].getDestination(j));
+      formatEpochToIsoDate(passingTime->getExpectedEpoch(), passingTime->getUtcOffset(), entry.expectedTime);
+      entry.epoch = passingTime->getExpectedEpoch();
+    }
+  }
+  TEST_ASSERT_EQUAL(MAX_PASSING_TIMES, numberOfEntries);
+}
+
+void tearDown(){
+}
+
+void test_record_size(){
+  printf("[record] PassingTime: %lu bytes, PassingTimeResponse: %lu bytes for %d passing times\n",
+    (unsigned long)sizeof(PassingTime), (unsigned long)sizeof(PassingTimeResponse), MAX_PASSING_TIMES);
+  TEST_ASSERT_TRUE(sizeof(PassingTime) <= 16);
+}
+
+void test_bench_construct(){
+  NativeBenchResult before = nativeBench("before: construct 10 Strings", [](){
+    for(int i = 0; i < numberOfEntries; i++){
+      legacy[i] = new LegacyPassingTime(entries[i].line, entries[i].destination, entries[i].expectedTime);
+    }
+    for(int i = 0; i < numberOfEntries; i++){
+      delete legacy[i];
+    }
+  });
+  static PassingTime records[MAX_PASSING_TIMES];
+  NativeBenchResult after = nativeBench("after: construct 10 records", [](){
+    for(int i = 0; i < numberOfEntries; i++){
+      records[i].set(entries[i].line, 0, entries[i].expectedTime);
+    }
+  });
+  printf("[record] construct: %.1fx faster, %.1f allocations less per passing time\n", before.nsPerOp / after.nsPerOp,
+    (before.allocationsPerOp - after.allocationsPerOp) / numberOfEntries);
+  for(int i = 0; i < numberOfEntries; i++){
+    TEST_ASSERT_EQUAL(entries[i].epoch, records[i].getExpectedEpoch());
+  }
+  TEST_ASSERT_TRUE(before.allocations > 0);
+  TEST_ASSERT_EQUAL(0, after.allocations);
+}
+
+void test_bench_sort(){
+  static LegacyPassingTime* items[MAX_PASSING_TIMES];
+  for(int i = 0; i < numberOfEntries; i++){
+    legacy[i] = new LegacyPassingTime(entries[i].line, entries[i].destination, entries[i].expectedTime);
+  }
+  NativeBenchResult before = nativeBench("before: sort 10 on strings", [](){
+    memcpy(items, legacy, sizeof(items));
+    sortLegacy(items, numberOfEntries);
+  });
+  for(int i = 0; i < numberOfEntries; i++){
+    delete legacy[i];
+  }
+  NativeBenchResult after = nativeBench("after: insert 10 on epochs", [](){
+    sorted.clear();
+    for(int i = 0; i < numberOfEntries; i++){
+      sorted.add(entries[i].line, entries[i].destination, entries[i].epoch, 3600);
+    }
+  });
+  printf("[record] sort: %.1fx faster\n", before.nsPerOp / after.nsPerOp);
+  TEST_ASSERT_EQUAL(numberOfEntries, sorted.numberOfResponses);
+  for(int i = 1; i < sorted.numberOfResponses; i++){
+    TEST_ASSERT_TRUE(sorted.passingTimes[i-1].getExpectedEpoch() <= sorted.passingTimes[i].getExpectedEpoch());
+  }
+  TEST_ASSERT_TRUE(before.allocations > 0);
+  TEST_ASSERT_EQUAL(0, after.allocations);
+}
+
+void test_add_when_full(){
+  static PassingTimeResponse full;
+  full.clear();
+  char destination[8];
+  // One distinct destination per passing time: the destinations are full too
+  for(int i = 0; i < MAX_PASSING_TIMES; i++){
+    snprintf(destination, sizeof(destination), "D%d", i);
+    TEST_ASSERT_TRUE(full.add("1", destination, 1700000000 + 600 * (i + 1), 3600));
+  }
+  // Later than all of them: dropped
+  TEST_ASSERT_FALSE(full.add("2", "LATER", 1700000000 + 600 * (MAX_PASSING_TIMES + 1), 3600));
+  // Earlier than the latest: replaces it, with a destination never seen
+  TEST_ASSERT_TRUE(full.add("3", "EARLIER", 1700000000 + 300, 3600));
+  TEST_ASSERT_EQUAL(MAX_PASSING_TIMES, full.numberOfResponses);
+  TEST_ASSERT_EQUAL_STRING("3", full.passingTimes[0].getLine());
+  TEST_ASSERT_EQUAL_STRING("EARLIER", full.getDestination(0));
+  for(int i = 1; i < MAX_PASSING_TIMES; i++){
+    snprintf(destination, sizeof(destination), "D%d", i - 1);
+    TEST_ASSERT_EQUAL_STRING(destination, full.getDestination(i));
+    TEST_ASSERT_EQUAL(1700000000 + 600 * i, full.passingTimes[i].getExpectedEpoch());
+  }
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_record_size);
+  RUN_TEST(test_bench_construct);
+  RUN_TEST(test_bench_sort);
+  RUN_TEST(test_add_when_full);
+  return UNITY_END();
+}
@@ -0,0 +1,243 @@
+/** Requests per hour and freshness of the passing times, simulated on the host:
+ *  - the firmware with a passing time screen open for an hour against the stub: frequent and sparse lines, an hour
+ *    of 429 or 503 answers for a part of it, then the recovery, and 404 answers which don't back off
+ *  - displays sharing a key, each with its RequestBudget, against an API which rejects the requests over the
+ *    hourly quota of the key with a 429
+ *  The freshness is the age of the passing times received from the API, sampled every second.
+ *    pio test -e native -f test_request_budget
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <FirmwareHarness.h>
+
+#define BUDGET_SIMULATED_MINUTES 60
+/** Errors at the start of the hour, then the API answers again */
+#define BUDGET_FAILURE_MINUTES 20
+#define BUDGET_FLEET_HOURS 3
+#define BUDGET_MAX_DISPLAYS 8
+
+struct Freshness {
+  unsigned long samples;
+  unsigned long totalAgeSec;
+  unsigned long worstAgeSec;
+};
+
+static void sampleFreshness(Freshness& freshness, unsigned long ageMs){
+  freshness.samples++;
+  freshness.totalAgeSec += ageMs / 1000;
+  freshness.worstAgeSec = ageMs / 1000 > freshness.worstAgeSec ? ageMs / 1000 : freshness.worstAgeSec;
+}
+
+/** The screen of the first favourite open for the given minutes. Return the requests sent upstream */
+static unsigned long watchScreen(unsigned long minutes, Freshness& freshness){
+  unsigned long requests = api.passingTimeRequests;
+  for(unsigned long second = 0; second < minutes * 60; second++){
+    if(second % 60 == 0){
+      powerManager.notifyActivity();
+    }
+    runFor(1000);
+    sampleFreshness(freshness, millis() - passingTimeState.selectedResponse()->receivedAt);
+  }
+  return api.passingTimeRequests - requests;
+}
+
+static void printScenario(const char* name, unsigned long requests, const Freshness& freshness){
+  printf("[budget] %-22s %3lu requests/hour (budget %d), data age: %3lu s average, %3lu s worst\n", name,
+    requests * 60 / BUDGET_SIMULATED_MINUTES, API_HOURLY_BUDGET / API_KEY_DEVICES,
+    freshness.totalAgeSec / freshness.samples, freshness.worstAgeSec);
+}
+
+/** An hour with the API failing with the status for BUDGET_FAILURE_MINUTES */
+static void simulateFailure(const char* name, int status){
+  Freshness failing = {0, 0, 0};
+  Freshness recovered = {0, 0, 0};
+  api.forcedStatus = status;
+  unsigned long failedRequests = watchScreen(BUDGET_FAILURE_MINUTES, failing);
+  api.forcedStatus = 0;
+  // The backoff in progress ends, at most BACKOFF_MAX_SEC later
+  unsigned long requests = failedRequests + watchScreen(BACKOFF_MAX_SEC / 60, recovered);
+  recovered = {0, 0, 0};
+  requests += watchScreen(BUDGET_SIMULATED_MINUTES - BUDGET_FAILURE_MINUTES - BACKOFF_MAX_SEC / 60, recovered);
+  printScenario(name, requests, recovered);
+  printf("[budget] %-22s %3lu requests during the %d minutes of errors\n", "", failedRequests, BUDGET_FAILURE_MINUTES);
+  // The delays double up to BACKOFF_MAX_SEC, at least half of them with the jitter
+  unsigned long backoffRequests = 0;
+  unsigned long delaySec = BACKOFF_BASE_SEC;
+  for(unsigned long elapsedSec = 0; elapsedSec < BUDGET_FAILURE_MINUTES * 60UL; elapsedSec += delaySec / 2){
+    backoffRequests++;
+    delaySec = min(delaySec * 2, (unsigned long)BACKOFF_MAX_SEC);
+  }
+  TEST_ASSERT_TRUE(failedRequests <= backoffRequests + 1);
+  // Refreshed again after the errors
+  TEST_ASSERT_EQUAL(SOURCE_API, passingTimeState.selectedResponse()->source);
+  TEST_ASSERT_TRUE(recovered.worstAgeSec <= MAX_REFRESH_RATE_SEC + 10);
+}
+
+/** The API limit of a key: API_HOURLY_BUDGET requests in any hour, the others are rejected with a 429 */
+class KeyQuota {
+  unsigned long acceptedAt[API_HOURLY_BUDGET];
+  unsigned long accepted = 0;
+
+  public:
+    unsigned long rejected = 0;
+
+    int request(unsigned long now){
+      unsigned long oldest = acceptedAt[accepted % API_HOURLY_BUDGET];
+      if(accepted >= API_HOURLY_BUDGET && now - oldest < 3600000UL){
+        rejected++;
+        return 429;
+      }
+      acceptedAt[accepted++ % API_HOURLY_BUDGET] = now;
+      return HTTP_CODE_OK;
+    }
+
+    unsigned long getAccepted(){
+      return accepted;
+    }
+};
+
+struct FleetRun {
+  unsigned long accepted;
+  unsigned long rejected;
+  Freshness freshness;
+};
+
+/** Displays refreshing every REFRESH_RATE_SEC when their budget allows it, keyDevices being the API_KEY_DEVICES
+ *  they are configured with.
+ */
+static FleetRun simulateFleet(int displays, int keyDevices){
+  static KeyQuota quota;
+  quota = KeyQuota();
+  RequestBudget budgets[BUDGET_MAX_DISPLAYS];
+  unsigned long receivedAt[BUDGET_MAX_DISPLAYS];
+  for(int i = 0; i < displays; i++){
+    budgets[i] = RequestBudget(API_HOURLY_BUDGET / keyDevices);
+    budgets[i].seed(0x9E3779B9UL * (i + 1));
+    receivedAt[i] = 0;
+  }
+  FleetRun run = {0, 0, {0, 0, 0}};
+  // Started one second apart, each display then asks on its own
+  for(unsigned long now = 1000; now <= BUDGET_FLEET_HOURS * 3600000UL; now += 1000){
+    for(int i = 0; i < displays; i++){
+      bool due = receivedAt[i] == 0 || now - receivedAt[i] >= REFRESH_RATE_SEC * 1000UL;
+      if(now >= (unsigned long)(i + 1) * 1000 && due && budgets[i].canRequest(now)){
+        budgets[i].onRequestSent(now);
+        int status = quota.request(now);
+        budgets[i].onResult(status, now);
+        receivedAt[i] = status == HTTP_CODE_OK ? now : receivedAt[i];
+      }
+      // After the first hour: the burst of the start is over
+      if(now > 3600000UL && receivedAt[i] != 0){
+        sampleFreshness(run.freshness, now - receivedAt[i]);
+      }
+    }
+  }
+  run.accepted = quota.getAccepted();
+  run.rejected = quota.rejected;
+  printf("[budget] %d displays, API_KEY_DEVICES %d: %3lu requests/hour accepted, %3lu rejected, data age: %3lu s average, %3lu s worst\n",
+    displays, keyDevices, run.accepted / BUDGET_FLEET_HOURS, run.rejected / BUDGET_FLEET_HOURS,
+    run.freshness.totalAgeSec / run.freshness.samples, run.freshness.worstAgeSec);
+  return run;
+}
+
+/** The next refresh, from which the passing times of the stub follow its settings */
+static void refreshOnce(){
+  unsigned long requests = api.passingTimeRequests;
+  powerManager.notifyActivity();
+  TEST_ASSERT_TRUE(runUntil([requests](){ return api.passingTimeRequests > requests; }, MAX_REFRESH_RATE_SEC * 1000UL));
+  runFor(1000);
+}
+
+void setUp(){
+  TEST_ASSERT_TRUE(bootFirmware());
+  powerManager.notifyActivity();
+  if(appState.screen != PASSING_TIME){
+    openFavourite(0);
+  }
+  TEST_ASSERT_TRUE(runUntil([](){ return passingTimeState.lastUpdate != 0; }, 10000));
+}
+
+void tearDown(){
+  api.forcedStatus = 0;
+  api.intervalSec = 240;
+}
+
+void test_frequent_lines(){
+  api.intervalSec = 60;
+  refreshOnce();
+  Freshness freshness = {0, 0, 0};
+  unsigned long requests = watchScreen(BUDGET_SIMULATED_MINUTES, freshness);
+  printScenario("frequent lines", requests, freshness);
+  TEST_ASSERT_TRUE(requests * 60 / BUDGET_SIMULATED_MINUTES <= API_HOURLY_BUDGET / API_KEY_DEVICES);
+  TEST_ASSERT_TRUE(freshness.worstAgeSec <= REFRESH_RATE_SEC + 10);
+}
+
+void test_sparse_lines(){
+  api.intervalSec = 900;
+  refreshOnce();
+  Freshness freshness = {0, 0, 0};
+  unsigned long requests = watchScreen(BUDGET_SIMULATED_MINUTES, freshness);
+  printScenario("sparse lines", requests, freshness);
+  TEST_ASSERT_TRUE(requests * 60 / BUDGET_SIMULATED_MINUTES <= API_HOURLY_BUDGET / API_KEY_DEVICES);
+  TEST_ASSERT_TRUE(freshness.worstAgeSec <= MAX_REFRESH_RATE_SEC + 10);
+}
+
+void test_too_many_requests(){
+  simulateFailure("429 then recovered", 429);
+}
+
+void test_service_unavailable(){
+  simulateFailure("503 then recovered", 503);
+}
+
+/** Only the network failures, 429 and 5xx delay the next request */
+void test_backoff_on_transient_failures_only(){
+  static const int codes[] = {404, 401, 400, 0, -1, 429, 500, 503};
+  static const bool transients[] = {false, false, false, true, true, true, true, true};
+  for(unsigned int i = 0; i < sizeof(codes) / sizeof(codes[0]); i++){
+    RequestBudget budget;
+    budget.onRequestSent(1000);
+    budget.onResult(codes[i], 1000);
+    bool transient = transients[i];
+    TEST_ASSERT_EQUAL_MESSAGE(transient, budget.isBackingOff(), "backoff");
+    TEST_ASSERT_EQUAL_MESSAGE(transient, budget.getWaitMs(1000) >= BACKOFF_BASE_SEC * 1000UL / 2, "wait");
+  }
+}
+
+/** The stop is answered with a 404: the refreshes go on at their rate */
+void test_not_found(){
+  Freshness freshness = {0, 0, 0};
+  api.forcedStatus = 404;
+  unsigned long requests = watchScreen(BUDGET_FAILURE_MINUTES, freshness);
+  api.forcedStatus = 0;
+  printf("[budget] %-22s %3lu requests during %d minutes, backing off: %d\n", "404", requests, BUDGET_FAILURE_MINUTES,
+    requestBudget.isBackingOff());
+  TEST_ASSERT_FALSE(requestBudget.isBackingOff());
+  TEST_ASSERT_TRUE(requests >= BUDGET_FAILURE_MINUTES * 60UL / MAX_REFRESH_RATE_SEC);
+  TEST_ASSERT_TRUE(requests * 60 / BUDGET_FAILURE_MINUTES <= API_HOURLY_BUDGET / API_KEY_DEVICES);
+}
+
+void test_displays_sharing_a_key(){
+  FleetRun alone = simulateFleet(1, 1);
+  FleetRun shared = simulateFleet(BUDGET_MAX_DISPLAYS, BUDGET_MAX_DISPLAYS);
+  FleetRun misconfigured = simulateFleet(BUDGET_MAX_DISPLAYS, 1);
+  // Configured for the key: nothing rejected
+  TEST_ASSERT_EQUAL(0, alone.rejected);
+  TEST_ASSERT_EQUAL(0, shared.rejected);
+  // Refreshed at the interval of its share of the key
+  TEST_ASSERT_TRUE(shared.freshness.worstAgeSec <= 3600UL / (API_HOURLY_BUDGET / BUDGET_MAX_DISPLAYS - API_BURST) + 1);
+  // Not configured for the key: the backoff keeps the rejected requests a fraction of the accepted ones
+  TEST_ASSERT_TRUE(misconfigured.rejected < misconfigured.accepted / 2);
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_frequent_lines);
+  RUN_TEST(test_sparse_lines);
+  RUN_TEST(test_too_many_requests);
+  RUN_TEST(test_service_unavailable);
+  RUN_TEST(test_backoff_on_transient_failures_only);
+  RUN_TEST(test_not_found);
+  RUN_TEST(test_displays_sharing_a_key);
+  return UNITY_END();
+}
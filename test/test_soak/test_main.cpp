@@ -0,0 +1,158 @@
+/** Soak of the firmware against the stub: SOAK_CYCLES cycles of retrievePassingTime(), with a token renewal, a page
+ *  scrolled each cycle and a switch of screen, while the tracking allocator reports the heap at the end of each cycle.
+ *  The heap is reported for each tenth of the run. The run fails when it grows: the lowest live bytes of the last
+ *  tenth must stay within the highest of the first one, warm, and the largest free block must not shrink. Built with a budget that lets the
+ *  requests follow each other, the cycles don't wait for it.
+ *    pio test -e native -f test_soak
+ */
+#define API_HOURLY_BUDGET 3600000UL
+/** Still shorter than the debounce of the buttons and the render interval */
+#define HARNESS_PASS_MS 5
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <FirmwareHarness.h>
+
+#ifndef SOAK_CYCLES
+#define SOAK_CYCLES 200000UL
+#endif
+/** A token renewal, and a switch to the next favourite, every given number of cycles */
+#define SOAK_TOKEN_CYCLES 500
+#define SOAK_SCREEN_CYCLES 100
+/** Largest free block lost by the end of the run, at most: the allocations of the snapshot land between others */
+#define SOAK_BLOCK_SLACK_BYTES 256
+
+struct SoakWindow {
+  size_t minLive;
+  size_t maxLive;
+  uint32_t minMaxFreeBlock;
+  uint8_t maxFragmentation;
+  unsigned long allocations;
+};
+
+struct SoakReport {
+  SoakWindow first;
+  SoakWindow last;
+  size_t peakBytes;
+  unsigned long failedCycles;
+  unsigned long cycles;
+};
+
+/** Bytes kept by each cycle, to check that the run fails on growth */
+size_t injectedLeakBytes = 0;
+char* volatile leaked = NULL;
+unsigned int favourite = 0;
+
+/** One refresh of the passing time screen, a page scrolled, and from time to time a token renewal or another screen.
+ *  Return false when the refresh failed.
+ */
+static bool soakCycle(unsigned long cycle){
+  powerManager.notifyActivity();
+  if(cycle % SOAK_TOKEN_CYCLES == 0){
+    api.revokeToken();
+  }
+  if(cycle % SOAK_SCREEN_CYCLES == 0){
+    backToFavourites();
+    favourite = (favourite + 1) % NUMBER_OF_FAVOURITES;
+    openFavourite(favourite);
+  }
+  unsigned long lastUpdate = passingTimeState.lastUpdate;
+  runUntil([](){ return passingTimeFetcher.canStart() && WiFi.status() == WL_CONNECTED; }, 60000);
+  retrievePassingTime();
+  bool refreshed = runUntil([lastUpdate](){ return passingTimeState.lastUpdate != lastUpdate && !passingTimeFetcher.isBusy(); }, 60000);
+  pushButton(cycle % 2 == 0 ? DOWN_BUTTON : UP_BUTTON);
+  if(injectedLeakBytes > 0){
+    leaked = new char[injectedLeakBytes];
+  }
+  return refreshed;
+}
+
+static void resetWindow(SoakWindow& window){
+  window = {SIZE_MAX, 0, UINT32_MAX, 0, nativeHeap().getAllocations()};
+}
+
+/** The heap at the same point of every cycle */
+static void sampleHeap(SoakWindow& window){
+  size_t live = nativeHeap().getLiveBytes();
+  uint32_t block = nativeHeap().getMaxFreeBlock();
+  uint8_t fragmentation = nativeHeap().getFragmentation();
+  window.minLive = live < window.minLive ? live : window.minLive;
+  window.maxLive = live > window.maxLive ? live : window.maxLive;
+  window.minMaxFreeBlock = block < window.minMaxFreeBlock ? block : window.minMaxFreeBlock;
+  window.maxFragmentation = fragmentation > window.maxFragmentation ? fragmentation : window.maxFragmentation;
+}
+
+static void printWindow(unsigned long cycle, const SoakWindow& window, unsigned long cycles){
+  printf("[soak] cycle %7lu: live %6lu..%6lu B, peak %6lu B, %5.2f allocations/cycle, max free block %6lu B, fragmentation %2u %%\n",
+    cycle, (unsigned long)window.minLive, (unsigned long)window.maxLive, (unsigned long)nativeHeap().getPeakBytes(),
+    (double)(nativeHeap().getAllocations() - window.allocations) / cycles, (unsigned long)window.minMaxFreeBlock,
+    window.maxFragmentation);
+}
+
+static SoakReport runSoak(unsigned long cycles){
+  SoakReport report;
+  report.failedCycles = 0;
+  report.cycles = cycles;
+  unsigned long windowCycles = cycles / 10;
+  SoakWindow window;
+  resetWindow(window);
+  for(unsigned long cycle = 1; cycle <= cycles; cycle++){
+    if(!soakCycle(cycle)){
+      report.failedCycles++;
+    }
+    sampleHeap(window);
+    if(cycle % windowCycles == 0){
+      printWindow(cycle, window, windowCycles);
+      if(cycle == windowCycles){
+        report.first = window;
+      }
+      report.last = window;
+      resetWindow(window);
+    }
+  }
+  report.peakBytes = nativeHeap().getPeakBytes();
+  return report;
+}
+
+/** Growth between the first window, warm, and the last one */
+static bool isGrowing(const SoakReport& report){
+  return report.last.minLive > report.first.maxLive
+    || report.last.minMaxFreeBlock + SOAK_BLOCK_SLACK_BYTES < report.first.minMaxFreeBlock;
+}
+
+void setUp(){
+  TEST_ASSERT_TRUE(bootFirmware());
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  powerManager.notifyActivity();
+  if(appState.screen != PASSING_TIME){
+    openFavourite(favourite);
+  }
+}
+
+void tearDown(){
+  injectedLeakBytes = 0;
+}
+
+void test_soak(){
+  unsigned long tokens = api.tokenRequests;
+  SoakReport report = runSoak(SOAK_CYCLES);
+  printf("[soak] %lu cycles, %lu token renewals, %lu s simulated: live %lu B -> %lu B, max free block %lu B -> %lu B\n",
+    report.cycles, api.tokenRequests - tokens, millis() / 1000, (unsigned long)report.first.maxLive,
+    (unsigned long)report.last.minLive, (unsigned long)report.first.minMaxFreeBlock, (unsigned long)report.last.minMaxFreeBlock);
+  TEST_ASSERT_EQUAL(0, report.failedCycles);
+  TEST_ASSERT_TRUE(api.tokenRequests - tokens >= SOAK_CYCLES / SOAK_TOKEN_CYCLES);
+  TEST_ASSERT_FALSE(isGrowing(report));
+}
+
+/** The same run with 16 bytes kept by each cycle must fail */
+void test_soak_fails_on_growth(){
+  injectedLeakBytes = 16;
+  SoakReport report = runSoak(500);
+  TEST_ASSERT_TRUE(isGrowing(report));
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_soak);
+  RUN_TEST(test_soak_fails_on_growth);
+  return UNITY_END();
+}
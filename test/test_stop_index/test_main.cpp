@@ -0,0 +1,94 @@
+/** The stop index compiled from stops.txt: every stop found by id and by name, the cost of the lookups and the
+ *  size of the tables in flash.
+ *    pio test -e native -f test_stop_index
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <NativeBench.h>
+
+/** Flash taken by the tables, at most */
+#define STOP_INDEX_MAX_BYTES (64 * 1024UL)
+
+static size_t getStopIndexBytes(){
+  return sizeof(STOP_NAMES) + sizeof(STOP_NAME_OFFSETS) + sizeof(STOP_ENTRIES) + sizeof(STOPS_BY_NAME);
+}
+
+void setUp(){
+}
+
+void tearDown(){
+}
+
+void test_every_stop_is_found_by_id(){
+  char id[STOP_ID_LENGTH + 1];
+  for(int i = 0; i < STOP_COUNT; i++){
+    getStopId(i, id);
+    id[STOP_ID_LENGTH] = '\0';
+    TEST_ASSERT_EQUAL(i, findStopById(id));
+  }
+  TEST_ASSERT_EQUAL(-1, findStopById("0"));
+  TEST_ASSERT_EQUAL(-1, findStopById("ZZZZ"));
+  TEST_ASSERT_TRUE(findStopById(favourites[0].stopId) >= 0);
+}
+
+void test_every_stop_is_found_by_name(){
+  char name[64];
+  for(int position = 0; position < STOP_COUNT; position++){
+    int stopIndex = getStopIndexAtNamePosition(position);
+    getStopName(stopIndex, name, sizeof(name));
+    int first = findFirstStopByNamePrefix(name);
+    // The first stop of the same name, or of a name this one is the prefix of
+    TEST_ASSERT_TRUE(first >= 0 && first <= position);
+    if(position > 0){
+      char previous[64];
+      getStopName(getStopIndexAtNamePosition(position - 1), previous, sizeof(previous));
+      TEST_ASSERT_TRUE(strcmp(previous, name) <= 0);
+    }
+  }
+  TEST_ASSERT_EQUAL(-1, findFirstStopByNamePrefix("ZZZZZ"));
+}
+
+void test_bench_find_by_id(){
+  static int next = 0;
+  static char ids[STOP_COUNT][STOP_ID_LENGTH + 1];
+  for(int i = 0; i < STOP_COUNT; i++){
+    getStopId(i, ids[i]);
+    ids[i][STOP_ID_LENGTH] = '\0';
+  }
+  NativeBenchResult result = nativeBench("findStopById", [](){
+    findStopById(ids[next]);
+    next = (next + 977) % STOP_COUNT;
+  });
+  TEST_ASSERT_EQUAL(0, result.allocations);
+}
+
+void test_bench_find_by_name_prefix(){
+  static const char* const PREFIXES[] = {"A", "BO", "DE BROU", "MONTG", "ROGIER", "STOCK", "V", "ZZ"};
+  static int next = 0;
+  NativeBenchResult result = nativeBench("findFirstStopByNamePrefix", [](){
+    findFirstStopByNamePrefix(PREFIXES[next]);
+    next = (next + 1) % (sizeof(PREFIXES) / sizeof(PREFIXES[0]));
+  });
+  TEST_ASSERT_EQUAL(0, result.allocations);
+}
+
+void test_table_size(){
+  size_t bytes = getStopIndexBytes();
+  printf("[stop index] %d stops, %d names: %lu bytes of flash (names %lu, offsets %lu, entries %lu, by name %lu), %.1f bytes/stop\n",
+    STOP_COUNT, STOP_NAME_COUNT, (unsigned long)bytes, (unsigned long)sizeof(STOP_NAMES), (unsigned long)sizeof(STOP_NAME_OFFSETS),
+    (unsigned long)sizeof(STOP_ENTRIES), (unsigned long)sizeof(STOPS_BY_NAME), (double)bytes / STOP_COUNT);
+  TEST_ASSERT_TRUE(bytes <= STOP_INDEX_MAX_BYTES);
+  // Names are interned: fewer than the stops, each offset fits the 16 bits
+  TEST_ASSERT_TRUE(STOP_NAME_COUNT < STOP_COUNT);
+  TEST_ASSERT_TRUE(sizeof(STOP_NAMES) <= 65536);
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_every_stop_is_found_by_id);
+  RUN_TEST(test_every_stop_is_found_by_name);
+  RUN_TEST(test_bench_find_by_id);
+  RUN_TEST(test_bench_find_by_name_prefix);
+  RUN_TEST(test_table_size);
+  return UNITY_END();
+}
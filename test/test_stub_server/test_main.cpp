@@ -0,0 +1,123 @@
+/** The passing times of all the favourites fetched in one request to the stub server, one result set per stop,
+ *  the stops without any passing time displayed as such, and a stop selected while a fetch is running.
+ *    pio test -e native -f test_stub_server
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <FirmwareHarness.h>
+
+PassingTimeResponse restored[NUMBER_OF_FAVOURITES];
+
+void setUp(){
+  TEST_ASSERT_TRUE(bootFirmware());
+  api.passingTimesPerPoint = 4;
+  api.emptyPoint = NULL;
+}
+
+void tearDown(){
+  api.emptyPoint = NULL;
+}
+
+void test_one_request_for_all_the_favourites(){
+  // The first fetch may open the connection
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  unsigned long requests = api.passingTimeRequests;
+  unsigned long points = api.points;
+  unsigned long connections = nativeNetwork.getConnections();
+  for(int i = 0; i < 3; i++){
+    TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  }
+  printf("[stub] 3 fetches: %lu requests, %lu points, %lu connections\n", api.passingTimeRequests - requests,
+    api.points - points, nativeNetwork.getConnections() - connections);
+  TEST_ASSERT_EQUAL(3, api.passingTimeRequests - requests);
+  TEST_ASSERT_EQUAL(3 * NUMBER_OF_FAVOURITES, api.points - points);
+  // Kept alive
+  TEST_ASSERT_EQUAL(0, nativeNetwork.getConnections() - connections);
+}
+
+void test_each_stop_gets_its_own_result_set(){
+  api.emptyPoint = favourites[2].stopId;
+  api.passingTimesPerPoint = 3;
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  for(int i = 0; i < NUMBER_OF_FAVOURITES; i++){
+    TEST_ASSERT_EQUAL(i == 2 ? 0 : 3, passingTimeState.passingTimeResponses[i].numberOfResponses);
+    TEST_ASSERT_EQUAL(SOURCE_API, passingTimeState.passingTimeResponses[i].source);
+  }
+}
+
+void test_stop_without_passing_time_is_displayed_as_such(){
+  // Passing times left in the store by a former response
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  api.emptyPoint = favourites[0].stopId;
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  openFavourite(0);
+  TEST_ASSERT_TRUE(runUntil([](){ return passingTimeState.lastUpdate != 0; }, 10000));
+  runFor(RENDER_INTERVAL_MS);
+  TEST_ASSERT_EQUAL_STRING("No passing time ", lcdRow(0));
+  TEST_ASSERT_EQUAL_STRING("----------------", lcdRow(1));
+  // A single page
+  pushButton(DOWN_BUTTON);
+  TEST_ASSERT_EQUAL(1, passingTimeState.passingTimePage);
+  TEST_ASSERT_EQUAL(0, strncmp("<<Bottom>>", lcdRow(1), 10));
+  pushButton(UP_BUTTON);
+  TEST_ASSERT_EQUAL(1, passingTimeState.passingTimePage);
+  TEST_ASSERT_EQUAL(0, strncmp("<< Top >>", lcdRow(0), 9));
+  runFor(END_OF_RECORD_MS + RENDER_INTERVAL_MS);
+  TEST_ASSERT_EQUAL_STRING("No passing time ", lcdRow(0));
+  backToFavourites();
+}
+
+/** All the passing times of the snapshot have passed when it is restored */
+void test_empty_restored_snapshot_is_displayed_as_such(){
+  api.passingTimesPerPoint = 2;
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  TEST_ASSERT_TRUE(snapshot.save(passingTimeState.passingTimeResponses, NUMBER_OF_FAVOURITES));
+  uint32_t nextDay = timeService.now(millis()) + 24 * 3600UL;
+  TEST_ASSERT_TRUE(snapshot.load(restored, NUMBER_OF_FAVOURITES, nextDay));
+  TEST_ASSERT_EQUAL(0, restored[0].numberOfResponses);
+  TEST_ASSERT_EQUAL(SOURCE_SNAPSHOT, restored[0].source);
+  TEST_ASSERT_EQUAL(1, getNumberOfPages(&restored[0]));
+  displayPassingTimeOnLcd(&restored[0], 1);
+  lcdFrame.flush();
+  TEST_ASSERT_EQUAL_STRING("No passing time ", lcdRow(0));
+  TEST_ASSERT_EQUAL_STRING("----------------", lcdRow(1));
+}
+
+/** The page displayed is kept within the passing times left */
+void test_page_beyond_the_passing_times_is_clamped(){
+  api.passingTimesPerPoint = 1;
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  displayPassingTimeOnLcd(&passingTimeState.passingTimeResponses[0], 3);
+  TEST_ASSERT_EQUAL(1, passingTimeState.passingTimePage);
+  lcdFrame.flush();
+  TEST_ASSERT_EQUAL_STRING("----------------", lcdRow(1));
+}
+
+/** The stop is selected while a prefetch of the favourites is running: its own fetch follows, the prefetch isn't displayed */
+void test_stop_selected_during_a_fetch(){
+  TEST_ASSERT_TRUE(runUntil([](){ return passingTimeFetcher.canStart(); }, 60000));
+  unsigned long requests = api.passingTimeRequests;
+  TEST_ASSERT_TRUE(passingTimeFetcher.startFavourites(passingTimeState.passingTimeResponses, onPassingTimeReceived));
+  runPass();
+  TEST_ASSERT_TRUE(passingTimeFetcher.isBusy());
+  stopSearchState.namePosition = 0;
+  selectSearchedStop();
+  TEST_ASSERT_TRUE(runUntil([](){ return passingTimeState.lastUpdate != 0; }, 60000));
+  runFor(RENDER_INTERVAL_MS);
+  printf("[stub] stop %s selected during a fetch: %lu requests\n", stopSearchState.stopId, api.passingTimeRequests - requests);
+  TEST_ASSERT_EQUAL(2, api.passingTimeRequests - requests);
+  TEST_ASSERT_EQUAL(4, passingTimeState.selectedResponse()->numberOfResponses);
+  TEST_ASSERT_TRUE(strcmp("No passing time ", lcdRow(0)) != 0);
+  backToFavourites();
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_one_request_for_all_the_favourites);
+  RUN_TEST(test_each_stop_gets_its_own_result_set);
+  RUN_TEST(test_stop_without_passing_time_is_displayed_as_such);
+  RUN_TEST(test_empty_restored_snapshot_is_displayed_as_such);
+  RUN_TEST(test_page_beyond_the_passing_times_is_clamped);
+  RUN_TEST(test_stop_selected_during_a_fetch);
+  return UNITY_END();
+}
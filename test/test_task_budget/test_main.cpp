@@ -0,0 +1,114 @@
+/** Every task of the scheduler returns within TASK_BUDGET_MS: the boot with WiFi and NTP, the fetches, the screens,
+ *  the stop search and the light sleep. The CPU time of the host is counted slowed down like an ESP8266, the I2C
+ *  transfers to the LCD with their duration.
+ *  The TLS handshakes are done inside connect() by BearSSL, they are not counted here: see test_tls.
+ *    pio test -e native -f test_task_budget
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <FirmwareHarness.h>
+#include <limits.h>
+
+/** Host CPU compared to an ESP8266 at 80MHz */
+#define TASK_ESP_SLOWDOWN 100
+/** A preemption of the host is not the firmware: the best of the runs is kept for each task */
+#define TASK_RUNS 3
+
+unsigned long bestMaxRunUs[MAX_TASKS];
+
+static void resetBest(){
+  for(int i = 0; i < MAX_TASKS; i++){
+    bestMaxRunUs[i] = ULONG_MAX;
+  }
+}
+
+static void keepBest(){
+  for(uint8_t i = 0; i < scheduler.getNumberOfTasks(); i++){
+    unsigned long maxRunUs = scheduler.getTask(i)->getMaxRunUs();
+    bestMaxRunUs[i] = maxRunUs < bestMaxRunUs[i] ? maxRunUs : bestMaxRunUs[i];
+  }
+  scheduler.resetStats();
+}
+
+static void assertWithinBudget(const char* scenario){
+  for(uint8_t i = 0; i < scheduler.getNumberOfTasks(); i++){
+    Task* task = scheduler.getTask(i);
+    printf("[task] %-10s %-8s worst %6lu us\n", scenario, task->getName(), bestMaxRunUs[i]);
+  }
+  for(uint8_t i = 0; i < scheduler.getNumberOfTasks(); i++){
+    TEST_ASSERT_LESS_OR_EQUAL(TASK_BUDGET_MS * 1000UL, bestMaxRunUs[i]);
+  }
+}
+
+/** The screens the way a user goes through them */
+static void useTheScreens(){
+  powerManager.notifyActivity();
+  openFavourite(0);
+  runUntil([](){ return passingTimeState.lastUpdate != 0; }, 10000);
+  for(int minute = 0; minute < 2; minute++){
+    powerManager.notifyActivity();
+    runFor(60 * 1000UL);
+  }
+  pushButton(DOWN_BUTTON);
+  pushButton(UP_BUTTON);
+  // End of record at the top
+  pushButton(UP_BUTTON);
+  backToFavourites();
+  // The stop search: a letter, then back
+  openFavourite(SEARCHED_STOP_SLOT);
+  pushButton(DOWN_BUTTON);
+  pushButton(DOWN_BUTTON);
+  pushButton(SELECT_BUTTON);
+  backToFavourites();
+}
+
+void setUp(){
+}
+
+void tearDown(){
+  nativeBoard.setCpuSlowdown(0);
+}
+
+void test_boot_within_budget(){
+  nativeNetwork.setWiFiConnectMs(2000);
+  nativeBoard.setCpuSlowdown(TASK_ESP_SLOWDOWN);
+  TEST_ASSERT_TRUE(bootFirmware());
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  resetBest();
+  keepBest();
+  assertWithinBudget("boot");
+}
+
+void test_screens_within_budget(){
+  resetBest();
+  for(int run = 0; run < TASK_RUNS; run++){
+    nativeBoard.setCpuSlowdown(TASK_ESP_SLOWDOWN);
+    useTheScreens();
+    nativeBoard.setCpuSlowdown(0);
+    keepBest();
+  }
+  assertWithinBudget("screens");
+}
+
+void test_sleep_within_budget(){
+  resetBest();
+  for(int run = 0; run < TASK_RUNS; run++){
+    unsigned long sleeps = nativeBoard.getSleeps();
+    nativeBoard.setCpuSlowdown(TASK_ESP_SLOWDOWN);
+    TEST_ASSERT_TRUE(runUntil([sleeps](){ return nativeBoard.getSleeps() > sleeps; }, (POWER_IDLE_SEC + 10) * 1000UL));
+    // Woken up by the first button, released
+    nativeBoard.setPin(UP_BUTTON, LOW);
+    runFor(5000);
+    nativeBoard.setCpuSlowdown(0);
+    keepBest();
+  }
+  assertWithinBudget("sleep");
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_boot_within_budget);
+  RUN_TEST(test_screens_within_budget);
+  RUN_TEST(test_sleep_within_budget);
+  return UNITY_END();
+}
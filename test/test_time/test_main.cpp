@@ -0,0 +1,134 @@
+/** The epochs of the passing times and the clock anchored on millis(): the remaining times across midnight, the
+ *  DST changes and the passed times, the dates of the API parsed to epochs, the wraparound of millis(), and the
+ *  cost of "now" against the former localtime() of each render.
+ *    pio test -e native -f test_time
+ */
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <NativeBench.h>
+
+static uint32_t epochOf(const char* date){
+  return parseIsoDateToEpoch(date, NULL);
+}
+
+static long remainingSeconds(const char* expected, const char* now){
+  PassingTime passingTime;
+  passingTime.set("71", 0, expected);
+  return passingTime.getRemainingSeconds(epochOf(now));
+}
+
+void setUp(){
+}
+
+void tearDown(){
+}
+
+void test_parse_iso_dates(){
+  long offset = 0;
+  TEST_ASSERT_EQUAL(1551645000UL, parseIsoDateToEpoch("2019-03-03T21:30:00+01:00", &offset));
+  TEST_ASSERT_EQUAL(3600, offset);
+  TEST_ASSERT_EQUAL(1551645000UL, parseIsoDateToEpoch("2019-03-03T20:30:00Z", &offset));
+  TEST_ASSERT_EQUAL(0, offset);
+  TEST_ASSERT_EQUAL(1551645000UL, parseIsoDateToEpoch("2019-03-03T15:30:00.250-05:00", &offset));
+  TEST_ASSERT_EQUAL(-5 * 3600, offset);
+  // Leap day
+  TEST_ASSERT_EQUAL(epochOf("2024-03-01T00:00:00Z") - 86400, epochOf("2024-02-29T00:00:00Z"));
+  TEST_ASSERT_EQUAL(0, epochOf(""));
+  TEST_ASSERT_EQUAL(0, epochOf("2019"));
+  TEST_ASSERT_EQUAL(0, epochOf("2019-03-03 21:30:00+01:00"));
+  TEST_ASSERT_EQUAL(0, epochOf("2019-03-03T21:3"));
+}
+
+void test_format_round_trip(){
+  static const char* const DATES[] = {"2019-03-03T21:30:00+01:00", "2026-10-25T02:10:00+02:00", "2026-12-31T23:59:59-05:30"};
+  for(size_t i = 0; i < sizeof(DATES) / sizeof(DATES[0]); i++){
+    long offset = 0;
+    uint32_t epoch = parseIsoDateToEpoch(DATES[i], &offset);
+    char formatted[EXPECTED_TIME_LENGTH];
+    formatEpochToIsoDate(epoch, offset, formatted);
+    TEST_ASSERT_EQUAL_STRING(DATES[i], formatted);
+  }
+}
+
+void test_remaining_across_midnight(){
+  TEST_ASSERT_EQUAL(240, remainingSeconds("2026-11-11T00:02:00+01:00", "2026-11-10T23:58:00+01:00"));
+  TEST_ASSERT_EQUAL(0, remainingSeconds("2026-11-11T00:00:00+01:00", "2026-11-11T00:00:00+01:00"));
+}
+
+void test_remaining_across_dst_changes(){
+  // 03:00 CEST is 02:00 CET: 02:55 CEST is before 02:10 CET
+  TEST_ASSERT_EQUAL(15 * 60, remainingSeconds("2026-10-25T02:10:00+01:00", "2026-10-25T02:55:00+02:00"));
+  // 02:00 CET is 03:00 CEST
+  TEST_ASSERT_EQUAL(10 * 60, remainingSeconds("2026-03-29T03:05:00+02:00", "2026-03-29T01:55:00+01:00"));
+  // The API and the device in different offsets
+  TEST_ASSERT_EQUAL(60, remainingSeconds("2026-11-10T08:01:00+01:00", "2026-11-10T07:00:00Z"));
+}
+
+void test_passed_times_are_negative(){
+  TEST_ASSERT_EQUAL(-120, remainingSeconds("2026-11-10T07:58:00+01:00", "2026-11-10T08:00:00+01:00"));
+  PassingTime passingTime;
+  passingTime.set("71", 0, "2026-11-10T07:58:00+01:00");
+  TEST_ASSERT_EQUAL(0, passingTime.getRemainingTime(epochOf("2026-11-10T08:00:00+01:00")));
+}
+
+void test_remaining_minutes_are_rounded(){
+  PassingTime passingTime;
+  passingTime.set("71", 0, "2026-11-10T08:00:00+01:00");
+  uint32_t expected = passingTime.getExpectedEpoch();
+  // Incoming below a minute
+  TEST_ASSERT_EQUAL(0, passingTime.getRemainingTime(expected - 59));
+  TEST_ASSERT_EQUAL(1, passingTime.getRemainingTime(expected - 60));
+  // Rounded up after 45 seconds
+  TEST_ASSERT_EQUAL(1, passingTime.getRemainingTime(expected - 105));
+  TEST_ASSERT_EQUAL(2, passingTime.getRemainingTime(expected - 106));
+}
+
+void test_clock_anchored_on_millis(){
+  TimeService clock;
+  TEST_ASSERT_FALSE(clock.isSet());
+  TEST_ASSERT_EQUAL(0, clock.now(1000));
+  // Not set yet by NTP
+  clock.anchor(3600, 0, 1000);
+  TEST_ASSERT_FALSE(clock.isSet());
+  uint32_t epoch = epochOf("2026-11-10T08:00:00+01:00");
+  clock.anchor(epoch, 3600, 5000);
+  TEST_ASSERT_EQUAL(epoch, clock.now(5999));
+  TEST_ASSERT_EQUAL(epoch + 1, clock.now(6000));
+  TEST_ASSERT_EQUAL(3600, clock.getUtcOffset());
+  // millis() wraps around after 49 days
+  clock.anchor(epoch, 3600, 0xFFFFF000UL);
+  TEST_ASSERT_EQUAL(epoch + 8, clock.now(0x00001000UL));
+}
+
+void test_bench_now(){
+  static TimeService clock;
+  static PassingTime passingTime;
+  static unsigned long ms = 0;
+  static long sum = 0;
+  clock.anchor(epochOf("2026-11-10T08:00:00+01:00"), 3600, 0);
+  passingTime.set("71", 0, "2026-11-10T08:30:00+01:00");
+  NativeBenchResult after = nativeBench("now + remaining time", [](){
+    sum += passingTime.getRemainingTime(clock.now(ms += 7));
+  });
+  NativeBenchResult before = nativeBench("before: time + localtime", [](){
+    time_t now = dstAdjusted.time(&dstAbbrev);
+    struct tm* local = localtime(&now);
+    sum += local->tm_hour * 3600 + local->tm_min * 60 + local->tm_sec;
+  });
+  printf("[time] now: %.1fx faster than the former seconds since midnight\n", before.nsPerOp / after.nsPerOp);
+  TEST_ASSERT_EQUAL(0, after.allocations);
+  TEST_ASSERT_TRUE(after.nsPerOp < before.nsPerOp);
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_parse_iso_dates);
+  RUN_TEST(test_format_round_trip);
+  RUN_TEST(test_remaining_across_midnight);
+  RUN_TEST(test_remaining_across_dst_changes);
+  RUN_TEST(test_passed_times_are_negative);
+  RUN_TEST(test_remaining_minutes_are_rounded);
+  RUN_TEST(test_clock_anchored_on_millis);
+  RUN_TEST(test_bench_now);
+  return UNITY_END();
+}
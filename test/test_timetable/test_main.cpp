@@ -0,0 +1,130 @@
+/** The timetable of the favourites compiled from the GTFS feed of test/support/gtfs (TimetableFixture.h): the next
+ *  departures on a weekday, after midnight and on a holiday, a stop without timetable, the cost of a lookup and the
+ *  size of the tables in flash.
+ *    pio test -e native -f test_timetable
+ */
+#define TIMETABLE_DATA <TimetableFixture.h>
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <NativeBench.h>
+
+/** Days since 1970-01-01 of the fixture: a tuesday, the holiday of 11 november, a saturday */
+#define TUESDAY 20767
+#define HOLIDAY 20768
+#define SATURDAY 20771
+#define CET_OFFSET 3600
+/** Flash taken by the tables, at most */
+#define TIMETABLE_MAX_BYTES (64 * 1024UL)
+
+static uint32_t localTime(uint16_t day, int hour, int minute){
+  return (uint32_t)day * SECONDS_PER_DAY + hour * 3600 + minute * 60 - CET_OFFSET;
+}
+
+static size_t getTimetableBytes(){
+  // Without the terminators of the arrays
+  return sizeof(TIMETABLE_DESTINATIONS) + TIMETABLE_SERVICE_COUNT * sizeof(TimetableService)
+    + TIMETABLE_EXCEPTION_COUNT * sizeof(TimetableException) + TIMETABLE_PATTERN_COUNT * sizeof(TimetablePattern)
+    + TIMETABLE_STOP_COUNT * sizeof(TimetableStop) + TIMETABLE_DEPARTURE_COUNT * sizeof(TimetableDeparture);
+}
+
+/** Shortest time between two departures of the line in the response */
+static long shortestGapSec(PassingTimeResponse* response, const char* line){
+  long shortest = -1;
+  uint32_t previous = 0;
+  for(int i = 0; i < response->numberOfResponses; i++){
+    if(strcmp(response->passingTimes[i].getLine(), line) != 0){
+      continue;
+    }
+    uint32_t epoch = response->passingTimes[i].getExpectedEpoch();
+    if(previous != 0 && (shortest < 0 || (long)(epoch - previous) < shortest)){
+      shortest = epoch - previous;
+    }
+    previous = epoch;
+  }
+  return shortest;
+}
+
+PassingTimeResponse response;
+
+void setUp(){
+  response.clear();
+}
+
+void tearDown(){
+}
+
+void test_next_departures_on_a_weekday(){
+  uint32_t now = localTime(TUESDAY, 8, 0);
+  TEST_ASSERT_EQUAL(MAX_PASSING_TIMES, findScheduledPassingTimes("8211", now, CET_OFFSET, &response));
+  TEST_ASSERT_EQUAL(SOURCE_TIMETABLE, response.source);
+  for(int i = 0; i < response.numberOfResponses; i++){
+    TEST_ASSERT_TRUE(response.passingTimes[i].getExpectedEpoch() >= now);
+    TEST_ASSERT_TRUE(i == 0 || response.passingTimes[i-1].getExpectedEpoch() <= response.passingTimes[i].getExpectedEpoch());
+    TEST_ASSERT_EQUAL(CET_OFFSET, response.passingTimes[i].getUtcOffset());
+  }
+  // Every 6 minutes at the peak
+  TEST_ASSERT_TRUE(response.passingTimes[0].getExpectedEpoch() - now < 6 * 60);
+  TEST_ASSERT_EQUAL(6 * 60, shortestGapSec(&response, "1"));
+  for(int i = 0; i < response.numberOfResponses; i++){
+    bool metro1 = strcmp(response.passingTimes[i].getLine(), "1") == 0;
+    TEST_ASSERT_EQUAL_STRING(metro1 ? "STOCKEL" : "HERRMANN-DEBROUX", response.getDestination(i));
+  }
+}
+
+void test_trips_after_midnight(){
+  // The service of friday runs until 00:30, the one of saturday starts at 05:30
+  uint32_t now = localTime(SATURDAY, 0, 10);
+  TEST_ASSERT_TRUE(findScheduledPassingTimes("8211", now, CET_OFFSET, &response) > 0);
+  TEST_ASSERT_TRUE(response.passingTimes[0].getExpectedEpoch() - now <= 20 * 60);
+  TEST_ASSERT_TRUE(response.passingTimes[response.numberOfResponses - 1].getExpectedEpoch() > localTime(SATURDAY, 5, 0));
+}
+
+void test_holiday_runs_the_sunday_service(){
+  TEST_ASSERT_TRUE(findScheduledPassingTimes("8211", localTime(HOLIDAY, 8, 0), CET_OFFSET, &response) > 0);
+  TEST_ASSERT_EQUAL(15 * 60, shortestGapSec(&response, "1"));
+}
+
+void test_stop_without_timetable_keeps_the_response(){
+  response.add("71", "DE BROUCKERE", localTime(TUESDAY, 8, 3), CET_OFFSET);
+  response.add("95", "WIENER", localTime(TUESDAY, 8, 5), CET_OFFSET);
+  response.receivedAt = 1234;
+  static PassingTimeResponse before;
+  before = response;
+  // 8212 is a favourite absent from the feed
+  TEST_ASSERT_EQUAL(0, findScheduledPassingTimes("8212", localTime(TUESDAY, 8, 0), CET_OFFSET, &response));
+  TEST_ASSERT_EQUAL(0, findScheduledPassingTimes("0000", localTime(TUESDAY, 8, 0), CET_OFFSET, &response));
+  TEST_ASSERT_EQUAL_MEMORY(&before, &response, sizeof(PassingTimeResponse));
+  TEST_ASSERT_EQUAL(SOURCE_API, response.source);
+}
+
+void test_bench_lookup(){
+  static const char* const STOP_IDS[] = {"5311", "1715", "8211", "5267"};
+  static int next = 0;
+  NativeBenchResult result = nativeBench("findScheduledPassingTimes", [](){
+    // Every stop, every 7 minutes of a week
+    uint32_t now = localTime(TUESDAY, 0, 0) + (next * 7 % (7 * 1440)) * 60;
+    findScheduledPassingTimes(STOP_IDS[next % 4], now, CET_OFFSET, &response);
+    next++;
+  });
+  TEST_ASSERT_EQUAL(0, result.allocations);
+}
+
+void test_table_size(){
+  size_t bytes = getTimetableBytes();
+  printf("[timetable] %d stops, %d departures, %d services, %d patterns: %lu bytes of flash (departures %lu), %.1f bytes/departure\n",
+    TIMETABLE_STOP_COUNT, TIMETABLE_DEPARTURE_COUNT, TIMETABLE_SERVICE_COUNT, TIMETABLE_PATTERN_COUNT, (unsigned long)bytes,
+    (unsigned long)(TIMETABLE_DEPARTURE_COUNT * sizeof(TimetableDeparture)), (double)bytes / TIMETABLE_DEPARTURE_COUNT);
+  TEST_ASSERT_EQUAL(4, sizeof(TimetableDeparture));
+  TEST_ASSERT_TRUE(bytes <= TIMETABLE_MAX_BYTES);
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_next_departures_on_a_weekday);
+  RUN_TEST(test_trips_after_midnight);
+  RUN_TEST(test_holiday_runs_the_sunday_service);
+  RUN_TEST(test_stop_without_timetable_keeps_the_response);
+  RUN_TEST(test_bench_lookup);
+  RUN_TEST(test_table_size);
+  return UNITY_END();
+}
@@ -0,0 +1,130 @@
+/** The connection to the API against the TLS stub: kept alive across the refreshes and the token calls, resumed
+ *  when the server closes it, with the handshakes, the time per request and the heap of TLS reported, and the probe
+ *  of the max fragment length done by the first request only.
+ *    pio test -e native -f test_tls
+ */
+/** Below a TLS record: the server is probed for the max fragment length */
+#define TLS_RX_BUFFER_SIZE 4096
+#include "../../src/STIB_PassingTime.cpp"
+#include <unity.h>
+#include <FirmwareHarness.h>
+
+/** Handshakes of an ESP8266 at 80MHz: full with the RSA/ECDHE computation, resumed with the session cache */
+#define TLS_FULL_HANDSHAKE_MS 1500
+#define TLS_RESUMED_HANDSHAKE_MS 250
+#define TLS_FETCHES 5
+
+struct TlsRun {
+  unsigned long fullHandshakes;
+  unsigned long resumedHandshakes;
+  unsigned long connections;
+  unsigned long averageRequestMs;
+};
+
+/** TLS_FETCHES refreshes, with what they cost */
+static TlsRun measureFetches(){
+  unsigned long full = nativeNetwork.getFullHandshakes();
+  unsigned long resumed = nativeNetwork.getResumedHandshakes();
+  unsigned long connections = apiConnection.getStats().connections;
+  unsigned long totalMs = 0;
+  for(int i = 0; i < TLS_FETCHES; i++){
+    TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+    totalMs += apiConnection.getStats().lastRequestMs;
+  }
+  TlsRun run = {nativeNetwork.getFullHandshakes() - full, nativeNetwork.getResumedHandshakes() - resumed,
+    apiConnection.getStats().connections - connections, totalMs / TLS_FETCHES};
+  return run;
+}
+
+static void printRun(const char* name, const TlsRun& run){
+  printf("[tls] %-24s %d requests: %lu connections, %lu full handshakes, %lu resumed, %lu ms/request\n",
+    name, TLS_FETCHES, run.connections, run.fullHandshakes, run.resumedHandshakes, run.averageRequestMs);
+}
+
+void setUp(){
+  nativeNetwork.setHandshakeMs(TLS_FULL_HANDSHAKE_MS, TLS_RESUMED_HANDSHAKE_MS);
+  TEST_ASSERT_TRUE(bootFirmware());
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+}
+
+void tearDown(){
+  api.keepAlive = true;
+  nativeNetwork.setSessionResumption(true);
+}
+
+void test_kept_alive_connection_has_no_handshake(){
+  TlsRun run = measureFetches();
+  printRun("kept alive", run);
+  TEST_ASSERT_EQUAL(0, run.connections);
+  TEST_ASSERT_EQUAL(0, run.fullHandshakes + run.resumedHandshakes);
+}
+
+void test_token_call_uses_the_same_connection(){
+  unsigned long connections = apiConnection.getStats().connections;
+  unsigned long tokenRequests = api.tokenRequests;
+  api.revokeToken();
+  // Rejected, the token is renewed then the request is sent again
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  TEST_ASSERT_EQUAL(1, api.tokenRequests - tokenRequests);
+  TEST_ASSERT_EQUAL(0, apiConnection.getStats().connections - connections);
+}
+
+void test_closed_connection_resumes_the_session(){
+  api.keepAlive = false;
+  TlsRun resumed = measureFetches();
+  printRun("closed, resumed", resumed);
+  TEST_ASSERT_EQUAL(0, resumed.fullHandshakes);
+  TEST_ASSERT_TRUE(resumed.resumedHandshakes >= TLS_FETCHES - 1);
+
+  nativeNetwork.setSessionResumption(false);
+  TlsRun full = measureFetches();
+  printRun("closed, not resumed", full);
+  TEST_ASSERT_TRUE(full.fullHandshakes >= TLS_FETCHES - 1);
+  TEST_ASSERT_TRUE(resumed.averageRequestMs < full.averageRequestMs);
+}
+
+void test_tls_heap(){
+  // A new connection
+  apiConnection.close();
+  size_t liveBefore = nativeHeap().getLiveBytes();
+  TEST_ASSERT_EQUAL(HTTP_CODE_OK, fetchFavourites());
+  long heap = apiConnection.getStats().lastConnectHeapBytes;
+  int rxSize = apiConnection.getRxBufferSize();
+  printf("[tls] RX buffer %d bytes, TX buffer %d bytes: %ld bytes of heap while connected\n", rxSize, TLS_TX_BUFFER_SIZE, heap);
+  long buffers = rxSize + NATIVE_TLS_RX_OVERHEAD + TLS_TX_BUFFER_SIZE + NATIVE_TLS_TX_OVERHEAD + NATIVE_TLS_CONTEXT_SIZE;
+  // Plus the rounding and the headers of the blocks
+  TEST_ASSERT_TRUE(heap >= buffers && heap < buffers + 64);
+  size_t live = nativeHeap().getLiveBytes() - liveBefore;
+  TEST_ASSERT_TRUE(live >= (size_t)buffers && live <= (size_t)heap);
+  // Given back when the connection is closed
+  apiConnection.close();
+  TEST_ASSERT_EQUAL(liveBefore, nativeHeap().getLiveBytes());
+}
+
+/** The probe is done by the first request, not when WiFi connects, and not again after a reset */
+void test_max_fragment_length_probed_once(){
+  TEST_ASSERT_EQUAL(1, nativeNetwork.getProbes());
+  TEST_ASSERT_EQUAL(TLS_RX_BUFFER_SIZE, apiConnection.getRxBufferSize());
+  TEST_ASSERT_EQUAL(TLS_RX_BUFFER_SIZE, bootCache.getTlsRxBufferSize());
+  ApiConnection connection;
+  connection.begin();
+  TEST_ASSERT_EQUAL(0, connection.getRxBufferSize());
+  TEST_ASSERT_EQUAL(1, nativeNetwork.getProbes());
+  // After a reset, from the RTC memory
+  BootCache restarted;
+  restarted.begin();
+  ApiConnection reset;
+  reset.begin(restarted.getTlsRxBufferSize());
+  TEST_ASSERT_EQUAL(TLS_RX_BUFFER_SIZE, reset.getRxBufferSize());
+  TEST_ASSERT_EQUAL(1, nativeNetwork.getProbes());
+}
+
+int main(){
+  UNITY_BEGIN();
+  RUN_TEST(test_kept_alive_connection_has_no_handshake);
+  RUN_TEST(test_token_call_uses_the_same_connection);
+  RUN_TEST(test_closed_connection_resumes_the_session);
+  RUN_TEST(test_tls_heap);
+  RUN_TEST(test_max_fragment_length_probed_once);
+  return UNITY_END();
+}
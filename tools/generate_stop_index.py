@@ -0,0 +1,87 @@
+"""
+Compile the GTFS stops.txt into include/StopIndex.h, a compact PROGMEM table:
+- STOP_NAMES: unique stop names, sorted, '\0' separated and addressed by STOP_NAME_OFFSETS
+- STOP_ENTRIES: stops sorted by stop_id for binary search, each one pointing to its interned name
+- STOPS_BY_NAME: stop indexes sorted by name for the prefix search
+
+Run by PlatformIO before each build (extra_scripts), or manually: python tools/generate_stop_index.py
+Only the stops (location_type 0) are kept, accents are removed as the LCD can't display them.
+"""
+import csv
+import os
+import unicodedata
+
+STOP_ID_LENGTH = 8
+
+
+def to_lcd_text(text):
+    text = unicodedata.normalize("NFKD", text).encode("ascii", "ignore").decode("ascii")
+    return text.upper().strip()
+
+
+def c_string(text):
+    return '"' + text.replace("\\", "\\\\").replace('"', '\\"') + '\\0"'
+
+
+def generate(project_dir):
+    source = os.path.join(project_dir, "stops.txt")
+    target = os.path.join(project_dir, "include", "StopIndex.h")
+    if os.path.exists(target) and os.path.getmtime(target) >= max(os.path.getmtime(source), os.path.getmtime(__file__)):
+        return
+
+    stops = {}
+    with open(source, encoding="utf-8-sig", newline="") as file:
+        for row in csv.DictReader(file):
+            if row["location_type"].strip() not in ("", "0"):
+                continue
+            stop_id = row["stop_id"].strip()
+            if len(stop_id) >= STOP_ID_LENGTH:
+                raise ValueError("stop_id too long: " + stop_id)
+            stops[stop_id] = to_lcd_text(row["stop_name"])
+
+    names = sorted(set(stops.values()))
+    name_index = {name: i for i, name in enumerate(names)}
+    offsets = []
+    offset = 0
+    for name in names:
+        offsets.append(offset)
+        offset += len(name) + 1
+    if offset > 0xFFFF:
+        raise ValueError("STOP_NAMES doesn't fit 16 bits offsets")
+
+    ids = sorted(stops)
+    by_name = sorted(range(len(ids)), key=lambda i: (stops[ids[i]], ids[i]))
+
+    with open(target, "w", newline="\n") as out:
+        out.write("#pragma once\n")
+        out.write("// Generated from stops.txt by tools/generate_stop_index.py, do not edit\n")
+        out.write("#include \"Pgmspace.h\"\n\n")
+        out.write("#define STOP_ID_LENGTH %d\n" % STOP_ID_LENGTH)
+        out.write("#define STOP_COUNT %d\n" % len(ids))
+        out.write("#define STOP_NAME_COUNT %d\n\n" % len(names))
+        out.write("struct StopEntry {\n  char id[STOP_ID_LENGTH];\n  uint16_t nameIndex;\n};\n\n")
+        out.write("const char STOP_NAMES[] PROGMEM =\n")
+        for name in names:
+            out.write("  %s\n" % c_string(name))
+        out.write("  ;\n\n")
+        out.write("const uint16_t STOP_NAME_OFFSETS[STOP_NAME_COUNT] PROGMEM = {\n")
+        for i in range(0, len(offsets), 16):
+            out.write("  " + ", ".join(str(o) for o in offsets[i:i + 16]) + ",\n")
+        out.write("};\n\n")
+        out.write("const StopEntry STOP_ENTRIES[STOP_COUNT] PROGMEM = {\n")
+        for stop_id in ids:
+            out.write('  {"%s", %d},\n' % (stop_id, name_index[stops[stop_id]]))
+        out.write("};\n\n")
+        out.write("const uint16_t STOPS_BY_NAME[STOP_COUNT] PROGMEM = {\n")
+        for i in range(0, len(by_name), 16):
+            out.write("  " + ", ".join(str(s) for s in by_name[i:i + 16]) + ",\n")
+        out.write("};\n")
+    print("Stop index: %d stops, %d names, %d bytes in flash" % (
+        len(ids), len(names), offset + 2 * len(names) + (STOP_ID_LENGTH + 2) * len(ids) + 2 * len(ids)))
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    generate(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    generate(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
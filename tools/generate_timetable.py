@@ -0,0 +1,184 @@
+"""
+Compile the timetable of the favourite stops from a GTFS feed into include/TimetableData.h, a compact PROGMEM table
+used when the API can't be reached (see include/Timetable.h):
+- TIMETABLE_SERVICES: days of the week and date range of each service_id (calendar.txt)
+- TIMETABLE_EXCEPTIONS: services added or removed on a date (calendar_dates.txt), sorted by date
+- TIMETABLE_PATTERNS: line and destination of the trips, the destinations are interned in TIMETABLE_DESTINATIONS
+- TIMETABLE_STOPS: the favourites found in the feed, each one pointing to its slice of TIMETABLE_DEPARTURES
+- TIMETABLE_DEPARTURES: 4 bytes per departure (minute of the service day, pattern, service), sorted by minute
+  in each slice for the binary search. Minutes go beyond 1440 for the trips after midnight.
+
+The feed (routes.txt, trips.txt, stop_times.txt, calendar.txt, calendar_dates.txt) is read from the gtfs directory
+of the project, or from the directory given as argument. Without feed an empty timetable is generated.
+The favourites are read from include/config.h.
+
+Run by PlatformIO before each build (extra_scripts), or manually: python tools/generate_timetable.py [gtfs directory] [header]
+The fixture of the tests is generated from the feed of test/support/gtfs:
+    python tools/generate_timetable.py test/support/gtfs test/support/TimetableFixture.h
+"""
+import csv
+import datetime
+import os
+import re
+import sys
+import unicodedata
+
+STOP_ID_LENGTH = 8
+LINE_ID_LENGTH = 4
+FEED_FILES = ("routes.txt", "trips.txt", "stop_times.txt", "calendar.txt")
+EPOCH = datetime.date(1970, 1, 1)
+
+
+def to_lcd_text(text):
+    text = unicodedata.normalize("NFKD", text).encode("ascii", "ignore").decode("ascii")
+    return text.upper().strip()
+
+
+def c_string(text):
+    return '"' + text.replace("\\", "\\\\").replace('"', '\\"') + '\\0"'
+
+
+def read_csv(feed_dir, name):
+    path = os.path.join(feed_dir, name)
+    if not os.path.exists(path):
+        return
+    with open(path, encoding="utf-8-sig", newline="") as file:
+        for row in csv.DictReader(file):
+            yield {key.strip(): value.strip() for key, value in row.items() if key is not None}
+
+
+def day_number(gtfs_date):
+    """20190303 -> days since 1970-01-01"""
+    date = datetime.date(int(gtfs_date[0:4]), int(gtfs_date[4:6]), int(gtfs_date[6:8]))
+    return (date - EPOCH).days
+
+
+def minute_of_service_day(gtfs_time):
+    """25:10:00 -> 1510, the times of a service day go beyond 24:00"""
+    hours, minutes, _ = gtfs_time.split(":")
+    return int(hours) * 60 + int(minutes)
+
+
+def read_favourites(project_dir):
+    with open(os.path.join(project_dir, "include", "config.h"), encoding="utf-8") as file:
+        return re.findall(r'Favourite\("([^"]+)"', file.read())
+
+
+def read_timetable(feed_dir, favourites):
+    lines = {row["route_id"]: row.get("route_short_name") or row["route_id"] for row in read_csv(feed_dir, "routes.txt")}
+    trips = {row["trip_id"]: (row["service_id"], lines.get(row["route_id"], row["route_id"]), to_lcd_text(row.get("trip_headsign", "")))
+             for row in read_csv(feed_dir, "trips.txt")}
+    departures = {stop_id: [] for stop_id in favourites}
+    for row in read_csv(feed_dir, "stop_times.txt"):
+        stop_id = row["stop_id"]
+        if stop_id in departures and row["trip_id"] in trips:
+            departures[stop_id].append((minute_of_service_day(row["departure_time"] or row["arrival_time"]), trips[row["trip_id"]]))
+    services = {}
+    for row in read_csv(feed_dir, "calendar.txt"):
+        weekdays = 0
+        for bit, day in enumerate(("monday", "tuesday", "wednesday", "thursday", "friday", "saturday", "sunday")):
+            if row[day] == "1":
+                weekdays |= 1 << bit
+        services[row["service_id"]] = (day_number(row["start_date"]), day_number(row["end_date"]), weekdays)
+    exceptions = [(day_number(row["date"]), row["service_id"], row["exception_type"] == "1") for row in read_csv(feed_dir, "calendar_dates.txt")]
+    return departures, services, exceptions
+
+
+def generate(project_dir, feed_dir=None, target=None):
+    feed_dir = feed_dir or os.path.join(project_dir, "gtfs")
+    target = target or os.path.join(project_dir, "include", "TimetableData.h")
+    config = os.path.join(project_dir, "include", "config.h")
+    has_feed = all(os.path.exists(os.path.join(feed_dir, name)) for name in FEED_FILES)
+    sources = [config, __file__] + ([os.path.join(feed_dir, name) for name in FEED_FILES] if has_feed else [])
+    if os.path.exists(target) and os.path.getmtime(target) >= max(os.path.getmtime(source) for source in sources):
+        return
+
+    favourites = read_favourites(project_dir)
+    departures, services, exceptions = ({}, {}, []) if not has_feed else read_timetable(feed_dir, favourites)
+
+    # Only the services and patterns used by the favourites are kept
+    used_services = sorted({trip[0] for stop in departures.values() for _, trip in stop})
+    used_patterns = sorted({(trip[1], trip[2]) for stop in departures.values() for _, trip in stop})
+    service_index = {service_id: i for i, service_id in enumerate(used_services)}
+    pattern_index = {pattern: i for i, pattern in enumerate(used_patterns)}
+    if len(used_services) > 0xFF or len(used_patterns) > 0xFF:
+        raise ValueError("More than 255 services or patterns, they don't fit the 8 bits indexes")
+    for line, _ in used_patterns:
+        if len(line) >= LINE_ID_LENGTH:
+            raise ValueError("line too long: " + line)
+
+    destinations = sorted({destination for _, destination in used_patterns})
+    destination_offsets = {}
+    offset = 0
+    for destination in destinations:
+        destination_offsets[destination] = offset
+        offset += len(destination) + 1
+
+    stops = []
+    all_departures = []
+    for stop_id in favourites:
+        stop_departures = sorted((minute, pattern_index[(trip[1], trip[2])], service_index[trip[0]]) for minute, trip in departures.get(stop_id, []))
+        if not stop_departures:
+            continue
+        if len(stop_id) >= STOP_ID_LENGTH:
+            raise ValueError("stop_id too long: " + stop_id)
+        stops.append((stop_id, len(all_departures), len(stop_departures)))
+        all_departures.extend(stop_departures)
+    if len(all_departures) > 0xFFFF:
+        raise ValueError("More than 65535 departures, they don't fit the 16 bits indexes")
+    used_exceptions = sorted((day, service_index[service_id], added) for day, service_id, added in exceptions if service_id in service_index)
+
+    with open(target, "w", newline="\n") as out:
+        out.write("#pragma once\n")
+        out.write("// Generated from the GTFS feed by tools/generate_timetable.py, do not edit\n")
+        out.write("#include \"Pgmspace.h\"\n\n")
+        out.write("#define TIMETABLE_STOP_ID_LENGTH %d\n" % STOP_ID_LENGTH)
+        out.write("#define TIMETABLE_STOP_COUNT %d\n" % len(stops))
+        out.write("#define TIMETABLE_SERVICE_COUNT %d\n" % len(used_services))
+        out.write("#define TIMETABLE_EXCEPTION_COUNT %d\n" % len(used_exceptions))
+        out.write("#define TIMETABLE_PATTERN_COUNT %d\n" % len(used_patterns))
+        out.write("#define TIMETABLE_DEPARTURE_COUNT %d\n\n" % len(all_departures))
+        out.write("struct TimetableStop {\n  char id[TIMETABLE_STOP_ID_LENGTH];\n  uint16_t firstDeparture;\n  uint16_t numberOfDepartures;\n};\n\n")
+        out.write("/** Days since 1970-01-01, weekdays from bit 0 (monday) to bit 6 (sunday) */\n")
+        out.write("struct TimetableService {\n  uint16_t startDay;\n  uint16_t endDay;\n  uint8_t weekdays;\n};\n\n")
+        out.write("struct TimetableException {\n  uint16_t day;\n  uint8_t service;\n  uint8_t added;\n};\n\n")
+        out.write("struct TimetablePattern {\n  char line[%d];\n  uint16_t destinationOffset;\n};\n\n" % LINE_ID_LENGTH)
+        out.write("struct TimetableDeparture {\n  uint16_t minute;\n  uint8_t pattern;\n  uint8_t service;\n};\n\n")
+        # Arrays get a terminator so that they are never empty
+        out.write("const char TIMETABLE_DESTINATIONS[] PROGMEM =\n")
+        for destination in destinations:
+            out.write("  %s\n" % c_string(destination))
+        out.write("  \"\";\n\n")
+        out.write("const TimetableService TIMETABLE_SERVICES[TIMETABLE_SERVICE_COUNT + 1] PROGMEM = {\n")
+        for service_id in used_services:
+            start, end, weekdays = services.get(service_id, (0, 0, 0))
+            out.write("  {%d, %d, 0x%02x}, // %s\n" % (start, end, weekdays, service_id))
+        out.write("  {0, 0, 0}\n};\n\n")
+        out.write("const TimetableException TIMETABLE_EXCEPTIONS[TIMETABLE_EXCEPTION_COUNT + 1] PROGMEM = {\n")
+        for day, service, added in used_exceptions:
+            out.write("  {%d, %d, %d},\n" % (day, service, 1 if added else 0))
+        out.write("  {0, 0, 0}\n};\n\n")
+        out.write("const TimetablePattern TIMETABLE_PATTERNS[TIMETABLE_PATTERN_COUNT + 1] PROGMEM = {\n")
+        for line, destination in used_patterns:
+            out.write('  {"%s", %d},\n' % (line, destination_offsets[destination]))
+        out.write('  {"", 0}\n};\n\n')
+        out.write("const TimetableStop TIMETABLE_STOPS[TIMETABLE_STOP_COUNT + 1] PROGMEM = {\n")
+        for stop_id, first, count in stops:
+            out.write('  {"%s", %d, %d},\n' % (stop_id, first, count))
+        out.write('  {"", 0, 0}\n};\n\n')
+        out.write("const TimetableDeparture TIMETABLE_DEPARTURES[TIMETABLE_DEPARTURE_COUNT + 1] PROGMEM = {\n")
+        for i in range(0, len(all_departures), 8):
+            out.write("  " + " ".join("{%d, %d, %d}," % departure for departure in all_departures[i:i + 8]) + "\n")
+        out.write("  {0, 0, 0}\n};\n")
+    flash = offset + 6 * len(used_services) + 4 * len(used_exceptions) + (LINE_ID_LENGTH + 2) * len(used_patterns) \
+        + (STOP_ID_LENGTH + 4) * len(stops) + 4 * len(all_departures)
+    print("Timetable: %d of %d favourites, %d departures, %d services, %d patterns, %d bytes in flash" % (
+        len(stops), len(favourites), len(all_departures), len(used_services), len(used_patterns), flash))
+
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    generate(env["PROJECT_DIR"])  # noqa: F821
+except NameError:
+    generate(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."), sys.argv[1] if len(sys.argv) > 1 else None,
+             sys.argv[2] if len(sys.argv) > 2 else None)
@@ -0,0 +1,219 @@
+"""
+Local stand-in for the STIB-MIVB API, serving back HTTP exchanges recorded by the device.
+
+Record: build with -D RECORD_HTTP=1 and save the serial monitor output, e.g.
+    pio device monitor | tee capture.log
+Every response is written there between "@rec begin" and "@rec end" lines (see include/HttpFetch.h).
+
+Replay: python tools/replay_server.py capture.log --port 8080 [--tls --cert cert.pem --key key.pem]
+and point the device at it with the build flags documented in include/config.h:
+    -D ENV_API_SCHEME="\"http\"" -D ENV_API_HOST_NAME="\"192.168.1.10\"" -D ENV_API_PORT=8080
+
+Responses are served in the recorded order for each request path, looping at the end. A path which
+wasn't recorded gets the recorded responses of the same endpoint. POST /token answers a fresh token
+when no token exchange was recorded.
+Latency, chunking, 401, 5xx and truncated bodies can be injected to test the client and for soak runs.
+"""
+import argparse
+import itertools
+import json
+import random
+import ssl
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+RECORD_PREFIX = "@rec "
+
+
+class Exchange:
+    def __init__(self, method, path, raw):
+        self.method = method
+        self.path = path
+        self.status, self.headers, self.body = parse_response(raw)
+
+
+def parse_response(raw):
+    """Split a raw HTTP response into status, headers (without framing) and the decoded body"""
+    head, _, body = raw.partition(b"\r\n\r\n")
+    lines = head.decode("latin-1").split("\r\n")
+    status = int(lines[0].split(" ")[1])
+    headers = []
+    chunked = False
+    for line in lines[1:]:
+        name, _, value = line.partition(":")
+        name = name.strip().lower()
+        if name == "transfer-encoding" and "chunked" in value:
+            chunked = True
+        elif name not in ("content-length", "connection", "keep-alive"):
+            headers.append((line.partition(":")[0].strip(), value.strip()))
+    if chunked:
+        body = dechunk(body)
+    return status, headers, body
+
+
+def dechunk(data):
+    body = b""
+    while data:
+        size_line, _, data = data.partition(b"\r\n")
+        size = int(size_line.split(b";")[0], 16)
+        if size == 0:
+            break
+        body += data[:size]
+        data = data[size + 2:]
+    return body
+
+
+def read_recording(path):
+    exchanges = []
+    current = None
+    with open(path, encoding="utf-8", errors="replace") as file:
+        for line in file:
+            index = line.find(RECORD_PREFIX)
+            if index < 0:
+                continue
+            kind, _, value = line[index + len(RECORD_PREFIX):].strip().partition(" ")
+            if kind == "begin":
+                method, _, request_path = value.partition(" ")
+                current = [method, request_path, b""]
+            elif kind == "data" and current is not None:
+                current[2] += bytes.fromhex(value)
+            elif kind == "end" and current is not None:
+                if value.strip() != "0" and current[2]:
+                    exchanges.append(Exchange(*current))
+                current = None
+    return exchanges
+
+
+def endpoint(path):
+    """/OperationMonitoring/3.0/PassingTimeByPoint/5311%2C1715 -> /OperationMonitoring/3.0/PassingTimeByPoint"""
+    path = path.split("?")[0]
+    return path.rsplit("/", 1)[0] or path
+
+
+class Replay:
+    def __init__(self, exchanges, options):
+        self.options = options
+        self.random = random.Random(options.seed)
+        self.lock = threading.Lock()
+        self.by_path = {}
+        self.by_endpoint = {}
+        for exchange in exchanges:
+            self.by_path.setdefault((exchange.method, exchange.path), []).append(exchange)
+            self.by_endpoint.setdefault((exchange.method, endpoint(exchange.path)), []).append(exchange)
+        self.cycles = {key: itertools.cycle(value) for key, value in itertools.chain(self.by_path.items(), self.by_endpoint.items())}
+        self.tokens = itertools.count(1)
+
+    def next_exchange(self, method, path):
+        with self.lock:
+            for key in ((method, path), (method, endpoint(path))):
+                if key in self.cycles:
+                    return next(self.cycles[key])
+        return None
+
+    def chance(self, rate):
+        with self.lock:
+            return self.random.random() < rate
+
+    def latency(self):
+        with self.lock:
+            return (self.options.latency_ms + self.random.uniform(0, self.options.jitter_ms)) / 1000.0
+
+    def fresh_token(self):
+        body = json.dumps({"access_token": "replay%026d" % next(self.tokens), "token_type": "Bearer", "expires_in": self.options.token_lifetime})
+        return 200, [("Content-Type", "application/json")], body.encode()
+
+
+def make_handler(replay):
+    options = replay.options
+
+    class Handler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"
+
+        def do_GET(self):
+            self.answer()
+
+        def do_POST(self):
+            length = int(self.headers.get("Content-Length", 0))
+            self.rfile.read(length)
+            self.answer()
+
+        def answer(self):
+            time.sleep(replay.latency())
+            is_token = self.path.split("?")[0].endswith("/token")
+            exchange = replay.next_exchange(self.command, self.path)
+            if exchange is not None:
+                status, headers, body = exchange.status, exchange.headers, exchange.body
+            elif is_token:
+                status, headers, body = replay.fresh_token()
+            else:
+                status, headers, body = 404, [], b"not recorded"
+            if not is_token and replay.chance(options.unauthorized_rate):
+                status, headers, body = 401, [("Content-Type", "application/json")], b'{"fault":"invalid token"}'
+            elif replay.chance(options.error_rate):
+                status, headers, body = 503, [], b"service unavailable"
+            truncate = replay.chance(options.truncate_rate)
+            self.send(status, headers, body, truncate)
+
+        def send(self, status, headers, body, truncate):
+            self.send_response(status)
+            for name, value in headers:
+                self.send_header(name, value)
+            if options.close:
+                self.send_header("Connection", "close")
+                self.close_connection = True
+            if options.chunk_size > 0:
+                self.send_header("Transfer-Encoding", "chunked")
+            else:
+                self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            sent = body[:len(body) // 2] if truncate else body
+            if options.chunk_size > 0:
+                for start in range(0, len(sent), options.chunk_size):
+                    chunk = sent[start:start + options.chunk_size]
+                    self.wfile.write(b"%x\r\n%s\r\n" % (len(chunk), chunk))
+                    self.wfile.flush()
+                    time.sleep(options.chunk_delay_ms / 1000.0)
+                if not truncate:
+                    self.wfile.write(b"0\r\n\r\n")
+            else:
+                self.wfile.write(sent)
+            self.wfile.flush()
+            if truncate:
+                self.close_connection = True
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Serve recorded STIB-MIVB API exchanges")
+    parser.add_argument("recording", help="serial log captured with RECORD_HTTP=1")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--tls", action="store_true", help="serve HTTPS with --cert and --key")
+    parser.add_argument("--cert")
+    parser.add_argument("--key")
+    parser.add_argument("--latency-ms", type=float, default=0, help="delay before each response")
+    parser.add_argument("--jitter-ms", type=float, default=0, help="random extra delay")
+    parser.add_argument("--chunk-size", type=int, default=0, help="send chunked bodies of this size, 0 for Content-Length")
+    parser.add_argument("--chunk-delay-ms", type=float, default=0, help="delay between chunks")
+    parser.add_argument("--unauthorized-rate", type=float, default=0, help="ratio of passing time requests answered 401")
+    parser.add_argument("--error-rate", type=float, default=0, help="ratio of requests answered 503")
+    parser.add_argument("--truncate-rate", type=float, default=0, help="ratio of bodies cut in the middle")
+    parser.add_argument("--close", action="store_true", help="close the connection after each response")
+    parser.add_argument("--token-lifetime", type=int, default=3600, help="expires_in of the generated tokens")
+    parser.add_argument("--seed", type=int, default=None)
+    options = parser.parse_args()
+
+    exchanges = read_recording(options.recording)
+    print("%d recorded exchanges" % len(exchanges))
+    server = ThreadingHTTPServer(("", options.port), make_handler(Replay(exchanges, options)))
+    if options.tls:
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        context.load_cert_chain(options.cert, options.key)
+        server.socket = context.wrap_socket(server.socket, server_side=True)
+    print("Serving on port %d (%s)" % (options.port, "https" if options.tls else "http"))
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()